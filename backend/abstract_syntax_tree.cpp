@@ -1,29 +1,265 @@
 #include "abstract_syntax_tree.h"
 #include <iostream>
+#include <array>
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace
+{
+    using statement_entry = std::pair<std::string_view, AbstractSyntaxTree::statement_kind>;
+    /**
+     * Statement node names and their kinds, sorted by name so a lookup is a binary search.
+     */
+    constexpr std::array<statement_entry, 124> statement_table = {{
+        {"AlterCollationStmt", AbstractSyntaxTree::statement_kind::ALTER_COLLATION_STMT},
+        {"AlterCompositeTypeStmt", AbstractSyntaxTree::statement_kind::ALTER_COMPOSITE_TYPE_STMT},
+        {"AlterDatabaseSetStmt", AbstractSyntaxTree::statement_kind::ALTER_DATABASE_SET_STMT},
+        {"AlterDatabaseStmt", AbstractSyntaxTree::statement_kind::ALTER_DATABASE_STMT},
+        {"AlterDefaultPrivilegesStmt", AbstractSyntaxTree::statement_kind::ALTER_DEFAULT_PRIVILEGES_STMT},
+        {"AlterDomainStmt", AbstractSyntaxTree::statement_kind::ALTER_DOMAIN_STMT},
+        {"AlterEnumStmt", AbstractSyntaxTree::statement_kind::ALTER_ENUM_STMT},
+        {"AlterEventTrigStmt", AbstractSyntaxTree::statement_kind::ALTER_EVENT_TRIG_STMT},
+        {"AlterExtensionContentsStmt", AbstractSyntaxTree::statement_kind::ALTER_EXTENSION_CONTENTS_STMT},
+        {"AlterExtensionStmt", AbstractSyntaxTree::statement_kind::ALTER_EXTENSION_STMT},
+        {"AlterFdwStmt", AbstractSyntaxTree::statement_kind::ALTER_FDW_STMT},
+        {"AlterForeignServerStmt", AbstractSyntaxTree::statement_kind::ALTER_FOREIGN_SERVER_STMT},
+        {"AlterFunctionStmt", AbstractSyntaxTree::statement_kind::ALTER_FUNCTION_STMT},
+        {"AlterGroupStmt", AbstractSyntaxTree::statement_kind::ALTER_GROUP_STMT},
+        {"AlterObjectDependsStmt", AbstractSyntaxTree::statement_kind::ALTER_OBJECT_DEPENDS_STMT},
+        {"AlterObjectSchemaStmt", AbstractSyntaxTree::statement_kind::ALTER_OBJECT_SCHEMA_STMT},
+        {"AlterOpFamilyStmt", AbstractSyntaxTree::statement_kind::ALTER_OP_FAMILY_STMT},
+        {"AlterOperatorStmt", AbstractSyntaxTree::statement_kind::ALTER_OPERATOR_STMT},
+        {"AlterOwnerStmt", AbstractSyntaxTree::statement_kind::ALTER_OWNER_STMT},
+        {"AlterPolicyStmt", AbstractSyntaxTree::statement_kind::ALTER_POLICY_STMT},
+        {"AlterPublicationStmt", AbstractSyntaxTree::statement_kind::ALTER_PUBLICATION_STMT},
+        {"AlterRoleSetStmt", AbstractSyntaxTree::statement_kind::ALTER_ROLE_SET_STMT},
+        {"AlterRoleStmt", AbstractSyntaxTree::statement_kind::ALTER_ROLE_STMT},
+        {"AlterSeqStmt", AbstractSyntaxTree::statement_kind::ALTER_SEQ_STMT},
+        {"AlterStatsStmt", AbstractSyntaxTree::statement_kind::ALTER_STATS_STMT},
+        {"AlterSubscriptionStmt", AbstractSyntaxTree::statement_kind::ALTER_SUBSCRIPTION_STMT},
+        {"AlterSystemStmt", AbstractSyntaxTree::statement_kind::ALTER_SYSTEM_STMT},
+        {"AlterTSConfigurationStmt", AbstractSyntaxTree::statement_kind::ALTER_TS_CONFIGURATION_STMT},
+        {"AlterTSDictionaryStmt", AbstractSyntaxTree::statement_kind::ALTER_TS_DICTIONARY_STMT},
+        {"AlterTableStmt", AbstractSyntaxTree::statement_kind::ALTER_TABLE_STMT},
+        {"AlterTblSpcStmt", AbstractSyntaxTree::statement_kind::ALTER_TBL_SPC_STMT},
+        {"AlterTypeStmt", AbstractSyntaxTree::statement_kind::ALTER_TYPE_STMT},
+        {"AlterUserMappingStmt", AbstractSyntaxTree::statement_kind::ALTER_USER_MAPPING_STMT},
+        {"AnalyzeStmt", AbstractSyntaxTree::statement_kind::ANALYZE_STMT},
+        {"CallStmt", AbstractSyntaxTree::statement_kind::CALL_STMT},
+        {"CheckPointStmt", AbstractSyntaxTree::statement_kind::CHECK_POINT_STMT},
+        {"ClosePortalStmt", AbstractSyntaxTree::statement_kind::CLOSE_PORTAL_STMT},
+        {"ClusterStmt", AbstractSyntaxTree::statement_kind::CLUSTER_STMT},
+        {"CommentStmt", AbstractSyntaxTree::statement_kind::COMMENT_STMT},
+        {"ConstraintsSetStmt", AbstractSyntaxTree::statement_kind::CONSTRAINTS_SET_STMT},
+        {"CopyStmt", AbstractSyntaxTree::statement_kind::COPY_STMT},
+        {"CreateAmStmt", AbstractSyntaxTree::statement_kind::CREATE_AM_STMT},
+        {"CreateAsStmt", AbstractSyntaxTree::statement_kind::CREATE_AS_STMT},
+        {"CreateAssertionStmt", AbstractSyntaxTree::statement_kind::CREATE_ASSERTION_STMT},
+        {"CreateCastStmt", AbstractSyntaxTree::statement_kind::CREATE_CAST_STMT},
+        {"CreateConversionStmt", AbstractSyntaxTree::statement_kind::CREATE_CONVERSION_STMT},
+        {"CreateDomainStmt", AbstractSyntaxTree::statement_kind::CREATE_DOMAIN_STMT},
+        {"CreateEventTrigStmt", AbstractSyntaxTree::statement_kind::CREATE_EVENT_TRIG_STMT},
+        {"CreateExtensionStmt", AbstractSyntaxTree::statement_kind::CREATE_EXTENSION_STMT},
+        {"CreateFdwStmt", AbstractSyntaxTree::statement_kind::CREATE_FDW_STMT},
+        {"CreateForeignServerStmt", AbstractSyntaxTree::statement_kind::CREATE_FOREIGN_SERVER_STMT},
+        {"CreateForeignTableStmt", AbstractSyntaxTree::statement_kind::CREATE_FOREIGN_TABLE_STMT},
+        {"CreateFunctionStmt", AbstractSyntaxTree::statement_kind::CREATE_FUNCTION_STMT},
+        {"CreateGroupStmt", AbstractSyntaxTree::statement_kind::CREATE_GROUP_STMT},
+        {"CreateMatViewStmt", AbstractSyntaxTree::statement_kind::CREATE_MAT_VIEW_STMT},
+        {"CreateOpClassStmt", AbstractSyntaxTree::statement_kind::CREATE_OP_CLASS_STMT},
+        {"CreateOpFamilyStmt", AbstractSyntaxTree::statement_kind::CREATE_OP_FAMILY_STMT},
+        {"CreatePLangStmt", AbstractSyntaxTree::statement_kind::CREATE_PLANG_STMT},
+        {"CreatePolicyStmt", AbstractSyntaxTree::statement_kind::CREATE_POLICY_STMT},
+        {"CreatePublicationStmt", AbstractSyntaxTree::statement_kind::CREATE_PUBLICATION_STMT},
+        {"CreateRoleStmt", AbstractSyntaxTree::statement_kind::CREATE_ROLE_STMT},
+        {"CreateSchemaStmt", AbstractSyntaxTree::statement_kind::CREATE_SCHEMA_STMT},
+        {"CreateSeqStmt", AbstractSyntaxTree::statement_kind::CREATE_SEQ_STMT},
+        {"CreateStatsStmt", AbstractSyntaxTree::statement_kind::CREATE_STATS_STMT},
+        {"CreateStmt", AbstractSyntaxTree::statement_kind::CREATE_STMT},
+        {"CreateSubscriptionStmt", AbstractSyntaxTree::statement_kind::CREATE_SUBSCRIPTION_STMT},
+        {"CreateTableSpaceStmt", AbstractSyntaxTree::statement_kind::CREATE_TABLE_SPACE_STMT},
+        {"CreateTransformStmt", AbstractSyntaxTree::statement_kind::CREATE_TRANSFORM_STMT},
+        {"CreateTrigStmt", AbstractSyntaxTree::statement_kind::CREATE_TRIG_STMT},
+        {"CreateUserMappingStmt", AbstractSyntaxTree::statement_kind::CREATE_USER_MAPPING_STMT},
+        {"CreateUserStmt", AbstractSyntaxTree::statement_kind::CREATE_USER_STMT},
+        {"CreatedbStmt", AbstractSyntaxTree::statement_kind::CREATEDB_STMT},
+        {"DeallocateStmt", AbstractSyntaxTree::statement_kind::DEALLOCATE_STMT},
+        {"DeclareCursorStmt", AbstractSyntaxTree::statement_kind::DECLARE_CURSOR_STMT},
+        {"DefineStmt", AbstractSyntaxTree::statement_kind::DEFINE_STMT},
+        {"DeleteStmt", AbstractSyntaxTree::statement_kind::DELETE_STMT},
+        {"DiscardStmt", AbstractSyntaxTree::statement_kind::DISCARD_STMT},
+        {"DoStmt", AbstractSyntaxTree::statement_kind::DO_STMT},
+        {"DropCastStmt", AbstractSyntaxTree::statement_kind::DROP_CAST_STMT},
+        {"DropOpClassStmt", AbstractSyntaxTree::statement_kind::DROP_OP_CLASS_STMT},
+        {"DropOpFamilyStmt", AbstractSyntaxTree::statement_kind::DROP_OP_FAMILY_STMT},
+        {"DropOwnedStmt", AbstractSyntaxTree::statement_kind::DROP_OWNED_STMT},
+        {"DropRoleStmt", AbstractSyntaxTree::statement_kind::DROP_ROLE_STMT},
+        {"DropStmt", AbstractSyntaxTree::statement_kind::DROP_STMT},
+        {"DropSubscriptionStmt", AbstractSyntaxTree::statement_kind::DROP_SUBSCRIPTION_STMT},
+        {"DropTableSpaceStmt", AbstractSyntaxTree::statement_kind::DROP_TABLE_SPACE_STMT},
+        {"DropTransformStmt", AbstractSyntaxTree::statement_kind::DROP_TRANSFORM_STMT},
+        {"DropUserMappingStmt", AbstractSyntaxTree::statement_kind::DROP_USER_MAPPING_STMT},
+        {"DropdbStmt", AbstractSyntaxTree::statement_kind::DROPDB_STMT},
+        {"ExecuteStmt", AbstractSyntaxTree::statement_kind::EXECUTE_STMT},
+        {"ExplainStmt", AbstractSyntaxTree::statement_kind::EXPLAIN_STMT},
+        {"FetchStmt", AbstractSyntaxTree::statement_kind::FETCH_STMT},
+        {"GrantRoleStmt", AbstractSyntaxTree::statement_kind::GRANT_ROLE_STMT},
+        {"GrantStmt", AbstractSyntaxTree::statement_kind::GRANT_STMT},
+        {"ImportForeignSchemaStmt", AbstractSyntaxTree::statement_kind::IMPORT_FOREIGN_SCHEMA_STMT},
+        {"IndexStmt", AbstractSyntaxTree::statement_kind::INDEX_STMT},
+        {"InsertStmt", AbstractSyntaxTree::statement_kind::INSERT_STMT},
+        {"ListenStmt", AbstractSyntaxTree::statement_kind::LISTEN_STMT},
+        {"LoadStmt", AbstractSyntaxTree::statement_kind::LOAD_STMT},
+        {"LockStmt", AbstractSyntaxTree::statement_kind::LOCK_STMT},
+        {"MergeStmt", AbstractSyntaxTree::statement_kind::MERGE_STMT},
+        {"NotifyStmt", AbstractSyntaxTree::statement_kind::NOTIFY_STMT},
+        {"PrepareStmt", AbstractSyntaxTree::statement_kind::PREPARE_STMT},
+        {"ReassignOwnedStmt", AbstractSyntaxTree::statement_kind::REASSIGN_OWNED_STMT},
+        {"RefreshMatViewStmt", AbstractSyntaxTree::statement_kind::REFRESH_MAT_VIEW_STMT},
+        {"ReindexStmt", AbstractSyntaxTree::statement_kind::REINDEX_STMT},
+        {"RemoveAggrStmt", AbstractSyntaxTree::statement_kind::REMOVE_AGGR_STMT},
+        {"RemoveFuncStmt", AbstractSyntaxTree::statement_kind::REMOVE_FUNC_STMT},
+        {"RemoveOperStmt", AbstractSyntaxTree::statement_kind::REMOVE_OPER_STMT},
+        {"RenameStmt", AbstractSyntaxTree::statement_kind::RENAME_STMT},
+        {"RevokeRoleStmt", AbstractSyntaxTree::statement_kind::REVOKE_ROLE_STMT},
+        {"RevokeStmt", AbstractSyntaxTree::statement_kind::REVOKE_STMT},
+        {"RuleStmt", AbstractSyntaxTree::statement_kind::RULE_STMT},
+        {"SecLabelStmt", AbstractSyntaxTree::statement_kind::SEC_LABEL_STMT},
+        {"SelectStmt", AbstractSyntaxTree::statement_kind::SELECT_STMT},
+        {"TransactionStmt", AbstractSyntaxTree::statement_kind::TRANSACTION_STMT},
+        {"TruncateStmt", AbstractSyntaxTree::statement_kind::TRUNCATE_STMT},
+        {"UnlistenStmt", AbstractSyntaxTree::statement_kind::UNLISTEN_STMT},
+        {"UpdateStmt", AbstractSyntaxTree::statement_kind::UPDATE_STMT},
+        {"VacuumStmt", AbstractSyntaxTree::statement_kind::VACUUM_STMT},
+        {"VariableResetStmt", AbstractSyntaxTree::statement_kind::VARIABLE_RESET_STMT},
+        {"VariableSetStmt", AbstractSyntaxTree::statement_kind::VARIABLE_SET_STMT},
+        {"VariableShowStmt", AbstractSyntaxTree::statement_kind::VARIABLE_SHOW_STMT},
+        {"ViewStmt", AbstractSyntaxTree::statement_kind::VIEW_STMT}
+    }};
+    static_assert(std::is_sorted(statement_table.begin(), statement_table.end(),
+                                 [](const statement_entry &a, const statement_entry &b)
+                                 { return a.first < b.first; }),
+                  "statement_table must be sorted by name");
+
+    /**
+     * Process-wide table of interned node keys. Trees are built concurrently by the grading pool and the
+     * server, so lookups take a shared lock and only a new key takes the exclusive one.
+     */
+    struct key_registry
+    {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string, AbstractSyntaxTree::node_kind> ids;
+    };
+    key_registry &get_key_registry()
+    {
+        static key_registry registry;
+        return registry;
+    }
+}
+
+AbstractSyntaxTree::node_kind AbstractSyntaxTree::intern_key(const std::string &key)
+{
+    auto &registry = get_key_registry();
+    {
+        std::shared_lock lock(registry.mutex);
+        auto it = registry.ids.find(key);
+        if (it != registry.ids.end())
+        {
+            return it->second;
+        }
+    }
+    std::unique_lock lock(registry.mutex);
+    // emplace keeps the existing id if another thread interned the key in between
+    auto it = registry.ids.emplace(key, static_cast<node_kind>(registry.ids.size())).first;
+    return it->second;
+}
+
+bool AbstractSyntaxTree::find_key(const std::string &key, node_kind &kind)
+{
+    auto &registry = get_key_registry();
+    std::shared_lock lock(registry.mutex);
+    auto it = registry.ids.find(key);
+    if (it == registry.ids.end())
+    {
+        return false;
+    }
+    kind = it->second;
+    return true;
+}
 
 AbstractSyntaxTree::Node::Node(const string &key, const string &value, const std::shared_ptr<Node> &parent)
-    : key(key), value(value), parent(parent) {}
+    : key(key), value(value), kind(intern_key(key)), parent(parent) {}
 
 void AbstractSyntaxTree::Node::add_child(std::shared_ptr<Node> child)
 {
     child->parent = shared_from_this();
     children.push_back(child);
+    child_index.clear();
 }
 std::shared_ptr<AbstractSyntaxTree::Node> AbstractSyntaxTree::Node::get_child(const std::string &key) const
 {
+    node_kind child_kind;
+    if (!find_key(key, child_kind))
+    {
+        return nullptr;
+    }
+    return get_child(child_kind);
+}
+std::shared_ptr<AbstractSyntaxTree::Node> AbstractSyntaxTree::Node::get_child(node_kind kind) const
+{
+    if (!child_index.empty())
+    {
+        auto it = std::lower_bound(child_index.begin(), child_index.end(), kind,
+                                   [](const std::pair<node_kind, std::uint32_t> &entry, node_kind value)
+                                   { return entry.first < value; });
+        if (it != child_index.end() && it->first == kind)
+        {
+            return children[it->second];
+        }
+        return nullptr;
+    }
     for (const auto &child : children)
     {
-        if (child->key == key)
+        if (child->kind == kind)
         {
             return child;
         }
     }
     return nullptr;
 }
+void AbstractSyntaxTree::Node::index_children()
+{
+    child_index.clear();
+    if (children.size() < child_index_threshold)
+    {
+        return;
+    }
+    child_index.reserve(children.size());
+    for (std::uint32_t i = 0; i < children.size(); ++i)
+    {
+        child_index.emplace_back(children[i]->kind, i);
+    }
+    // stable so that the first child of a kind stays first, as in the linear scan
+    std::stable_sort(child_index.begin(), child_index.end(),
+                     [](const std::pair<node_kind, std::uint32_t> &a, const std::pair<node_kind, std::uint32_t> &b)
+                     { return a.first < b.first; });
+}
 
 std::string AbstractSyntaxTree::Node::get_value(const std::string &key) const
 {
-    auto child = get_child(key);
+    node_kind child_kind;
+    if (!find_key(key, child_kind))
+    {
+        return "";
+    }
+    return get_value(child_kind);
+}
+
+std::string AbstractSyntaxTree::Node::get_value(node_kind kind) const
+{
+    auto child = get_child(kind);
     if (child)
     {
         std::string value = child->value;
@@ -38,6 +274,22 @@ std::string AbstractSyntaxTree::Node::get_value(const std::string &key) const
 }
 
 void AbstractSyntaxTree::build_tree(const nlohmann::json &input, std::shared_ptr<Node> &parent)
+{
+    add_children(input, parent);
+    // the children of a node are only complete once the whole tree is built, the elements of an array are added one at a time
+    index_tree(parent);
+}
+
+void AbstractSyntaxTree::index_tree(const std::shared_ptr<Node> &node)
+{
+    node->index_children();
+    for (const auto &child : node->children)
+    {
+        index_tree(child);
+    }
+}
+
+void AbstractSyntaxTree::add_children(const nlohmann::json &input, std::shared_ptr<Node> &parent)
 {
     using namespace std;
 
@@ -48,14 +300,14 @@ void AbstractSyntaxTree::build_tree(const nlohmann::json &input, std::shared_ptr
         if (element.value().is_object())
         {
             childNode = make_shared<Node>(element.key(), "");
-            build_tree(element.value(), childNode);
+            add_children(element.value(), childNode);
         }
         else if (element.value().is_array())
         {
             childNode = make_shared<Node>(element.key(), "");
             for (const auto &array_element : element.value())
             {
-                build_tree(array_element, childNode);
+                add_children(array_element, childNode);
             }
         }
         else if (element.value().is_primitive())
@@ -98,6 +350,14 @@ void AbstractSyntaxTree::prune_tree(std::shared_ptr<Node> &root)
         return;
     }
 
+    static const node_kind pruned_location = intern_key("location");
+    static const node_kind pruned_stmt_len = intern_key("stmt_len");
+    static const node_kind pruned_version = intern_key("version");
+    static const node_kind pruned_inh = intern_key("inh");
+    static const node_kind pruned_relpersistence = intern_key("relpersistence");
+    static const node_kind pruned_limit_option = intern_key("limitOption");
+    static const node_kind pruned_op = intern_key("op");
+
     // access the children of the current node
     auto &children = root->children;
     for (auto it = children.begin(); it != children.end();)
@@ -105,11 +365,12 @@ void AbstractSyntaxTree::prune_tree(std::shared_ptr<Node> &root)
         auto &child = *it;
 
         // Check if the child node's key matches any of the keys we want to prune
-        if (child->key == "location" || child->key == "stmt_len" ||
-            child->key == "version" || child->key == "inh" ||
-            child->key == "relpersistence" || child->key == "limitOption" ||
-            child->key == "op")
+        if (child->kind == pruned_location || child->kind == pruned_stmt_len ||
+            child->kind == pruned_version || child->kind == pruned_inh ||
+            child->kind == pruned_relpersistence || child->kind == pruned_limit_option ||
+            child->kind == pruned_op)
         {
+            root->child_index.clear();
 
             // Update the parent of each grandchild to point to the current root node
             if (child->children.size() > 0)
@@ -189,7 +450,7 @@ std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> AbstractSyntaxTree::get_s
     }
     return statements;
 }
-std::shared_ptr<AbstractSyntaxTree::Node> AbstractSyntaxTree::get_statement_node(const std::shared_ptr<Node> &node) const
+std::shared_ptr<AbstractSyntaxTree::Node> AbstractSyntaxTree::get_statement_node(const std::shared_ptr<Node> &node)
 {
     if (!node)
     {
@@ -216,3 +477,34 @@ std::shared_ptr<AbstractSyntaxTree::Node> AbstractSyntaxTree::get_statement_node
     // If no statement node was found in this subtree, return nullptr.
     return nullptr;
 }
+AbstractSyntaxTree::statement_kind AbstractSyntaxTree::get_statement_kind(const std::shared_ptr<Node> &node)
+{
+    auto stmt_node = get_statement_node(node);
+    if (!stmt_node)
+    {
+        return statement_kind::UNKNOWN;
+    }
+    return to_statement_kind(stmt_node->key);
+}
+AbstractSyntaxTree::statement_kind AbstractSyntaxTree::to_statement_kind(std::string_view name)
+{
+    auto it = std::lower_bound(statement_table.begin(), statement_table.end(), name,
+                               [](const statement_entry &entry, std::string_view value)
+                               { return entry.first < value; });
+    if (it != statement_table.end() && it->first == name)
+    {
+        return it->second;
+    }
+    return statement_kind::UNKNOWN;
+}
+std::string_view AbstractSyntaxTree::statement_kind_to_string(statement_kind kind)
+{
+    for (const auto &entry : statement_table)
+    {
+        if (entry.second == kind)
+        {
+            return entry.first;
+        }
+    }
+    return "";
+}
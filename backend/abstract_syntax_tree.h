@@ -14,6 +14,9 @@
 #include <vector>
 #include <nlohmann/json.hpp>
 #include <memory>
+#include <string_view>
+#include <cstdint>
+#include <utility>
 
 using std::string;
 using std::vector;
@@ -21,6 +24,55 @@ using std::vector;
 class AbstractSyntaxTree
 {
 public:
+    /**
+     * The kinds of statements that pg_query can produce. Each kind corresponds to a statement node name
+     * in the parse tree (e.g. SELECT_STMT for "SelectStmt"), so statement dispatch is an integer compare.
+     */
+    enum class statement_kind
+    {
+        UNKNOWN,
+        ALTER_EVENT_TRIG_STMT, ALTER_COLLATION_STMT, ALTER_DATABASE_STMT, ALTER_DATABASE_SET_STMT,
+        ALTER_DEFAULT_PRIVILEGES_STMT, ALTER_DOMAIN_STMT, ALTER_ENUM_STMT, ALTER_EXTENSION_STMT,
+        ALTER_EXTENSION_CONTENTS_STMT, ALTER_FDW_STMT, ALTER_FOREIGN_SERVER_STMT, ALTER_FUNCTION_STMT,
+        ALTER_GROUP_STMT, ALTER_OBJECT_DEPENDS_STMT, ALTER_OBJECT_SCHEMA_STMT, ALTER_OWNER_STMT,
+        ALTER_OPERATOR_STMT, ALTER_TYPE_STMT, ALTER_POLICY_STMT, ALTER_SEQ_STMT,
+        ALTER_SYSTEM_STMT, ALTER_TABLE_STMT, ALTER_TBL_SPC_STMT, ALTER_COMPOSITE_TYPE_STMT,
+        ALTER_PUBLICATION_STMT, ALTER_ROLE_SET_STMT, ALTER_ROLE_STMT, ALTER_SUBSCRIPTION_STMT,
+        ALTER_STATS_STMT, ALTER_TS_CONFIGURATION_STMT, ALTER_TS_DICTIONARY_STMT, ALTER_USER_MAPPING_STMT,
+        ANALYZE_STMT, CALL_STMT, CHECK_POINT_STMT, CLOSE_PORTAL_STMT,
+        CLUSTER_STMT, COMMENT_STMT, CONSTRAINTS_SET_STMT, COPY_STMT,
+        CREATE_AM_STMT, CREATE_AS_STMT, CREATE_ASSERTION_STMT, CREATE_CAST_STMT,
+        CREATE_CONVERSION_STMT, CREATE_DOMAIN_STMT, CREATE_EXTENSION_STMT, CREATE_FDW_STMT,
+        CREATE_FOREIGN_SERVER_STMT, CREATE_FOREIGN_TABLE_STMT, CREATE_FUNCTION_STMT, CREATE_GROUP_STMT,
+        CREATE_MAT_VIEW_STMT, CREATE_OP_CLASS_STMT, CREATE_OP_FAMILY_STMT, CREATE_PUBLICATION_STMT,
+        ALTER_OP_FAMILY_STMT, CREATE_POLICY_STMT, CREATE_PLANG_STMT, CREATE_SCHEMA_STMT,
+        CREATE_SEQ_STMT, CREATE_STMT, CREATE_SUBSCRIPTION_STMT, CREATE_STATS_STMT,
+        CREATE_TABLE_SPACE_STMT, CREATE_TRANSFORM_STMT, CREATE_TRIG_STMT, CREATE_EVENT_TRIG_STMT,
+        CREATE_ROLE_STMT, CREATE_USER_STMT, CREATE_USER_MAPPING_STMT, CREATEDB_STMT,
+        DEALLOCATE_STMT, DECLARE_CURSOR_STMT, DEFINE_STMT, DELETE_STMT,
+        DISCARD_STMT, DO_STMT, DROP_CAST_STMT, DROP_OP_CLASS_STMT,
+        DROP_OP_FAMILY_STMT, DROP_OWNED_STMT, DROP_STMT, DROP_SUBSCRIPTION_STMT,
+        DROP_TABLE_SPACE_STMT, DROP_TRANSFORM_STMT, DROP_ROLE_STMT, DROP_USER_MAPPING_STMT,
+        DROPDB_STMT, EXECUTE_STMT, EXPLAIN_STMT, FETCH_STMT,
+        GRANT_STMT, GRANT_ROLE_STMT, IMPORT_FOREIGN_SCHEMA_STMT, INDEX_STMT,
+        INSERT_STMT, LISTEN_STMT, REFRESH_MAT_VIEW_STMT, LOAD_STMT,
+        LOCK_STMT, MERGE_STMT, NOTIFY_STMT, PREPARE_STMT,
+        REASSIGN_OWNED_STMT, REINDEX_STMT, REMOVE_AGGR_STMT, REMOVE_FUNC_STMT,
+        REMOVE_OPER_STMT, RENAME_STMT, REVOKE_STMT, REVOKE_ROLE_STMT,
+        RULE_STMT, SEC_LABEL_STMT, SELECT_STMT, TRANSACTION_STMT,
+        TRUNCATE_STMT, UNLISTEN_STMT, UPDATE_STMT, VACUUM_STMT,
+        VARIABLE_RESET_STMT, VARIABLE_SET_STMT, VARIABLE_SHOW_STMT, VIEW_STMT,
+    };
+    /**
+     * Integer id of a node key. Every distinct key string is interned once and gets its own id,
+     * so two nodes have the same key exactly when they have the same kind.
+     */
+    using node_kind = std::uint32_t;
+    /**
+     * Nodes with at least this many children get a sorted (kind, position) index for get_child.
+     * Narrower nodes are scanned linearly, which is faster for a handful of children.
+     */
+    static constexpr std::size_t child_index_threshold = 8;
     /**
      * This struct represents a node in the abstract syntax tree.
      * enable_shared_from_this allows allocating children pointers to one parent.
@@ -29,8 +81,10 @@ public:
     {
         string key;
         string value;
+        node_kind kind; /**< The interned id of key. */
         vector<std::shared_ptr<Node>> children;
         std::weak_ptr<Node> parent;
+        vector<std::pair<node_kind, std::uint32_t>> child_index; /**< (kind, position) of the children sorted by kind. Empty for narrow nodes. */
 
         /**
          * explicit keyword in the constructor prevents implicit conversions of the parameters.
@@ -45,9 +99,41 @@ public:
          */
         void add_child(std::shared_ptr<Node> child);
 
+        /**
+         * This function returns the first child with the given key.
+         * @param key: The key of the child.
+         * @return: The child node, or nullptr if there is none.
+         */
         std::shared_ptr<Node> get_child(const std::string &key) const;
+        /**
+         * This function returns the first child of the given kind.
+         * It uses the child index when the node has one and a linear scan over kinds otherwise.
+         * @param kind: The interned key of the child.
+         * @return: The child node, or nullptr if there is none.
+         */
+        std::shared_ptr<Node> get_child(node_kind kind) const;
         std::string get_value(const std::string &key) const;
+        std::string get_value(node_kind kind) const;
+        /**
+         * This function builds the child index if the node is wide enough to benefit from it.
+         * It must be called again after the children have been changed directly.
+         */
+        void index_children();
     };
+    /**
+     * This function interns a node key. The same key always gets the same id.
+     * It is safe to call from several threads.
+     * @param key: The node key, e.g. "fromClause".
+     * @return: The id of the key.
+     */
+    static node_kind intern_key(const std::string &key);
+    /**
+     * This function looks up the id of a node key without interning it.
+     * @param key: The node key.
+     * @param kind: Set to the id of the key if it has been interned.
+     * @return: true if the key has been interned, false otherwise. No node can have a key that was never interned.
+     */
+    static bool find_key(const std::string &key, node_kind &kind);
     /**
      * This function builds an abstract syntax tree in a c++ object oriented structure.
      * @param input: This is the parse tree in JSON format.
@@ -74,41 +160,39 @@ public:
      * @return: This is a string representing the type of statement.
      */
     static string get_statement_type(const std::shared_ptr<Node> &node);
+    /**
+     * This function returns the kind of statement represented by a parse tree.
+     * Unlike get_statement_type, the result can be compared as an integer.
+     * @param node: This is a pointer to the root node in the parse tree.
+     * @return: The statement kind, or statement_kind::UNKNOWN if no statement was found.
+     */
+    static statement_kind get_statement_kind(const std::shared_ptr<Node> &node);
+    /**
+     * This function maps a pg_query statement node name (e.g. "SelectStmt") to its statement kind.
+     * @param name: The name of the statement node.
+     * @return: The statement kind, or statement_kind::UNKNOWN if the name is not a statement node.
+     */
+    static statement_kind to_statement_kind(std::string_view name);
+    /**
+     * This function maps a statement kind back to its pg_query statement node name.
+     * @param kind: The statement kind.
+     * @return: The name of the statement node, or an empty string for statement_kind::UNKNOWN.
+     */
+    static std::string_view statement_kind_to_string(statement_kind kind);
     static std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> get_statements(const std::shared_ptr<AbstractSyntaxTree::Node> &root);
-    std::shared_ptr<AbstractSyntaxTree::Node> get_statement_node(const std::shared_ptr<Node> &node) const;
+    static std::shared_ptr<AbstractSyntaxTree::Node> get_statement_node(const std::shared_ptr<Node> &node);
 
 private:
-    const string statement_types[124] = {
-        "AlterEventTrigStmt", "AlterCollationStmt", "AlterDatabaseStmt", "AlterDatabaseSetStmt",
-        "AlterDefaultPrivilegesStmt", "AlterDomainStmt", "AlterEnumStmt", "AlterExtensionStmt",
-        "AlterExtensionContentsStmt", "AlterFdwStmt", "AlterForeignServerStmt", "AlterFunctionStmt",
-        "AlterGroupStmt", "AlterObjectDependsStmt", "AlterObjectSchemaStmt", "AlterOwnerStmt",
-        "AlterOperatorStmt", "AlterTypeStmt", "AlterPolicyStmt", "AlterSeqStmt",
-        "AlterSystemStmt", "AlterTableStmt", "AlterTblSpcStmt", "AlterCompositeTypeStmt",
-        "AlterPublicationStmt", "AlterRoleSetStmt", "AlterRoleStmt", "AlterSubscriptionStmt",
-        "AlterStatsStmt", "AlterTSConfigurationStmt", "AlterTSDictionaryStmt", "AlterUserMappingStmt",
-        "AnalyzeStmt", "CallStmt", "CheckPointStmt", "ClosePortalStmt",
-        "ClusterStmt", "CommentStmt", "ConstraintsSetStmt", "CopyStmt",
-        "CreateAmStmt", "CreateAsStmt", "CreateAssertionStmt", "CreateCastStmt",
-        "CreateConversionStmt", "CreateDomainStmt", "CreateExtensionStmt", "CreateFdwStmt",
-        "CreateForeignServerStmt", "CreateForeignTableStmt", "CreateFunctionStmt", "CreateGroupStmt",
-        "CreateMatViewStmt", "CreateOpClassStmt", "CreateOpFamilyStmt", "CreatePublicationStmt",
-        "AlterOpFamilyStmt", "CreatePolicyStmt", "CreatePLangStmt", "CreateSchemaStmt",
-        "CreateSeqStmt", "CreateStmt", "CreateSubscriptionStmt", "CreateStatsStmt",
-        "CreateTableSpaceStmt", "CreateTransformStmt", "CreateTrigStmt", "CreateEventTrigStmt",
-        "CreateRoleStmt", "CreateUserStmt", "CreateUserMappingStmt", "CreatedbStmt",
-        "DeallocateStmt", "DeclareCursorStmt", "DefineStmt", "DeleteStmt",
-        "DiscardStmt", "DoStmt", "DropCastStmt", "DropOpClassStmt",
-        "DropOpFamilyStmt", "DropOwnedStmt", "DropStmt", "DropSubscriptionStmt",
-        "DropTableSpaceStmt", "DropTransformStmt", "DropRoleStmt", "DropUserMappingStmt",
-        "DropdbStmt", "ExecuteStmt", "ExplainStmt", "FetchStmt",
-        "GrantStmt", "GrantRoleStmt", "ImportForeignSchemaStmt", "IndexStmt",
-        "InsertStmt", "ListenStmt", "RefreshMatViewStmt", "LoadStmt",
-        "LockStmt", "MergeStmt", "NotifyStmt", "PrepareStmt",
-        "ReassignOwnedStmt", "ReindexStmt", "RemoveAggrStmt", "RemoveFuncStmt",
-        "RemoveOperStmt", "RenameStmt", "RevokeStmt", "RevokeRoleStmt",
-        "RuleStmt", "SecLabelStmt", "SelectStmt", "TransactionStmt",
-        "TruncateStmt", "UnlistenStmt", "UpdateStmt", "VacuumStmt",
-        "VariableResetStmt", "VariableSetStmt", "VariableShowStmt", "ViewStmt"};
+    /**
+     * This function adds the nodes of a parse tree under a node and prunes them, see build_tree.
+     * @param input: This is the parse tree in JSON format.
+     * @param parent: This is a pointer to the node the nodes are added to.
+     */
+    void add_children(const nlohmann::json &input, std::shared_ptr<Node> &parent);
+    /**
+     * This function indexes the children of every node of a tree, once the tree is complete.
+     * @param node: This is a pointer to the root node.
+     */
+    static void index_tree(const std::shared_ptr<Node> &node);
 };
 #endif // !ABSTRACT_SYNTAX_TREE_H
\ No newline at end of file
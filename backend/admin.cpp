@@ -78,4 +78,30 @@ int Admin::get_syntax_minor_incorrect_ted() const
 int Admin::get_semantics_minor_incorrect_ted() const
 {
     return semantics_minor_incorrect_ted;
+}
+
+void Admin::set_semantics_prefilter(semantics_prefilter prefilter, double max_pq_gram_distance)
+{
+    this->prefilter = prefilter;
+    this->max_pq_gram_distance = max_pq_gram_distance;
+}
+
+Admin::semantics_prefilter Admin::get_semantics_prefilter() const
+{
+    return prefilter;
+}
+
+double Admin::get_max_pq_gram_distance() const
+{
+    return max_pq_gram_distance;
+}
+
+void Admin::set_tree_edit_distance_algorithm(TreeEditDistance::algorithm tree_algorithm)
+{
+    this->tree_algorithm = tree_algorithm;
+}
+
+TreeEditDistance::algorithm Admin::get_tree_edit_distance_algorithm() const
+{
+    return tree_algorithm;
 }
\ No newline at end of file
@@ -10,13 +10,34 @@
 #ifndef ADMIN_H
 #define ADMIN_H
 #include <string>
+#include <vector>
 #include "grader.h"
+#include "tree_edit_distance.h"
 
 using std::string;
 
 class Admin
 {
 public:
+    /**
+     * The file formats a table of a dataset can be loaded from.
+     */
+    enum class dataset_format
+    {
+        PARQUET,
+        CSV
+    };
+    /**
+     * A table of a dataset that is loaded from a file with the DuckDB readers instead of INSERT statements.
+     * If the script created the table, the columns of the file fill the columns with the same names; otherwise the
+     * table is created with the columns of the file.
+     */
+    struct dataset_table
+    {
+        string name;           /**< The name of the table. */
+        string path;           /**< The path of the file on the server. */
+        dataset_format format; /**< The format of the file. */
+    };
     struct database_options
     {
         string sql_file;
@@ -27,6 +48,17 @@ public:
         string postgresql_dbname;
         bool is_front_end;
         bool use_postgresql;
+        std::vector<dataset_table> dataset_tables = {}; /**< The tables loaded from files after the script, DuckDB only. */
+        string dataset_sha256 = {};                     /**< The SHA-256 of the script if it is a stored dataset, see DatabaseCache::find_or_load. */
+    };
+    /**
+     * How semantics analysis picks the queries it computes the exact tree edit distance to.
+     * NONE - every candidate query, PQ_GRAM - only the queries whose pq-gram distance is within a maximum.
+     */
+    enum class semantics_prefilter
+    {
+        NONE,
+        PQ_GRAM
     };
     /**
      * The arguments for these constructor are given by the admin/instructor. For now they are command line arguments.
@@ -103,6 +135,33 @@ public:
      * @param num_of_syntax_outcomes: the boundary value for minor incorrect semantics.
      */
     int get_semantics_minor_incorrect_ted() const;
+    /**
+     * This function sets how semantics analysis picks the queries to compare with. The pq-gram prefilter is an
+     * approximation, a query within the minor error tree edit distance can still be skipped if its pq-gram distance is high.
+     * @param prefilter: the prefilter to use.
+     * @param max_pq_gram_distance: the maximum pq-gram distance, from 0 to 1, of a query that is compared exactly.
+     */
+    void set_semantics_prefilter(semantics_prefilter prefilter, double max_pq_gram_distance);
+    /**
+     * This function returns how semantics analysis picks the queries to compare with.
+     * @return: the semantics prefilter.
+     */
+    semantics_prefilter get_semantics_prefilter() const;
+    /**
+     * This function returns the maximum pq-gram distance of a query that is compared exactly when the pq-gram prefilter is used.
+     * @return: the maximum pq-gram distance.
+     */
+    double get_max_pq_gram_distance() const;
+    /**
+     * This function sets the algorithm semantics analysis uses to compute tree edit distances.
+     * @param tree_algorithm: the tree edit distance algorithm.
+     */
+    void set_tree_edit_distance_algorithm(TreeEditDistance::algorithm tree_algorithm);
+    /**
+     * This function returns the algorithm semantics analysis uses to compute tree edit distances.
+     * @return: the tree edit distance algorithm.
+     */
+    TreeEditDistance::algorithm get_tree_edit_distance_algorithm() const;
 
 private:
     string connection_string; /**< The connection string used to connect to the database. contructed from host, database, user and password*/
@@ -114,5 +173,8 @@ private:
     bool check_order;                       /**< If true, the order of the results is also checked. If false, the order of the results is not checked. */
     int syntax_minor_incorrect_ted;         /**< The boundary value for determining how many wrong characters a required to classify the syntax of a query as minor incorrect. It is used in levenstein distance calculation. */
     int semantics_minor_incorrect_ted;      /**< The boundary value for determining how many wrong characters a required to classify the semantics of a query as minor incorrect. It is used in levenstein distance calculation. */
+    semantics_prefilter prefilter = semantics_prefilter::NONE; /**< How semantics analysis picks the queries to compare with. */
+    double max_pq_gram_distance = 0.6;                          /**< The maximum pq-gram distance of a query that is compared exactly. */
+    TreeEditDistance::algorithm tree_algorithm = TreeEditDistance::algorithm::ZHANG_SHASHA; /**< The algorithm used to compute tree edit distances. */
 };
 #endif // !ADMIN_H
\ No newline at end of file
@@ -605,11 +605,9 @@ Common::comparision_result Create_clause::compare(const create_clause_info &refe
                 auto refCond = reference.check_condition_nodes[i];
                 auto stuCond = other.check_condition_nodes[i];
 
-                // Generate canonical signatures (handles commutativity and ordering)
-                std::string sigRef = Where_clause::generate_condition_signature(refCond);
-                std::string sigStu = Where_clause::generate_condition_signature(stuCond);
-
-                if (sigRef != sigStu)
+                // Compare canonical hashes (handles commutativity and ordering), equal hashes are confirmed by the signatures
+                if (refCond->hash != stuCond->hash ||
+                    Where_clause::generate_condition_signature(refCond) != Where_clause::generate_condition_signature(stuCond))
                 {
                     incorrect_parts.push_back("Check constraints");
                     message << "● For CHECK constraint " << (i + 1) << ", expected: " << Where_clause::condition_to_string(refCond) << " but found: " << Where_clause::condition_to_string(stuCond) << ".\n";
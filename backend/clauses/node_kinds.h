@@ -0,0 +1,86 @@
+/**
+ * @file node_kinds.h
+ * @brief Interned ids of the parse tree keys used by the clause extractors.
+ * Comparing a node's kind with one of these ids replaces a string compare on its key.
+ *
+ * @author Benard Wanjiru
+ * Contact: benard.wanjiru@ru.nl
+ */
+#ifndef NODE_KINDS_H
+#define NODE_KINDS_H
+
+#include "../abstract_syntax_tree.h"
+
+namespace node_kinds
+{
+    inline const AbstractSyntaxTree::node_kind A_ArrayExpr = AbstractSyntaxTree::intern_key("A_ArrayExpr");
+    inline const AbstractSyntaxTree::node_kind A_Const = AbstractSyntaxTree::intern_key("A_Const");
+    inline const AbstractSyntaxTree::node_kind A_Expr = AbstractSyntaxTree::intern_key("A_Expr");
+    inline const AbstractSyntaxTree::node_kind A_Star = AbstractSyntaxTree::intern_key("A_Star");
+    inline const AbstractSyntaxTree::node_kind alias = AbstractSyntaxTree::intern_key("alias");
+    inline const AbstractSyntaxTree::node_kind aliasname = AbstractSyntaxTree::intern_key("aliasname");
+    inline const AbstractSyntaxTree::node_kind arg = AbstractSyntaxTree::intern_key("arg");
+    inline const AbstractSyntaxTree::node_kind args = AbstractSyntaxTree::intern_key("args");
+    inline const AbstractSyntaxTree::node_kind BoolExpr = AbstractSyntaxTree::intern_key("BoolExpr");
+    inline const AbstractSyntaxTree::node_kind boolop = AbstractSyntaxTree::intern_key("boolop");
+    inline const AbstractSyntaxTree::node_kind CollateClause = AbstractSyntaxTree::intern_key("CollateClause");
+    inline const AbstractSyntaxTree::node_kind collation = AbstractSyntaxTree::intern_key("collation");
+    inline const AbstractSyntaxTree::node_kind collname = AbstractSyntaxTree::intern_key("collname");
+    inline const AbstractSyntaxTree::node_kind ColumnRef = AbstractSyntaxTree::intern_key("ColumnRef");
+    inline const AbstractSyntaxTree::node_kind CommonTableExpr = AbstractSyntaxTree::intern_key("CommonTableExpr");
+    inline const AbstractSyntaxTree::node_kind content = AbstractSyntaxTree::intern_key("content");
+    inline const AbstractSyntaxTree::node_kind ctename = AbstractSyntaxTree::intern_key("ctename");
+    inline const AbstractSyntaxTree::node_kind distinctClause = AbstractSyntaxTree::intern_key("distinctClause");
+    inline const AbstractSyntaxTree::node_kind fields = AbstractSyntaxTree::intern_key("fields");
+    inline const AbstractSyntaxTree::node_kind fromClause = AbstractSyntaxTree::intern_key("fromClause");
+    inline const AbstractSyntaxTree::node_kind FuncCall = AbstractSyntaxTree::intern_key("FuncCall");
+    inline const AbstractSyntaxTree::node_kind funcname = AbstractSyntaxTree::intern_key("funcname");
+    inline const AbstractSyntaxTree::node_kind fval = AbstractSyntaxTree::intern_key("fval");
+    inline const AbstractSyntaxTree::node_kind groupClause = AbstractSyntaxTree::intern_key("groupClause");
+    inline const AbstractSyntaxTree::node_kind GroupingSet = AbstractSyntaxTree::intern_key("GroupingSet");
+    inline const AbstractSyntaxTree::node_kind havingClause = AbstractSyntaxTree::intern_key("havingClause");
+    inline const AbstractSyntaxTree::node_kind isNatural = AbstractSyntaxTree::intern_key("isNatural");
+    inline const AbstractSyntaxTree::node_kind ival = AbstractSyntaxTree::intern_key("ival");
+    inline const AbstractSyntaxTree::node_kind JoinExpr = AbstractSyntaxTree::intern_key("JoinExpr");
+    inline const AbstractSyntaxTree::node_kind jointype = AbstractSyntaxTree::intern_key("jointype");
+    inline const AbstractSyntaxTree::node_kind kind = AbstractSyntaxTree::intern_key("kind");
+    inline const AbstractSyntaxTree::node_kind larg = AbstractSyntaxTree::intern_key("larg");
+    inline const AbstractSyntaxTree::node_kind lexpr = AbstractSyntaxTree::intern_key("lexpr");
+    inline const AbstractSyntaxTree::node_kind List = AbstractSyntaxTree::intern_key("List");
+    inline const AbstractSyntaxTree::node_kind lower = AbstractSyntaxTree::intern_key("lower");
+    inline const AbstractSyntaxTree::node_kind name = AbstractSyntaxTree::intern_key("name");
+    inline const AbstractSyntaxTree::node_kind names = AbstractSyntaxTree::intern_key("names");
+    inline const AbstractSyntaxTree::node_kind node = AbstractSyntaxTree::intern_key("node");
+    inline const AbstractSyntaxTree::node_kind NullTest = AbstractSyntaxTree::intern_key("NullTest");
+    inline const AbstractSyntaxTree::node_kind nulltesttype = AbstractSyntaxTree::intern_key("nulltesttype");
+    inline const AbstractSyntaxTree::node_kind operName = AbstractSyntaxTree::intern_key("operName");
+    inline const AbstractSyntaxTree::node_kind quals = AbstractSyntaxTree::intern_key("quals");
+    inline const AbstractSyntaxTree::node_kind RangeFunction = AbstractSyntaxTree::intern_key("RangeFunction");
+    inline const AbstractSyntaxTree::node_kind RangeSubselect = AbstractSyntaxTree::intern_key("RangeSubselect");
+    inline const AbstractSyntaxTree::node_kind RangeVar = AbstractSyntaxTree::intern_key("RangeVar");
+    inline const AbstractSyntaxTree::node_kind rarg = AbstractSyntaxTree::intern_key("rarg");
+    inline const AbstractSyntaxTree::node_kind relname = AbstractSyntaxTree::intern_key("relname");
+    inline const AbstractSyntaxTree::node_kind ResTarget = AbstractSyntaxTree::intern_key("ResTarget");
+    inline const AbstractSyntaxTree::node_kind rexpr = AbstractSyntaxTree::intern_key("rexpr");
+    inline const AbstractSyntaxTree::node_kind SelectStmt = AbstractSyntaxTree::intern_key("SelectStmt");
+    inline const AbstractSyntaxTree::node_kind SortBy = AbstractSyntaxTree::intern_key("SortBy");
+    inline const AbstractSyntaxTree::node_kind sortby_dir = AbstractSyntaxTree::intern_key("sortby_dir");
+    inline const AbstractSyntaxTree::node_kind sortby_nulls = AbstractSyntaxTree::intern_key("sortby_nulls");
+    inline const AbstractSyntaxTree::node_kind sortClause = AbstractSyntaxTree::intern_key("sortClause");
+    inline const AbstractSyntaxTree::node_kind String = AbstractSyntaxTree::intern_key("String");
+    inline const AbstractSyntaxTree::node_kind SubLink = AbstractSyntaxTree::intern_key("SubLink");
+    inline const AbstractSyntaxTree::node_kind subLinkType = AbstractSyntaxTree::intern_key("subLinkType");
+    inline const AbstractSyntaxTree::node_kind subselect = AbstractSyntaxTree::intern_key("subselect");
+    inline const AbstractSyntaxTree::node_kind sval = AbstractSyntaxTree::intern_key("sval");
+    inline const AbstractSyntaxTree::node_kind targetList = AbstractSyntaxTree::intern_key("targetList");
+    inline const AbstractSyntaxTree::node_kind testexpr = AbstractSyntaxTree::intern_key("testexpr");
+    inline const AbstractSyntaxTree::node_kind TypeCast = AbstractSyntaxTree::intern_key("TypeCast");
+    inline const AbstractSyntaxTree::node_kind typeName = AbstractSyntaxTree::intern_key("typeName");
+    inline const AbstractSyntaxTree::node_kind upper = AbstractSyntaxTree::intern_key("upper");
+    inline const AbstractSyntaxTree::node_kind usingClause = AbstractSyntaxTree::intern_key("usingClause");
+    inline const AbstractSyntaxTree::node_kind val = AbstractSyntaxTree::intern_key("val");
+    inline const AbstractSyntaxTree::node_kind whereClause = AbstractSyntaxTree::intern_key("whereClause");
+    inline const AbstractSyntaxTree::node_kind withClause = AbstractSyntaxTree::intern_key("withClause");
+}
+
+#endif // NODE_KINDS_H
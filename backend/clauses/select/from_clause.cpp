@@ -1,4 +1,5 @@
 #include "from_clause.h"
+#include "../node_kinds.h"
 #include "../common.h"
 #include <iostream>
 #include "where_clause.h"
@@ -10,15 +11,15 @@ From_clause::table_info From_clause::extract_table_info(const std::shared_ptr<Ab
     int i = 0;
     for (const auto &child : range_var_node->children)
     {
-        if (child->key == "relname")
+        if (child->kind == node_kinds::relname)
         {
             tab_info.table_name = Common::strip_quotes(child->value);
         }
-        else if (child->key == "alias")
+        else if (child->kind == node_kinds::alias)
         {
             for (const auto &aliasChild : child->children)
             {
-                if (aliasChild->key == "aliasname")
+                if (aliasChild->kind == node_kinds::aliasname)
                 {
                     tab_info.alias = Common::strip_quotes(aliasChild->value);
                 }
@@ -32,15 +33,15 @@ std::string From_clause::extract_column_ref(const std::shared_ptr<AbstractSyntax
     std::vector<std::string> fields;
     for (const auto &child : column_ref_node->children)
     {
-        if (child->key == "fields")
+        if (child->kind == node_kinds::fields)
         {
             for (const auto &field_node : child->children)
             {
-                if (field_node->key == "String")
+                if (field_node->kind == node_kinds::String)
                 {
                     for (const auto &sval_node : field_node->children)
                     {
-                        if (sval_node->key == "sval")
+                        if (sval_node->kind == node_kinds::sval)
                         {
                             fields.push_back(Common::strip_quotes(sval_node->value));
                         }
@@ -85,28 +86,28 @@ std::string From_clause::extract_column_ref(const std::shared_ptr<AbstractSyntax
 }
 std::string From_clause::extract_join_condition(const std::shared_ptr<AbstractSyntaxTree::Node> &quals_node, const join_info &info)
 {
-    if (quals_node->key == "A_Expr")
+    if (quals_node->kind == node_kinds::A_Expr)
     {
         std::string left_expr, operator_, right_expr;
         for (const auto &child : quals_node->children)
         {
-            if (child->key == "lexpr")
+            if (child->kind == node_kinds::lexpr)
             {
                 left_expr = extract_expression(child->children.front(), info);
             }
-            else if (child->key == "rexpr")
+            else if (child->kind == node_kinds::rexpr)
             {
                 right_expr = extract_expression(child->children.front(), info);
             }
-            else if (child->key == "name")
+            else if (child->kind == node_kinds::name)
             {
                 for (const auto &op_node : child->children)
                 {
-                    if (op_node->key == "String")
+                    if (op_node->kind == node_kinds::String)
                     {
                         for (const auto &sval_node : op_node->children)
                         {
-                            if (sval_node->key == "sval")
+                            if (sval_node->kind == node_kinds::sval)
                             {
                                 operator_ = Common::strip_quotes(sval_node->value);
                             }
@@ -121,7 +122,7 @@ std::string From_clause::extract_join_condition(const std::shared_ptr<AbstractSy
 }
 std::string From_clause::extract_expression(const std::shared_ptr<AbstractSyntaxTree::Node> &expr_node, const join_info &info)
 {
-    if (expr_node->key == "ColumnRef")
+    if (expr_node->kind == node_kinds::ColumnRef)
     {
         return extract_column_ref(expr_node, info);
     }
@@ -130,37 +131,37 @@ std::string From_clause::extract_expression(const std::shared_ptr<AbstractSyntax
 }
 From_clause::table_info From_clause::extract_table_or_join(const std::shared_ptr<AbstractSyntaxTree::Node> &node, from_clause_info &info)
 {
-    if (node->key == "RangeVar")
+    if (node->kind == node_kinds::RangeVar)
     {
         return extract_table_info(node);
     }
-    else if (node->key == "JoinExpr")
+    else if (node->kind == node_kinds::JoinExpr)
     {
         process_join_expr(node, info);
         return table_info{"(nested join)", ""};
     }
-    else if (node->key == "RangeSubselect")
+    else if (node->kind == node_kinds::RangeSubselect)
     {
         // Handle subqueries in FROM clause
         table_info subquery_info;
         subquery_info.table_name = "(subquery)";
-        auto alias_node = node->get_child("alias");
+        auto alias_node = node->get_child(node_kinds::alias);
         if (alias_node)
         {
-            subquery_info.alias = alias_node->get_value("aliasname");
+            subquery_info.alias = alias_node->get_value(node_kinds::aliasname);
         }
         info.tables.push_back(subquery_info);
         return subquery_info;
     }
-    else if (node->key == "RangeFunction")
+    else if (node->kind == node_kinds::RangeFunction)
     {
         // Handle functions in FROM clause
         table_info func_info;
         func_info.table_name = "(function)";
-        auto alias_node = node->get_child("alias");
+        auto alias_node = node->get_child(node_kinds::alias);
         if (alias_node)
         {
-            func_info.alias = alias_node->get_value("aliasname");
+            func_info.alias = alias_node->get_value(node_kinds::aliasname);
         }
         info.tables.push_back(func_info);
         return func_info;
@@ -172,45 +173,45 @@ void From_clause::process_join_expr(const std::shared_ptr<AbstractSyntaxTree::No
 {
 
     join_info join;
-    join.join_type = join_expr_node->get_value("jointype");
+    join.join_type = join_expr_node->get_value(node_kinds::jointype);
 
     // Left argument
-    auto larg_node = join_expr_node->get_child("larg");
+    auto larg_node = join_expr_node->get_child(node_kinds::larg);
     if (larg_node)
     {
         join.left_table = extract_table_or_join(larg_node->children.front(), info);
     }
 
     // Right argument
-    auto rarg_node = join_expr_node->get_child("rarg");
+    auto rarg_node = join_expr_node->get_child(node_kinds::rarg);
     if (rarg_node)
     {
         join.right_table = extract_table_or_join(rarg_node->children.front(), info);
     }
 
     // Join condition
-    auto quals_node = join_expr_node->get_child("quals");
+    auto quals_node = join_expr_node->get_child(node_kinds::quals);
     if (quals_node)
     {
         join.join_condition = extract_join_condition(quals_node->children.front(), join);
     }
 
     // USING clause
-    auto using_clause_node = join_expr_node->get_child("usingClause");
+    auto using_clause_node = join_expr_node->get_child(node_kinds::usingClause);
     if (using_clause_node)
     {
         join.has_using_clause = true;
         for (const auto &col_node : using_clause_node->children)
         {
-            if (col_node->key == "String")
+            if (col_node->kind == node_kinds::String)
             {
-                join.using_columns.push_back(Common::strip_quotes(col_node->get_child("sval")->value));
+                join.using_columns.push_back(Common::strip_quotes(col_node->get_child(node_kinds::sval)->value));
             }
         }
     }
 
     // NATURAL JOIN
-    std::string is_natural = join_expr_node->get_value("isNatural");
+    std::string is_natural = join_expr_node->get_value(node_kinds::isNatural);
     if (is_natural == "true")
     {
         join.is_natural = true;
@@ -229,27 +230,27 @@ From_clause::from_clause_info From_clause::get_info(const std::shared_ptr<Abstra
     {
         return info;
     }
-    if (node->key == "withClause")
+    if (node->kind == node_kinds::withClause)
     {
         // Process Common Table Expressions (CTEs)
         for (const auto &cte_node : node->children)
         {
-            if (cte_node->key == "CommonTableExpr")
+            if (cte_node->kind == node_kinds::CommonTableExpr)
             {
-                std::string cte_name = cte_node->get_value("ctename");
+                std::string cte_name = cte_node->get_value(node_kinds::ctename);
                 info.ctes.push_back(cte_name);
             }
         }
     }
-    else if (node->key == "fromClause" || node->key == "usingClause")
+    else if (node->kind == node_kinds::fromClause || node->kind == node_kinds::usingClause)
     {
         for (const auto &child : node->children)
         {
-            if (child->key == "JoinExpr")
+            if (child->kind == node_kinds::JoinExpr)
             {
                 process_join_expr(child, info);
             }
-            else if (child->key == "RangeVar")
+            else if (child->kind == node_kinds::RangeVar)
             {
                 table_info table = extract_table_info(child);
                 info.tables.push_back(table);
@@ -1,4 +1,5 @@
 #include "group_by_clause.h"
+#include "../node_kinds.h"
 #include "where_clause.h"
 #include <iostream>
 
@@ -71,16 +72,16 @@ Group_by_clause::group_by_clause_info Group_by_clause::get_info(const std::share
         return info;
     }
 
-    if (node->key == "groupClause")
+    if (node->kind == node_kinds::groupClause)
     {
         for (const auto &child : node->children)
         {
-            if (child->key == "GroupingSet")
+            if (child->kind == node_kinds::GroupingSet)
             {
                 // Handle GROUPING SETS, ROLLUP, CUBE
                 for (const auto &gs_child : child->children)
                 {
-                    if (gs_child->key == "kind")
+                    if (gs_child->kind == node_kinds::kind)
                     {
                         if (gs_child->value == "GROUPING SETS")
                         {
@@ -95,7 +96,7 @@ Group_by_clause::group_by_clause_info Group_by_clause::get_info(const std::share
                             info.has_cube = true;
                         }
                     }
-                    else if (gs_child->key == "content")
+                    else if (gs_child->kind == node_kinds::content)
                     {
                         // Process grouping elements
                         for (const auto &elem : gs_child->children)
@@ -115,7 +116,7 @@ Group_by_clause::group_by_clause_info Group_by_clause::get_info(const std::share
                     }
                 }
             }
-            else if (child->key == "ColumnRef")
+            else if (child->kind == node_kinds::ColumnRef)
             {
                 // It's a column
                 std::string column_name = Select_clause::extract_column_name(child, from_info);
@@ -127,7 +128,7 @@ Group_by_clause::group_by_clause_info Group_by_clause::get_info(const std::share
                 // Add to the columns vector
                 info.columns.push_back(column_name);
             }
-            else if (child->key == "FuncCall")
+            else if (child->kind == node_kinds::FuncCall)
             {
                 // It's a function
                 std::string func_name = Select_clause::extract_function(child, from_info);
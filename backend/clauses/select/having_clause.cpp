@@ -1,4 +1,5 @@
 #include "having_clause.h"
+#include "../node_kinds.h"
 #include <iostream>
 
 Where_clause::where_clause_info Having_clause::get_info(const std::shared_ptr<AbstractSyntaxTree::Node> &node, const From_clause::from_clause_info &from_info, const Select_clause::select_clause_info &select_info)
@@ -8,7 +9,7 @@ Where_clause::where_clause_info Having_clause::get_info(const std::shared_ptr<Ab
     {
         return info;
     }
-    if (node->key == "havingClause")
+    if (node->kind == node_kinds::havingClause)
     {
         info.condition_root = Where_clause::extract_condition(node->children.front(), from_info, select_info);
     }
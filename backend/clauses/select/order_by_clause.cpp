@@ -1,4 +1,5 @@
 #include "order_by_clause.h"
+#include "../node_kinds.h"
 #include "where_clause.h"
 #include <iostream>
 #include "../common.h"
@@ -10,18 +11,18 @@ Order_by_clause::order_by_clause_info Order_by_clause::get_info(const std::share
     {
         return info;
     }
-    if (node->key == "sortClause")
+    if (node->kind == node_kinds::sortClause)
     {
         for (const auto &child : node->children)
         {
-            if (child->key == "SortBy")
+            if (child->kind == node_kinds::SortBy)
             {
                 order_by_clause_info::order_item item;
-                auto node_expr = child->get_child("node");
+                auto node_expr = child->get_child(node_kinds::node);
                 if (node_expr)
                 {
                     // Check if the node is an integer constant (position reference)
-                    if (node_expr->children.front()->key == "A_Const")
+                    if (node_expr->children.front()->kind == node_kinds::A_Const)
                     {
                         std::string pos_str = Where_clause::extract_constant(node_expr->children.front());
                         int position = std::stoi(pos_str);
@@ -42,11 +43,11 @@ Order_by_clause::order_by_clause_info Order_by_clause::get_info(const std::share
                         item.expression = Where_clause::extract_expression(node_expr->children.front(), from_info, select_info);
                     }
                 }
-                item.direction = child->get_value("sortby_dir");
-                item.nulls_order = child->get_value("sortby_nulls");
+                item.direction = child->get_value(node_kinds::sortby_dir);
+                item.nulls_order = child->get_value(node_kinds::sortby_nulls);
 
                 // Handle collation
-                auto collation_node = child->get_child("collation");
+                auto collation_node = child->get_child(node_kinds::collation);
                 if (collation_node)
                 {
                     item.collation = extract_collation(collation_node);
@@ -241,11 +242,11 @@ std::string Order_by_clause::extract_collation(const std::shared_ptr<AbstractSyn
     std::string collation_name;
     for (const auto &child : collation_node->children)
     {
-        if (child->key == "String")
+        if (child->kind == node_kinds::String)
         {
             for (const auto &sval_node : child->children)
             {
-                if (sval_node->key == "sval")
+                if (sval_node->kind == node_kinds::sval)
                 {
                     collation_name += Common::strip_quotes(sval_node->value);
                 }
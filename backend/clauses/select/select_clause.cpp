@@ -1,4 +1,5 @@
 #include "select_clause.h"
+#include "../node_kinds.h"
 #include "../common.h"
 #include "where_clause.h"
 #include <iostream>
@@ -10,22 +11,22 @@ std::string Select_clause::extract_column_name(const std::shared_ptr<AbstractSyn
 
     for (const auto &child : column_ref_node->children)
     {
-        if (child->key == "fields")
+        if (child->kind == node_kinds::fields)
         {
             std::vector<std::string> fields;
             for (const auto &field_node : child->children)
             {
-                if (field_node->key == "String")
+                if (field_node->kind == node_kinds::String)
                 {
                     for (const auto &sval_node : field_node->children)
                     {
-                        if (sval_node->key == "sval")
+                        if (sval_node->kind == node_kinds::sval)
                         {
                             fields.push_back(Common::Common::strip_quotes(sval_node->value));
                         }
                     }
                 }
-                else if (field_node->key == "A_Star")
+                else if (field_node->kind == node_kinds::A_Star)
                 {
                     // Handle the '*' wildcard
                     fields.push_back("*");
@@ -69,15 +70,15 @@ std::string Select_clause::extract_function(const std::shared_ptr<AbstractSyntax
 
     for (const auto &child : func_call_node->children)
     {
-        if (child->key == "funcname")
+        if (child->kind == node_kinds::funcname)
         {
             for (const auto &func_name_node : child->children)
             {
-                if (func_name_node->key == "String")
+                if (func_name_node->kind == node_kinds::String)
                 {
                     for (const auto &sval_node : func_name_node->children)
                     {
-                        if (sval_node->key == "sval")
+                        if (sval_node->kind == node_kinds::sval)
                         {
                             func_name = Common::strip_quotes(sval_node->value);
                         }
@@ -85,7 +86,7 @@ std::string Select_clause::extract_function(const std::shared_ptr<AbstractSyntax
                 }
             }
         }
-        else if (child->key == "args")
+        else if (child->kind == node_kinds::args)
         {
             for (const auto &arg_node : child->children)
             {
@@ -173,12 +174,12 @@ Select_clause::select_clause_info Select_clause::get_info(const std::shared_ptr<
         return info;
     }
 
-    if (node->key == "SelectStmt")
+    if (node->kind == node_kinds::SelectStmt)
     {
         // Check for DISTINCT
         for (const auto &child : node->children)
         {
-            if (child->key == "distinctClause")
+            if (child->kind == node_kinds::distinctClause)
             {
                 info.is_distinct = true;
                 break;
@@ -186,12 +187,12 @@ Select_clause::select_clause_info Select_clause::get_info(const std::shared_ptr<
         }
     }
 
-    if (node->key == "targetList")
+    if (node->kind == node_kinds::targetList)
     {
         // Process each ResTarget in the targetList
         for (const auto &res_target_node : node->children)
         {
-            if (res_target_node->key == "ResTarget")
+            if (res_target_node->kind == node_kinds::ResTarget)
             {
                 std::string alias;
                 std::shared_ptr<AbstractSyntaxTree::Node> val_node;
@@ -201,11 +202,11 @@ Select_clause::select_clause_info Select_clause::get_info(const std::shared_ptr<
                 // Extract 'name' (alias) and 'val'
                 for (const auto &child : res_target_node->children)
                 {
-                    if (child->key == "name")
+                    if (child->kind == node_kinds::name)
                     {
                         alias = Common::strip_quotes(child->value); // Assuming child->value holds the alias name
                     }
-                    else if (child->key == "val")
+                    else if (child->kind == node_kinds::val)
                     {
                         val_node = child; // Assign val_node directly to child
                     }
@@ -213,7 +214,7 @@ Select_clause::select_clause_info Select_clause::get_info(const std::shared_ptr<
 
                 if (val_node)
                 {
-                    if (val_node->children.front()->key == "ColumnRef")
+                    if (val_node->children.front()->kind == node_kinds::ColumnRef)
                     {
                         // It's a column
                         std::string column_name = extract_column_name(val_node->children.front(), from_info);
@@ -230,7 +231,7 @@ Select_clause::select_clause_info Select_clause::get_info(const std::shared_ptr<
                         }
                         info.columns.push_back(column_name);
                     }
-                    else if (val_node->children.front()->key == "FuncCall")
+                    else if (val_node->children.front()->kind == node_kinds::FuncCall)
                     {
                         // It's a function
                         std::string func_representation = extract_function(val_node->children.front(), from_info);
@@ -1,4 +1,5 @@
 #include "where_clause.h"
+#include "../node_kinds.h"
 #include "../common.h"
 #include "select_clause.h"
 #include <iostream>
@@ -11,9 +12,9 @@ std::string Where_clause::extract_constant(const std::shared_ptr<AbstractSyntaxT
     std::function<void(const std::shared_ptr<AbstractSyntaxTree::Node> &)> traverse;
     traverse = [&](const std::shared_ptr<AbstractSyntaxTree::Node> &node)
     {
-        if (node->key == "ival" || node->key == "sval" || node->key == "fval")
+        if (node->kind == node_kinds::ival || node->kind == node_kinds::sval || node->kind == node_kinds::fval)
         {
-            constant_value = (node->key == "sval") ? Common::strip_quotes(node->value) : Common::strip_quotes(node->value);
+            constant_value = (node->kind == node_kinds::sval) ? Common::strip_quotes(node->value) : Common::strip_quotes(node->value);
         }
         for (const auto &child : node->children)
         {
@@ -28,7 +29,7 @@ std::string Where_clause::extract_expression(const std::shared_ptr<AbstractSynta
 {
     if (!expr_node)
         return "(null)";
-    if (expr_node->key == "ColumnRef")
+    if (expr_node->kind == node_kinds::ColumnRef)
     {
         std::string column_name = Select_clause::extract_column_name(expr_node, from_info);
 
@@ -63,22 +64,22 @@ std::string Where_clause::extract_expression(const std::shared_ptr<AbstractSynta
         return column_name;
         // return select_extract_column_name(expr_node, from_info);
     }
-    else if (expr_node->key == "FuncCall")
+    else if (expr_node->kind == node_kinds::FuncCall)
     {
         return Select_clause::extract_function(expr_node, from_info);
     }
-    else if (expr_node->key == "A_Const")
+    else if (expr_node->kind == node_kinds::A_Const)
     {
         return Where_clause::extract_constant(expr_node);
     }
-    else if (expr_node->key == "A_Expr")
+    else if (expr_node->kind == node_kinds::A_Expr)
     {
         // Handle nested expressions
         std::string left = "(null)";
         std::string right = "(null)";
 
         // Get the lexpr node
-        auto lexpr_node = expr_node->get_child("lexpr");
+        auto lexpr_node = expr_node->get_child(node_kinds::lexpr);
         if (lexpr_node && !lexpr_node->children.empty())
         {
             // Process the child of lexpr
@@ -86,10 +87,10 @@ std::string Where_clause::extract_expression(const std::shared_ptr<AbstractSynta
         }
 
         // Get the operator
-        std::string op = extract_operator(expr_node->get_child("name"));
+        std::string op = extract_operator(expr_node->get_child(node_kinds::name));
 
         // Get the rexpr node
-        auto rexpr_node = expr_node->get_child("rexpr");
+        auto rexpr_node = expr_node->get_child(node_kinds::rexpr);
         if (rexpr_node && !rexpr_node->children.empty())
         {
             // Process the child of rexpr
@@ -98,36 +99,36 @@ std::string Where_clause::extract_expression(const std::shared_ptr<AbstractSynta
 
         return "(" + left + " " + op + " " + right + ")";
     }
-    else if (expr_node->key == "TypeCast")
+    else if (expr_node->kind == node_kinds::TypeCast)
     {
         // Handle type casting
-        std::string arg = extract_expression(expr_node->get_child("arg"), from_info, select_info);
-        auto type_name_node = expr_node->get_child("typeName");
+        std::string arg = extract_expression(expr_node->get_child(node_kinds::arg), from_info, select_info);
+        auto type_name_node = expr_node->get_child(node_kinds::typeName);
         std::string type_name;
         if (type_name_node)
         {
-            auto names_node = type_name_node->get_child("names");
+            auto names_node = type_name_node->get_child(node_kinds::names);
             if (names_node && !names_node->children.empty())
             {
                 auto last_name_node = names_node->children.back();
-                if (last_name_node->key == "String")
+                if (last_name_node->kind == node_kinds::String)
                 {
-                    type_name = Common::strip_quotes(last_name_node->get_child("sval")->value);
+                    type_name = Common::strip_quotes(last_name_node->get_child(node_kinds::sval)->value);
                 }
             }
         }
         return arg + "::" + type_name;
     }
-    else if (expr_node->key == "SubLink")
+    else if (expr_node->kind == node_kinds::SubLink)
     {
         // Handle subqueries
         return "(subquery)";
     }
-    else if (expr_node->key == "CollateClause")
+    else if (expr_node->kind == node_kinds::CollateClause)
     {
         // New code to handle collate expressions
-        std::string arg = extract_expression(expr_node->get_child("arg")->children.front(), from_info, select_info);
-        auto collate_node = expr_node->get_child("collname");
+        std::string arg = extract_expression(expr_node->get_child(node_kinds::arg)->children.front(), from_info, select_info);
+        auto collate_node = expr_node->get_child(node_kinds::collname);
         std::string collate_name;
         if (collate_node)
         {
@@ -135,9 +136,9 @@ std::string Where_clause::extract_expression(const std::shared_ptr<AbstractSynta
             std::vector<std::string> collate_parts;
             for (const auto &name_part : collate_node->children)
             {
-                if (name_part->key == "String")
+                if (name_part->kind == node_kinds::String)
                 {
-                    auto sval_node = name_part->get_child("sval");
+                    auto sval_node = name_part->get_child(node_kinds::sval);
                     if (sval_node)
                     {
                         collate_parts.push_back(Common::strip_quotes(sval_node->value));
@@ -149,13 +150,13 @@ std::string Where_clause::extract_expression(const std::shared_ptr<AbstractSynta
         }
         return arg + " COLLATE \"" + collate_name + "\"";
     }
-    else if (expr_node->key == "BoolExpr")
+    else if (expr_node->kind == node_kinds::BoolExpr)
     {
-        std::string boolop = expr_node->get_value("boolop");
+        std::string boolop = expr_node->get_value(node_kinds::boolop);
         std::string delim = (boolop == "AND_EXPR") ? " and " : " or ";
 
         std::vector<std::string> parts;
-        auto args_node = expr_node->get_child("args");
+        auto args_node = expr_node->get_child(node_kinds::args);
         if (args_node)
         {
             for (auto &arg : args_node->children)
@@ -187,11 +188,11 @@ std::string Where_clause::extract_operator(const std::shared_ptr<AbstractSyntaxT
         return "";
     for (const auto &child : name_node->children)
     {
-        if (child->key == "String")
+        if (child->kind == node_kinds::String)
         {
             for (const auto &sval_node : child->children)
             {
-                if (sval_node->key == "sval")
+                if (sval_node->kind == node_kinds::sval)
                 {
                     return Common::strip_quotes(sval_node->value);
                 }
@@ -219,16 +220,16 @@ std::shared_ptr<Where_clause::ConditionNode> Where_clause::extract_condition(con
     {
         return nullptr;
     }
-    if (expr_node->key == "A_Expr")
+    if (expr_node->kind == node_kinds::A_Expr)
     {
         // Handle expression operators
-        std::string kind = expr_node->get_value("kind");
+        std::string kind = expr_node->get_value(node_kinds::kind);
         if (kind == "AEXPR_OP")
         {
             // Handle simple comparison expressions (e.g., =, <, >)
-            auto lexpr_node = expr_node->get_child("lexpr");
-            auto name_node = expr_node->get_child("name");
-            auto rexpr_node = expr_node->get_child("rexpr");
+            auto lexpr_node = expr_node->get_child(node_kinds::lexpr);
+            auto name_node = expr_node->get_child(node_kinds::name);
+            auto rexpr_node = expr_node->get_child(node_kinds::rexpr);
 
             std::string left_operand = Where_clause::extract_expression(lexpr_node->children.front(), from_info, select_info);
             std::string operator_ = extract_operator(name_node);
@@ -239,10 +240,10 @@ std::shared_ptr<Where_clause::ConditionNode> Where_clause::extract_condition(con
         else if (kind == "AEXPR_IN")
         {
             // Handle IN expressions
-            std::string left_operand = Where_clause::extract_expression(expr_node->get_child("lexpr"), from_info, select_info);
-            auto rexpr_node = expr_node->get_child("rexpr");
+            std::string left_operand = Where_clause::extract_expression(expr_node->get_child(node_kinds::lexpr), from_info, select_info);
+            auto rexpr_node = expr_node->get_child(node_kinds::rexpr);
             std::string right_operand;
-            if (rexpr_node->key == "A_ArrayExpr" || rexpr_node->key == "List")
+            if (rexpr_node->kind == node_kinds::A_ArrayExpr || rexpr_node->kind == node_kinds::List)
             {
                 // Extract array elements
                 std::vector<std::string> elements;
@@ -261,23 +262,23 @@ std::shared_ptr<Where_clause::ConditionNode> Where_clause::extract_condition(con
         else if (kind == "AEXPR_LIKE")
         {
             // Handle LIKE expressions
-            std::string left_operand = Where_clause::extract_expression(expr_node->get_child("lexpr"), from_info, select_info);
-            std::string right_operand = Where_clause::extract_expression(expr_node->get_child("rexpr"), from_info, select_info);
+            std::string left_operand = Where_clause::extract_expression(expr_node->get_child(node_kinds::lexpr), from_info, select_info);
+            std::string right_operand = Where_clause::extract_expression(expr_node->get_child(node_kinds::rexpr), from_info, select_info);
             return std::make_shared<ConditionNode>(left_operand, "LIKE", right_operand);
         }
         else if (kind == "AEXPR_BETWEEN")
         {
             // Handle BETWEEN expressions
-            std::string left_operand = Where_clause::extract_expression(expr_node->get_child("lexpr"), from_info, select_info);
-            std::string lower_bound = Where_clause::extract_expression(expr_node->get_child("lower"), from_info, select_info);
-            std::string upper_bound = Where_clause::extract_expression(expr_node->get_child("upper"), from_info, select_info);
+            std::string left_operand = Where_clause::extract_expression(expr_node->get_child(node_kinds::lexpr), from_info, select_info);
+            std::string lower_bound = Where_clause::extract_expression(expr_node->get_child(node_kinds::lower), from_info, select_info);
+            std::string upper_bound = Where_clause::extract_expression(expr_node->get_child(node_kinds::upper), from_info, select_info);
             std::string right_operand = lower_bound + " AND " + upper_bound;
             return std::make_shared<ConditionNode>(left_operand, "BETWEEN", right_operand);
         }
         else if (kind == "AEXPR_NOT")
         {
             // Handle NOT expressions
-            auto rexpr_node = expr_node->get_child("rexpr");
+            auto rexpr_node = expr_node->get_child(node_kinds::rexpr);
             auto condition = extract_condition(rexpr_node, from_info, select_info);
             if (condition)
             {
@@ -287,10 +288,10 @@ std::shared_ptr<Where_clause::ConditionNode> Where_clause::extract_condition(con
         }
         // Handle other expression kinds if necessary
     }
-    else if (expr_node->key == "BoolExpr")
+    else if (expr_node->kind == node_kinds::BoolExpr)
     {
         // Handle boolean expressions (AND, OR, NOT)
-        std::string boolop = expr_node->get_value("boolop");
+        std::string boolop = expr_node->get_value(node_kinds::boolop);
         ConditionType cond_type;
         if (boolop == "AND_EXPR")
         {
@@ -310,7 +311,7 @@ std::shared_ptr<Where_clause::ConditionNode> Where_clause::extract_condition(con
         }
 
         std::vector<std::shared_ptr<ConditionNode>> cond_children;
-        auto args_node = expr_node->get_child("args");
+        auto args_node = expr_node->get_child(node_kinds::args);
         if (args_node)
         {
             for (const auto &arg_node : args_node->children)
@@ -324,12 +325,12 @@ std::shared_ptr<Where_clause::ConditionNode> Where_clause::extract_condition(con
         }
         return std::make_shared<ConditionNode>(cond_type, cond_children);
     }
-    else if (expr_node->key == "NullTest")
+    else if (expr_node->kind == node_kinds::NullTest)
     {
         // Handle IS NULL and IS NOT NULL
-        auto arg_node = expr_node->get_child("arg");
+        auto arg_node = expr_node->get_child(node_kinds::arg);
         std::string arg = Where_clause::extract_expression(arg_node, from_info, select_info);
-        std::string nulltesttype = expr_node->get_value("nulltesttype");
+        std::string nulltesttype = expr_node->get_value(node_kinds::nulltesttype);
         std::string operator_;
         if (nulltesttype == "IS_NULL")
         {
@@ -345,11 +346,11 @@ std::shared_ptr<Where_clause::ConditionNode> Where_clause::extract_condition(con
         }
         return std::make_shared<ConditionNode>(arg, operator_, "");
     }
-    else if (expr_node->key == "SubLink")
+    else if (expr_node->kind == node_kinds::SubLink)
     {
         // Handle subqueries
-        std::string sublink_type = expr_node->get_value("subLinkType");
-        auto subselect_node = expr_node->get_child("subselect");
+        std::string sublink_type = expr_node->get_value(node_kinds::subLinkType);
+        auto subselect_node = expr_node->get_child(node_kinds::subselect);
         std::string subquery = "(subquery)";
         std::string operator_;
         if (sublink_type == "EXISTS_SUBLINK")
@@ -360,15 +361,15 @@ std::shared_ptr<Where_clause::ConditionNode> Where_clause::extract_condition(con
         else if (sublink_type == "ANY_SUBLINK" || sublink_type == "ALL_SUBLINK")
         {
             // For ANY or ALL sublinks, there is a test expression and operator
-            std::string left_operand = Where_clause::extract_expression(expr_node->get_child("testexpr"), from_info, select_info);
-            std::string operator_name = extract_operator(expr_node->get_child("operName"));
+            std::string left_operand = Where_clause::extract_expression(expr_node->get_child(node_kinds::testexpr), from_info, select_info);
+            std::string operator_name = extract_operator(expr_node->get_child(node_kinds::operName));
             operator_ = operator_name + " " + (sublink_type == "ANY_SUBLINK" ? "ANY" : "ALL");
             return std::make_shared<ConditionNode>(left_operand, operator_, subquery);
         }
         else if (sublink_type == "EXPR_SUBLINK")
         {
             // Handle expressions that return a single value
-            std::string left_operand = Where_clause::extract_expression(expr_node->get_child("testexpr"), from_info, select_info);
+            std::string left_operand = Where_clause::extract_expression(expr_node->get_child(node_kinds::testexpr), from_info, select_info);
             operator_ = "="; // Assuming equality comparison
             return std::make_shared<ConditionNode>(left_operand, operator_, subquery);
         }
@@ -384,7 +385,7 @@ Where_clause::where_clause_info Where_clause::get_info(const std::shared_ptr<Abs
     {
         return info;
     }
-    if (node->key == "whereClause")
+    if (node->kind == node_kinds::whereClause)
     {
         info.condition_root = extract_condition(node->children.front(), from_info, select_info);
     }
@@ -541,7 +542,14 @@ bool Where_clause::compare_condition_nodes(const std::shared_ptr<Where_clause::C
             return false;
         }
 
-        // Generate signatures for each child and compare sets
+        // The hashes combine the children independently of their order, equal hashes are confirmed with the
+        // signatures, which are only compared then, so a collision does not pass a wrong condition
+        if (node1->hash == node2->hash && generate_condition_signature(node1) == generate_condition_signature(node2))
+        {
+            return true;
+        }
+
+        // Generate signatures for each child only to describe the mismatch
         std::vector<std::string> node1_child_signatures;
         std::vector<std::string> node2_child_signatures;
 
@@ -593,42 +601,45 @@ bool Where_clause::operators_commutative(const std::string &op)
     return op == "=" || op == "<>" || op == "!=";
 }
 
+// Helper function to bring a simple condition into its canonical form
+void Where_clause::canonical_simple_condition(const Where_clause::ConditionNode &node, std::string &left, std::string &op, std::string &right)
+{
+    op = node.operator_;
+    left = node.left_operand;
+    right = node.right_operand;
+
+    if ((op == "<" || op == ">" ||
+         op == "<=" || op == ">=") &&
+        !left.empty() && !right.empty()
+        // left looks like a literal (digit or quote) and right like an identifier
+        && (std::isdigit(left.front()) || left.front() == '\'') && (std::isalpha(right.front()) || right.front() == '_'))
+    {
+        std::swap(left, right);
+        if (op == "<")
+            op = ">";
+        else if (op == ">")
+            op = "<";
+        else if (op == "<=")
+            op = ">=";
+        else if (op == ">=")
+            op = "<=";
+    }
+    if (operators_commutative(op))
+    {
+        // For commutative operators, sort the operands
+        if (left > right)
+            std::swap(left, right);
+    }
+}
+
 // Helper function to generate a normalized signature of a condition node
 std::string Where_clause::generate_condition_signature(const std::shared_ptr<Where_clause::ConditionNode> &node)
 {
     if (node->type == Where_clause::ConditionType::SIMPLE)
     {
-        std::string op = node->operator_;
-        std::string left = node->left_operand;
-        std::string right = node->right_operand;
-
-        if ((op == "<" || op == ">" ||
-             op == "<=" || op == ">=") &&
-            !left.empty() && !right.empty()
-            // left looks like a literal (digit or quote) and right like an identifier
-            && (std::isdigit(left.front()) || left.front() == '\'') && (std::isalpha(right.front()) || right.front() == '_'))
-        {
-            std::swap(left, right);
-            if (op == "<")
-                op = ">";
-            else if (op == ">")
-                op = "<";
-            else if (op == "<=")
-                op = ">=";
-            else if (op == ">=")
-                op = "<=";
-        }
-        if (operators_commutative(op))
-        {
-            // For commutative operators, sort the operands
-            if (left > right)
-                std::swap(left, right);
-            return "SIMPLE:" + left + op + right;
-        }
-        else
-        {
-            return "SIMPLE:" + left + op + right;
-        }
+        std::string left, op, right;
+        canonical_simple_condition(*node, left, op, right);
+        return "SIMPLE:" + left + op + right;
     }
     else if (node->type == Where_clause::ConditionType::AND || node->type == Where_clause::ConditionType::OR)
     {
@@ -661,6 +672,57 @@ std::string Where_clause::generate_condition_signature(const std::shared_ptr<Whe
     }
     return "";
 }
+// Helper function to compute the canonical hash of a condition node
+std::uint64_t Where_clause::compute_condition_hash(const Where_clause::ConditionNode &node)
+{
+    // splitmix64 finalizer, spreads the bits of a value over the whole word
+    auto mix = [](std::uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    };
+    // order-dependent combination of two hashes
+    auto combine = [&](std::uint64_t seed, std::uint64_t value)
+    {
+        return mix(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+    };
+    // FNV-1a over the characters of a string
+    auto hash_string = [](const std::string &str)
+    {
+        std::uint64_t h = 0xcbf29ce484222325ULL;
+        for (unsigned char ch : str)
+        {
+            h ^= ch;
+            h *= 0x100000001b3ULL;
+        }
+        return h;
+    };
+
+    std::uint64_t seed = mix(static_cast<std::uint64_t>(node.type) + 1);
+    if (node.type == Where_clause::ConditionType::SIMPLE)
+    {
+        std::string left, op, right;
+        canonical_simple_condition(node, left, op, right);
+        return combine(combine(combine(seed, hash_string(left)), hash_string(op)), hash_string(right));
+    }
+    else if (node.type == Where_clause::ConditionType::AND || node.type == Where_clause::ConditionType::OR)
+    {
+        // a sum of mixed child hashes does not depend on the order of the children, and keeps duplicates apart
+        std::uint64_t children_sum = 0;
+        for (const auto &child : node.children)
+        {
+            children_sum += mix(child->hash);
+        }
+        return combine(combine(seed, node.children.size()), children_sum);
+    }
+    else if (node.type == Where_clause::ConditionType::NOT)
+    {
+        return node.children.empty() ? seed : combine(seed, node.children[0]->hash);
+    }
+    return seed;
+}
 std::string Where_clause::condition_type_to_string(Where_clause::ConditionType type)
 {
     switch (type)
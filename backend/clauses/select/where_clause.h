@@ -2,6 +2,7 @@
 #define WHERE_CLAUSE_H
 
 #include <string>
+#include <cstdint>
 #include "../../abstract_syntax_tree.h"
 #include "select_clause.h"
 #include "from_clause.h"
@@ -27,14 +28,17 @@ public:
         std::string right_operand;
         // For AND, OR, NOT types
         std::vector<std::shared_ptr<ConditionNode>> children;
+        // Canonical hash of the condition, computed bottom-up when the node is created.
+        // Two conditions with the same signature (see generate_condition_signature) have the same hash.
+        std::uint64_t hash;
 
         // Constructor for simple conditions
         ConditionNode(const std::string &left, const std::string &op, const std::string &right)
-            : type(ConditionType::SIMPLE), left_operand(left), operator_(op), right_operand(right) {}
+            : type(ConditionType::SIMPLE), left_operand(left), operator_(op), right_operand(right), hash(compute_condition_hash(*this)) {}
 
         // Constructor for compound conditions (AND, OR, NOT)
         ConditionNode(ConditionType t, const std::vector<std::shared_ptr<ConditionNode>> &child_nodes)
-            : type(t), left_operand(""), operator_(""), right_operand(""), children(child_nodes) {}
+            : type(t), left_operand(""), operator_(""), right_operand(""), children(child_nodes), hash(compute_condition_hash(*this)) {}
     };
     struct where_clause_info
     {
@@ -132,6 +136,13 @@ public:
      * @return: A string containing the normalized signature of the condition node
      */
     static std::string generate_condition_signature(const std::shared_ptr<Where_clause::ConditionNode> &node);
+    /**
+     * This function computes the canonical hash of a condition node from its operands and its children's hashes.
+     * AND/OR children and the operands of commutative operators are combined independently of their order.
+     * @param node: The condition node. Its children must already have their hashes.
+     * @return: The 64-bit hash of the condition.
+     */
+    static std::uint64_t compute_condition_hash(const Where_clause::ConditionNode &node);
 
 private:
     static std::string condition_type_to_string(Where_clause::ConditionType type);
@@ -142,6 +153,15 @@ private:
      * @return: A boolean value indicating whether the operator is commutative
      */
     static bool operators_commutative(const std::string &op);
+    /**
+     * This function brings a simple condition into its canonical form:
+     * a literal on the left of <, >, <= or >= is moved to the right, and the operands of a commutative operator are sorted.
+     * @param node: The simple condition node.
+     * @param left: Set to the canonical left operand.
+     * @param op: Set to the canonical operator.
+     * @param right: Set to the canonical right operand.
+     */
+    static void canonical_simple_condition(const Where_clause::ConditionNode &node, std::string &left, std::string &op, std::string &right);
 };
 
 #endif // WHERE_CLAUSE_H
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include "database_cache.h"
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include "dataset_store.h"
+#include "script_loader.h"
+
+DatabaseCache::entry::entry(duckdb::DBConfig &config)
+    : db(nullptr, &config)
+{
+}
+
+DatabaseCache::DatabaseCache(std::size_t budget)
+    : budget(budget)
+{
+}
+
+DatabaseCache &DatabaseCache::shared()
+{
+    static DatabaseCache cache;
+    return cache;
+}
+
+std::shared_ptr<DatabaseCache::entry> DatabaseCache::find_or_load(const std::string &script, const std::vector<Admin::dataset_table> &tables, const std::string &script_sha256)
+{
+    const key script_key = {script_sha256.empty() ? DatasetStore::sha256(script) : script_sha256, describe(tables)};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = slots.find(script_key);
+        if (it != slots.end() && it->second.script == script)
+        {
+            hits++;
+            recently_used.splice(recently_used.begin(), recently_used, it->second.recent);
+            return it->second.database;
+        }
+        misses++;
+    }
+    resource_policy current = policy();
+
+    // the script runs without the lock, if two requests miss the same script the database cached first is kept
+    std::shared_ptr<entry> database = load(script, tables, current);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto [it, inserted] = slots.try_emplace(script_key);
+    if (!inserted && it->second.script == script)
+    {
+        return it->second.database;
+    }
+    if (!inserted)
+    {
+        // another script with the same SHA-256 is not cached, its database is only used by this request
+        return database;
+    }
+    recently_used.push_front(script_key);
+    // the copy of the script is kept as long as the database, a large script counts against the budget as well
+    it->second = {database, script, recently_used.begin(), database->bytes + script.size()};
+    bytes += it->second.bytes;
+    evict(script_key);
+    return database;
+}
+
+std::shared_ptr<DatabaseCache::entry> DatabaseCache::load(const std::string &script, const std::vector<Admin::dataset_table> &tables, const resource_policy &resources)
+{
+    duckdb::DBConfig config;
+    config.SetOptionByName("threads", duckdb::Value::BIGINT(static_cast<int64_t>(resources.parallel_threads)));
+    if (!resources.memory_limit.empty())
+    {
+        config.SetOptionByName("memory_limit", duckdb::Value(resources.memory_limit));
+    }
+    if (!resources.temp_directory.empty())
+    {
+        config.SetOptionByName("temp_directory", duckdb::Value(resources.temp_directory));
+    }
+    auto database = std::make_shared<entry>(config);
+    duckdb::Connection con(database->db);
+    ScriptLoader::run(con, script);
+    ScriptLoader::load_tables(con, tables);
+    // the memory DuckDB reports for the tables, or the script itself if it reports none
+    auto memory = con.Query("SELECT SUM(memory_usage_bytes) FROM duckdb_memory();");
+    if (!memory->HasError() && memory->RowCount() > 0 && !memory->GetValue(0, 0).IsNull())
+    {
+        database->bytes = static_cast<std::size_t>(memory->GetValue(0, 0).GetValue<int64_t>());
+    }
+    if (database->bytes == 0)
+    {
+        database->bytes = script.size();
+    }
+    // the parallel threads are only for the load, the graded queries of many gradings run at once
+    database->threads = resources.threads;
+    auto threads = con.Query("SET threads = " + std::to_string(database->threads) + ";");
+    if (threads->HasError())
+    {
+        throw std::runtime_error(threads->GetError());
+    }
+    // the graded queries of every request run on the database, they read no files and change no settings
+    for (const std::string setting : {"SET enable_external_access = false;", "SET lock_configuration = true;"})
+    {
+        auto locked = con.Query(setting);
+        if (locked->HasError())
+        {
+            throw std::runtime_error(locked->GetError());
+        }
+    }
+    return database;
+}
+
+std::string DatabaseCache::describe(const std::vector<Admin::dataset_table> &tables)
+{
+    std::string description;
+    for (const auto &table : tables)
+    {
+        std::error_code size_error, time_error;
+        auto size = std::filesystem::file_size(table.path, size_error);
+        auto modified = std::filesystem::last_write_time(table.path, time_error);
+        description += table.name + '\0' + table.path + '\0' + (table.format == Admin::dataset_format::PARQUET ? "parquet" : "csv") + '\0';
+        description += size_error || time_error ? "missing" : std::to_string(size) + ':' + std::to_string(modified.time_since_epoch().count());
+        description += '\n';
+    }
+    return description;
+}
+
+void DatabaseCache::evict(const key &keep)
+{
+    auto it = recently_used.end();
+    while (bytes > budget && it != recently_used.begin())
+    {
+        --it;
+        if (*it == keep)
+        {
+            continue;
+        }
+        auto evicted = slots.find(*it);
+        bytes -= evicted->second.bytes;
+        slots.erase(evicted);
+        it = recently_used.erase(it);
+        evictions++;
+    }
+}
+
+void DatabaseCache::set_budget(std::size_t budget)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->budget = budget;
+    evict({});
+}
+
+void DatabaseCache::set_policy(const resource_policy &resources)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->resources = resources;
+    this->resources.threads = std::max<std::size_t>(resources.threads, 1);
+    this->resources.parallel_threads = std::max<std::size_t>(resources.parallel_threads, 1);
+}
+
+DatabaseCache::resource_policy DatabaseCache::policy() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return resources;
+}
+
+void DatabaseCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    evictions += slots.size();
+    slots.clear();
+    recently_used.clear();
+    bytes = 0;
+}
+
+DatabaseCache::stats DatabaseCache::statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return {hits, misses, evictions, slots.size(), bytes, budget};
+}
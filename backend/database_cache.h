@@ -0,0 +1,168 @@
+/**
+ * @file database_cache.h
+ * @brief This file contains the declaration of the DatabaseCache class.
+ * The class keeps the DuckDB databases made from the scripts of the quizzes, so that a script that was already run is
+ * not run again for the next request: instructors reuse the same datasets all term. A database is found by the SHA-256
+ * of its script, and the script of a found database is compared as well, so a database is never served for another
+ * script. The queries that are graded run in transactions that are rolled back and the statements that would outlive
+ * the transaction are refused, see MyDuckDB, so the engines of any number of requests use a cached database at the
+ * same time. Once it is loaded, a database can no longer read files or change its configuration.
+ * The cached databases are evicted, the least recently used first, when their memory is over a budget.
+ * A script is run with the ScriptLoader, which appends its INSERT statements instead of running each of them.
+ * The tables of a dataset that come as files are part of the key with the size and the modification time of each file,
+ * so a file that is replaced is loaded again.
+ * DuckDB gives each database all the cores and most of the memory by default, while the gradings already run on thread
+ * pools of their own and are admitted against a budget of cores, see GradingScheduler. The databases are made with the
+ * threads, the memory limit and the spill directory of a resource policy instead.
+ *
+ * @author Benard Wanjiru
+ * Contact: benard.wanjiru@ru.nl
+ */
+#ifndef DATABASE_CACHE_H
+#define DATABASE_CACHE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "admin.h"
+#include "duckdb/duckdb.hpp"
+
+class DatabaseCache
+{
+public:
+    /**
+     * A database made from a script.
+     */
+    struct entry
+    {
+        /**
+         * @param config: the options of the database, see resource_policy.
+         */
+        explicit entry(duckdb::DBConfig &config);
+        duckdb::DuckDB db;
+        /**
+         * Read-only statements hold it shared, the others hold it alone. Two rolled back transactions that write to
+         * the same table would otherwise fail each other with a conflict.
+         */
+        std::shared_mutex statements;
+        std::size_t bytes = 0;   /**< The memory of the database when it was made. */
+        std::size_t threads = 1; /**< The threads DuckDB runs the graded queries on the database with. */
+    };
+    /**
+     * The resources of the databases. DuckDB sets the threads for a whole database, not for a query, and the graded
+     * queries of a database run on the threads of many gradings at once, so each of them runs on the threads of the
+     * policy and the gradings stay within their share of the budget. Only the script is loaded in parallel, before
+     * the database is shared.
+     */
+    struct resource_policy
+    {
+        std::size_t threads = 1;                                                          /**< The threads of the graded queries. */
+        std::size_t parallel_threads = std::max(std::thread::hardware_concurrency(), 1u); /**< The threads a script is loaded with. */
+        std::string memory_limit;                                                         /**< The memory_limit of DuckDB, for instance "2GB", empty for its default. */
+        std::string temp_directory;                                                       /**< Where DuckDB spills what does not fit the memory limit, empty for its default. */
+    };
+    /**
+     * The counters of the cache.
+     */
+    struct stats
+    {
+        std::size_t hits;
+        std::size_t misses;
+        std::size_t evictions;
+        std::size_t entries;
+        std::size_t bytes;  /**< The memory of the cached databases and of their scripts. */
+        std::size_t budget; /**< The memory the cached databases can use. */
+    };
+    /**
+     * The memory the cached databases can use, in bytes.
+     */
+    static constexpr std::size_t default_budget = std::size_t(512) << 20;
+    /**
+     * @param budget: the memory the cached databases can use, in bytes.
+     */
+    explicit DatabaseCache(std::size_t budget = default_budget);
+    /**
+     * This function returns the cache the query engines use.
+     */
+    static DatabaseCache &shared();
+    /**
+     * This function returns the database of a script, and runs the script on a new database if it is not cached.
+     * A database that is evicted stays alive until the last engine that uses it is gone.
+     * @param script: the statements that create and fill the tables.
+     * @param tables: the tables loaded from files after the script, see ScriptLoader::load_tables.
+     * @param script_sha256: the SHA-256 of the script if the caller has it, see DatasetStore, it is computed otherwise.
+     * @return: the database.
+     * @throws std::runtime_error if the script or a file fails, nothing is cached then.
+     */
+    std::shared_ptr<entry> find_or_load(const std::string &script, const std::vector<Admin::dataset_table> &tables = {}, const std::string &script_sha256 = "");
+    /**
+     * This function sets the memory the cached databases can use, and evicts databases until they fit.
+     * @param budget: the memory in bytes.
+     */
+    void set_budget(std::size_t budget);
+    /**
+     * This function sets the resources of the databases that are made from now on.
+     * @param resources: the resources, threads of 0 count as 1.
+     */
+    void set_policy(const resource_policy &resources);
+    /**
+     * This function returns the resources of the databases, see set_policy.
+     */
+    resource_policy policy() const;
+    /**
+     * This function evicts every database.
+     */
+    void clear();
+    /**
+     * This function returns the counters of the cache.
+     */
+    stats statistics() const;
+
+private:
+    /**
+     * A script is identified by its SHA-256, together with the description of the files of its tables.
+     */
+    using key = std::pair<std::string, std::string>;
+    struct slot
+    {
+        std::shared_ptr<entry> database;
+        std::string script; /**< The script of the database, compared on a hit. */
+        std::list<key>::iterator recent; /**< The place of the database in the recently used list. */
+        std::size_t bytes = 0; /**< The memory of the database and of the copy of its script. */
+    };
+    /**
+     * This function runs a script on a new database with the parallel threads, measures its memory and then sets the
+     * threads of the graded queries.
+     */
+    static std::shared_ptr<entry> load(const std::string &script, const std::vector<Admin::dataset_table> &tables, const resource_policy &resources);
+    /**
+     * This function describes the files of the tables of a dataset: their tables, paths, formats, sizes and
+     * modification times. A file that cannot be read is described as missing, the load reports it.
+     */
+    static std::string describe(const std::vector<Admin::dataset_table> &tables);
+    /**
+     * This function evicts the least recently used databases, except keep, until the databases fit the budget.
+     * The caller holds the mutex.
+     */
+    void evict(const key &keep);
+
+    mutable std::mutex mutex;
+    std::size_t budget;
+    resource_policy resources;
+    std::size_t bytes = 0;
+    std::map<key, slot> slots;
+    std::list<key> recently_used; /**< The most recently used first. */
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+};
+
+#endif // DATABASE_CACHE_H
@@ -0,0 +1,145 @@
+#include "dataset_store.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <openssl/evp.h>
+
+DatasetStore::reference::~reference()
+{
+    store.release(hash);
+}
+
+DatasetStore::DatasetStore(std::filesystem::path directory)
+    : directory(std::move(directory))
+{
+    std::filesystem::create_directories(this->directory);
+}
+
+std::string DatasetStore::sha256(const std::string &content)
+{
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    if (EVP_Digest(content.data(), content.size(), digest, &length, EVP_sha256(), nullptr) != 1)
+    {
+        throw std::runtime_error("The SHA-256 of the dataset could not be computed");
+    }
+    static const char hex[] = "0123456789abcdef";
+    std::string hash;
+    for (unsigned int i = 0; i < length; i++)
+    {
+        hash += hex[digest[i] >> 4];
+        hash += hex[digest[i] & 0xf];
+    }
+    return hash;
+}
+
+bool DatasetStore::is_hash(const std::string &text)
+{
+    if (text.size() != 64)
+    {
+        return false;
+    }
+    for (char c : text)
+    {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::filesystem::path DatasetStore::file(const std::string &hash) const
+{
+    return directory / hash;
+}
+
+bool DatasetStore::put(const std::string &hash, const std::string &content)
+{
+    if (!is_hash(hash) || sha256(content) != hash)
+    {
+        throw std::invalid_argument("The dataset is not named by the SHA-256 of its content");
+    }
+    if (contains(hash))
+    {
+        return false;
+    }
+    // the upload is written to a file of its own and renamed, so a dataset is never read half written
+    std::filesystem::path upload = directory / (hash + ".upload" + std::to_string(uploads++));
+    {
+        std::ofstream output(upload, std::ios::binary);
+        output.write(content.data(), static_cast<std::streamsize>(content.size()));
+        if (!output)
+        {
+            std::error_code error;
+            std::filesystem::remove(upload, error);
+            throw std::runtime_error("The dataset " + hash + " could not be written");
+        }
+    }
+    std::filesystem::rename(upload, file(hash));
+    return true;
+}
+
+bool DatasetStore::contains(const std::string &hash) const
+{
+    std::error_code error;
+    return is_hash(hash) && std::filesystem::is_regular_file(file(hash), error);
+}
+
+std::shared_ptr<const DatasetStore::reference> DatasetStore::acquire(const std::string &hash, bool read)
+{
+    // the dataset is read under the lock, so it cannot be removed between the read and the reference
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!contains(hash))
+    {
+        return nullptr;
+    }
+    held &dataset = datasets[hash];
+    if (read && !dataset.content)
+    {
+        std::ifstream input(file(hash), std::ios::binary);
+        std::stringstream buffer;
+        buffer << input.rdbuf();
+        if (!input)
+        {
+            if (dataset.references == 0)
+            {
+                datasets.erase(hash);
+            }
+            return nullptr;
+        }
+        dataset.content = std::make_shared<const std::string>(buffer.str());
+    }
+    dataset.references++;
+    return std::shared_ptr<const reference>(new reference{*this, hash, file(hash), read ? dataset.content : nullptr});
+}
+
+void DatasetStore::release(const std::string &hash)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = datasets.find(hash);
+    if (it != datasets.end() && --it->second.references == 0)
+    {
+        datasets.erase(it);
+    }
+}
+
+std::size_t DatasetStore::references(const std::string &hash) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = datasets.find(hash);
+    return it == datasets.end() ? 0 : it->second.references;
+}
+
+DatasetStore::removal DatasetStore::remove(const std::string &hash)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (datasets.count(hash) > 0)
+    {
+        return removal::REFERENCED;
+    }
+    std::error_code error;
+    return is_hash(hash) && std::filesystem::remove(file(hash), error) ? removal::REMOVED : removal::UNKNOWN;
+}
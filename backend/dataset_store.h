@@ -0,0 +1,113 @@
+/**
+ * @file dataset_store.h
+ * @brief This file contains the declaration of the DatasetStore class.
+ * The class keeps the scripts of the quiz databases and the Parquet and CSV files of their tables on disk, each in a
+ * file named by the SHA-256 of its content. A client uploads a dataset once and sends its hash with each request
+ * instead of the script or the file, so the requests of a quiz carry only the queries. A dataset is referenced by the
+ * quizzes and the gradings that use it, and is only removed when it is not referenced. A script is read once while it
+ * is referenced, the references share its content.
+ *
+ * @author Benard Wanjiru
+ * Contact: benard.wanjiru@ru.nl
+ */
+#ifndef DATASET_STORE_H
+#define DATASET_STORE_H
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class DatasetStore
+{
+public:
+    /**
+     * A dataset that is in use. The dataset cannot be removed until the last reference is gone.
+     */
+    struct reference
+    {
+        DatasetStore &store;
+        const std::string hash;
+        const std::filesystem::path path;                  /**< The file of the dataset. */
+        const std::shared_ptr<const std::string> content; /**< The content of the dataset, null if it was not read, see acquire. */
+        ~reference();
+    };
+    enum class removal
+    {
+        REMOVED,
+        UNKNOWN,
+        REFERENCED
+    };
+    /**
+     * @param directory: the directory the datasets are kept in, it is created if it does not exist.
+     */
+    explicit DatasetStore(std::filesystem::path directory);
+    DatasetStore(const DatasetStore &) = delete;
+    DatasetStore &operator=(const DatasetStore &) = delete;
+    /**
+     * This function returns the SHA-256 of a text in lowercase hexadecimal.
+     */
+    static std::string sha256(const std::string &content);
+    /**
+     * This function checks that a text is a SHA-256 in lowercase hexadecimal.
+     */
+    static bool is_hash(const std::string &text);
+    /**
+     * This function stores a dataset. A dataset that is already stored is left as it is.
+     * @param hash: the SHA-256 of the content.
+     * @param content: the script of the dataset, or the Parquet or CSV file of a table.
+     * @return: true if the dataset was stored, false if it was already stored.
+     * @throws std::invalid_argument if the hash is not the SHA-256 of the content.
+     * @throws std::runtime_error if the dataset cannot be written.
+     */
+    bool put(const std::string &hash, const std::string &content);
+    /**
+     * This function checks that a dataset is stored.
+     */
+    bool contains(const std::string &hash) const;
+    /**
+     * This function references a dataset, and reads it unless it is referenced with its content already.
+     * @param hash: the SHA-256 of the dataset.
+     * @param read: false for a file of a table, which DuckDB reads from its path.
+     * @return: the reference, null if the dataset is not stored.
+     */
+    std::shared_ptr<const reference> acquire(const std::string &hash, bool read = true);
+    /**
+     * This function returns the number of references to a dataset.
+     */
+    std::size_t references(const std::string &hash) const;
+    /**
+     * This function removes a dataset that is not referenced.
+     * @param hash: the SHA-256 of the dataset.
+     * @return: REMOVED, UNKNOWN if the dataset is not stored or REFERENCED if it is in use.
+     */
+    removal remove(const std::string &hash);
+
+private:
+    /**
+     * A dataset that is referenced.
+     */
+    struct held
+    {
+        std::size_t references = 0;
+        std::shared_ptr<const std::string> content; /**< Shared by the references that read it. */
+    };
+    /**
+     * This function returns the file of a dataset.
+     */
+    std::filesystem::path file(const std::string &hash) const;
+    /**
+     * This function drops a reference, see reference.
+     */
+    void release(const std::string &hash);
+
+    const std::filesystem::path directory;
+    mutable std::mutex mutex;
+    std::map<std::string, held> datasets; /**< The datasets in use. */
+    std::atomic<std::size_t> uploads = 0; /**< Names the files of the uploads that are written. */
+};
+
+#endif // DATASET_STORE_H
@@ -0,0 +1,153 @@
+#include "distance_matrix.h"
+#include <algorithm>
+#include <functional>
+#include "pq_gram.h"
+#include "utils.h"
+
+namespace
+{
+    // the labels of the nodes of a tree as a sorted bag of hashes, see PqGram::shared_grams
+    PqGram::profile label_bag(const std::shared_ptr<AbstractSyntaxTree::Node> &tree)
+    {
+        PqGram::profile labels;
+        std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> pending = {tree};
+        while (!pending.empty())
+        {
+            auto node = pending.back();
+            pending.pop_back();
+            labels.push_back(std::hash<std::string>{}(node->key + '\0' + node->value));
+            pending.insert(pending.end(), node->children.begin(), node->children.end());
+        }
+        std::sort(labels.begin(), labels.end());
+        return labels;
+    }
+
+    // a pair of queries found close by a tile, seen from the first query
+    struct close_pair
+    {
+        std::size_t position1;
+        DistanceMatrix::entry entry;
+    };
+}
+
+void DistanceMatrix::compute(const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> &trees, const std::vector<std::string> &texts,
+                             int max_tree_distance, int max_text_distance, TreeEditDistance::algorithm tree_algorithm, ThreadPool &pool,
+                             std::size_t tile_size)
+{
+    if (computed)
+    {
+        return;
+    }
+    computed = true;
+    const std::size_t count = trees.size();
+    rows.assign(count, {});
+    tile_size = std::max<std::size_t>(tile_size, 1);
+
+    // the label bags are shared by all the tiles
+    std::vector<PqGram::profile> labels(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (trees[i])
+        {
+            labels[i] = label_bag(trees[i]);
+        }
+    }
+
+    // each tile above the diagonal writes to its own result, so the tiles need no lock
+    const std::size_t tiles_per_side = (count + tile_size - 1) / tile_size;
+    std::vector<std::vector<close_pair>> tile_results(tiles_per_side * (tiles_per_side + 1) / 2);
+    std::size_t tile = 0;
+    for (std::size_t tile_row = 0; tile_row < tiles_per_side; tile_row++)
+    {
+        for (std::size_t tile_column = tile_row; tile_column < tiles_per_side; tile_column++, tile++)
+        {
+            pool.enqueue([&, tile_row, tile_column, tile]()
+                         {
+                TreeEditDistance ted;
+                Utils utils;
+                std::vector<close_pair> &result = tile_results[tile];
+                std::size_t row_end = std::min(count, (tile_row + 1) * tile_size);
+                std::size_t column_end = std::min(count, (tile_column + 1) * tile_size);
+                for (std::size_t i = tile_row * tile_size; i < row_end; i++)
+                {
+                    if (!trees[i])
+                    {
+                        continue;
+                    }
+                    for (std::size_t j = std::max(i + 1, tile_column * tile_size); j < column_end; j++)
+                    {
+                        if (!trees[j])
+                        {
+                            continue;
+                        }
+                        bool same_text = texts[i] == texts[j];
+                        // every node of the larger tree without an equal label in the other tree costs at least one edit
+                        std::size_t unmatched = std::max(labels[i].size(), labels[j].size()) - PqGram::shared_grams(labels[i], labels[j]);
+                        if (!same_text && unmatched > static_cast<std::size_t>(std::max(0, max_tree_distance)))
+                        {
+                            pruned_pairs++;
+                            continue;
+                        }
+                        tree_evaluations++;
+                        int tree_distance = ted.distance(trees[i], trees[j], tree_algorithm);
+                        if (!same_text && tree_distance > max_tree_distance)
+                        {
+                            continue;
+                        }
+                        int text_distance = same_text ? 0 : static_cast<int>(utils.bounded_edit_distance(texts[i], texts[j], std::max(0, max_text_distance)));
+                        result.push_back({i, {j, tree_distance, text_distance}});
+                    }
+                } });
+        }
+    }
+    pool.wait_until_empty();
+
+    // mirror the pairs below the diagonal
+    for (const auto &result : tile_results)
+    {
+        for (const auto &pair : result)
+        {
+            rows[pair.position1].push_back(pair.entry);
+            rows[pair.entry.position].push_back({pair.position1, pair.entry.tree_distance, pair.entry.text_distance});
+        }
+    }
+    for (auto &row : rows)
+    {
+        std::sort(row.begin(), row.end(), [](const entry &a, const entry &b)
+                  { return a.position < b.position; });
+    }
+}
+
+bool DistanceMatrix::is_computed() const
+{
+    return computed;
+}
+
+const std::vector<DistanceMatrix::entry> &DistanceMatrix::neighbours(std::size_t position) const
+{
+    static const std::vector<entry> empty;
+    return position < rows.size() ? rows[position] : empty;
+}
+
+bool DistanceMatrix::find(std::size_t position1, std::size_t position2, entry &result) const
+{
+    const std::vector<entry> &row = neighbours(position1);
+    auto it = std::lower_bound(row.begin(), row.end(), position2, [](const entry &e, std::size_t position)
+                               { return e.position < position; });
+    if (it == row.end() || it->position != position2)
+    {
+        return false;
+    }
+    result = *it;
+    return true;
+}
+
+std::size_t DistanceMatrix::evaluations() const
+{
+    return tree_evaluations.load();
+}
+
+std::size_t DistanceMatrix::pruned() const
+{
+    return pruned_pairs.load();
+}
@@ -0,0 +1,89 @@
+/**
+ * @file distance_matrix.h
+ * @brief This file contains the declaration of the DistanceMatrix class.
+ * The class computes the tree edit distances and the text edit distances between all pairs of queries of a cohort once,
+ * so that semantics analysis, and any later stage that needs pairwise similarity, looks them up instead of computing
+ * them again for every query. The matrix is symmetric, so only the pairs above the diagonal are computed, in square
+ * tiles that run as separate tasks of a thread pool. Only the pairs within the thresholds are kept.
+ * A pair is skipped without computing its tree edit distance when a lower bound, the number of nodes that cannot be
+ * matched because their labels differ, is already above the threshold.
+ *
+ * @author Benard Wanjiru
+ * Contact: benard.wanjiru@ru.nl
+ */
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "abstract_syntax_tree.h"
+#include "tree_edit_distance.h"
+#include "thread_pool.h"
+
+class DistanceMatrix
+{
+public:
+    /**
+     * A query that is close to another query.
+     */
+    struct entry
+    {
+        std::size_t position; /**< The position of the close query. */
+        int tree_distance;    /**< The tree edit distance between the parse trees, it can exceed the maximum if the texts are equal. */
+        int text_distance;    /**< The edit distance between the texts, the maximum text distance + 1 if it exceeds it. */
+    };
+    /**
+     * The number of queries on each side of a tile.
+     */
+    static constexpr std::size_t default_tile_size = 32;
+    /**
+     * This function computes the close pairs of a cohort. It does nothing if the matrix has already been computed.
+     * @param trees: the parse trees of the queries, null for queries that are not parseable. These get no pairs.
+     * @param texts: the preprocessed texts of the queries, see ModelQuery::get_preprocessed_value.
+     * @param max_tree_distance: the largest tree edit distance of a kept pair.
+     * @param max_text_distance: the largest text edit distance that is computed exactly.
+     * @param tree_algorithm: the algorithm used to compute the tree edit distances.
+     * @param pool: the thread pool the tiles run on. The function waits for the pool to be empty.
+     * @param tile_size: the number of queries on each side of a tile.
+     */
+    void compute(const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> &trees, const std::vector<std::string> &texts,
+                 int max_tree_distance, int max_text_distance, TreeEditDistance::algorithm tree_algorithm, ThreadPool &pool,
+                 std::size_t tile_size = default_tile_size);
+    /**
+     * This function returns whether compute has been called.
+     */
+    bool is_computed() const;
+    /**
+     * This function returns the queries that are close to a query: those within the maximum tree edit distance and
+     * those with the same text.
+     * @param position: the position of the query.
+     * @return: the close queries in increasing order of position, empty if the position is out of range.
+     */
+    const std::vector<entry> &neighbours(std::size_t position) const;
+    /**
+     * This function looks up a pair of queries.
+     * @param position1: the position of the first query.
+     * @param position2: the position of the second query.
+     * @param result: the pair as seen from the first query, only set if the pair is kept.
+     * @return: true if the pair is kept, false otherwise.
+     */
+    bool find(std::size_t position1, std::size_t position2, entry &result) const;
+    /**
+     * This function returns the number of tree edit distances computed.
+     */
+    std::size_t evaluations() const;
+    /**
+     * This function returns the number of pairs skipped by the lower bound.
+     */
+    std::size_t pruned() const;
+
+private:
+    bool computed = false;
+    std::vector<std::vector<entry>> rows;          /**< The close queries of each query. */
+    std::atomic<std::size_t> tree_evaluations{0}; /**< The number of tree edit distances computed. */
+    std::atomic<std::size_t> pruned_pairs{0};     /**< The number of pairs skipped by the lower bound. */
+};
+
+#endif // DISTANCE_MATRIX_H
@@ -20,6 +20,18 @@
 #include "clauses/create_view.h"
 #include "clauses/alter_clause.h"
 
+using statement_kind = AbstractSyntaxTree::statement_kind;
+
+// The statements that are not listed in statement_kind are all UNKNOWN, their node names tell them apart
+static std::string statement_name(const Goals::clause_profile &profile)
+{
+    return profile.stmt_node ? profile.stmt_node->key : std::string();
+}
+static bool same_statement(const Goals::clause_profile &profile1, const Goals::clause_profile &profile2)
+{
+    return profile1.kind == profile2.kind && (profile1.kind != statement_kind::UNKNOWN || statement_name(profile1) == statement_name(profile2));
+}
+
 Goals::Goals()
 {
     // empty constructor
@@ -39,10 +51,10 @@ std::vector<Goals::Goal> Goals::process_query(const std::shared_ptr<AbstractSynt
     }
 
     // Detect statement type by the key:
-    std::string stmt_type = ast.get_statement_type(root_node);
+    statement_kind stmt_kind = AbstractSyntaxTree::get_statement_kind(root_node);
     auto stmt_node = ast.get_statement_node(root_node);
 
-    if (stmt_type == "SelectStmt")
+    if (stmt_kind == statement_kind::SELECT_STMT)
     {
         // Step 1: Process FROM clause
         auto from_result = From_clause::process(root_node);
@@ -104,7 +116,7 @@ std::vector<Goals::Goal> Goals::process_query(const std::shared_ptr<AbstractSynt
             goals.push_back(goal);
         }
     }
-    else if (stmt_type == "CreateStmt")
+    else if (stmt_kind == statement_kind::CREATE_STMT)
     {
         // CREATE TABLE or other CREATE variant
         auto create_result = Create_clause::process(stmt_node);
@@ -113,7 +125,7 @@ std::vector<Goals::Goal> Goals::process_query(const std::shared_ptr<AbstractSynt
             goals.push_back({"Create", create_result.first});
         }
     }
-    else if (stmt_type == "UpdateStmt")
+    else if (stmt_kind == statement_kind::UPDATE_STMT)
     {
         // UPDATE statement
         // For UPDATE, we might still want FROM info (in case needed)
@@ -125,7 +137,7 @@ std::vector<Goals::Goal> Goals::process_query(const std::shared_ptr<AbstractSynt
             goals.push_back({"Update", update_result.first});
         }
     }
-    else if (stmt_type == "DeleteStmt")
+    else if (stmt_kind == statement_kind::DELETE_STMT)
     {
         // DELETE statement
         From_clause::from_clause_info dummy_from;
@@ -135,7 +147,7 @@ std::vector<Goals::Goal> Goals::process_query(const std::shared_ptr<AbstractSynt
             goals.push_back({"Delete", delete_result.first});
         }
     }
-    else if (stmt_type == "CreateAssertionStmt")
+    else if (stmt_kind == statement_kind::CREATE_ASSERTION_STMT)
     {
         // CREATE ASSERTION
         auto assertion_result = Assertion_clause::process(stmt_node);
@@ -144,7 +156,7 @@ std::vector<Goals::Goal> Goals::process_query(const std::shared_ptr<AbstractSynt
             goals.push_back({"Assertion", assertion_result.first});
         }
     }
-    else if (stmt_type == "InsertStmt")
+    else if (stmt_kind == statement_kind::INSERT_STMT)
     {
         auto insert_result = Insert_clause::process(stmt_node);
         if (!insert_result.first.empty())
@@ -155,7 +167,7 @@ std::vector<Goals::Goal> Goals::process_query(const std::shared_ptr<AbstractSynt
             goals.push_back(goal);
         }
     }
-    else if (stmt_type == "ViewStmt")
+    else if (stmt_kind == statement_kind::VIEW_STMT)
     {
         auto create_view_result = Create_clause::process(stmt_node);
         if (!create_view_result.first.empty())
@@ -163,7 +175,7 @@ std::vector<Goals::Goal> Goals::process_query(const std::shared_ptr<AbstractSynt
             goals.push_back({"CreateView", create_view_result.first});
         }
     }
-    else if (stmt_type == "AlterTableStmt")
+    else if (stmt_kind == statement_kind::ALTER_TABLE_STMT)
     {
         auto alter_result = Alter_clause::process(stmt_node);
         if (!alter_result.first.empty())
@@ -180,90 +192,94 @@ std::vector<Goals::Goal> Goals::process_query(const std::shared_ptr<AbstractSynt
     // Return the vector of goals
     return goals;
 }
+std::shared_ptr<const Goals::query_profile> Goals::compile_query_profile(const std::shared_ptr<AbstractSyntaxTree::Node> &root_node, bool with_goals)
+{
+    if (!root_node)
+    {
+        return nullptr;
+    }
+    auto profile = std::make_shared<query_profile>();
+    for (const auto &stmt_root : AbstractSyntaxTree::get_statements(root_node))
+    {
+        profile->statements.push_back(compile_statement_profile(stmt_root, with_goals));
+    }
+    return profile;
+}
+Goals::clause_profile Goals::compile_statement_profile(const std::shared_ptr<AbstractSyntaxTree::Node> &stmt_root, bool with_goal)
+{
+    clause_profile profile;
+    profile.kind = AbstractSyntaxTree::get_statement_kind(stmt_root);
+    profile.stmt_root = stmt_root;
+    profile.stmt_node = AbstractSyntaxTree::get_statement_node(stmt_root);
+    if (with_goal)
+    {
+        profile.goal = generate_goal_for_stmt_general(stmt_root);
+    }
+    if (profile.kind == statement_kind::SELECT_STMT)
+    {
+        // The later clauses resolve aliases and columns through the FROM and SELECT infos.
+        profile.from_info = From_clause::get_info(stmt_root);
+        profile.select_info = Select_clause::get_info(stmt_root, profile.from_info);
+        profile.where_info = Where_clause::get_info(stmt_root, profile.from_info, profile.select_info);
+        profile.group_by_info = Group_by_clause::get_info(stmt_root, profile.from_info);
+        profile.having_info = Having_clause::get_info(stmt_root, profile.from_info, profile.select_info);
+        profile.order_by_info = Order_by_clause::get_info(stmt_root, profile.from_info, profile.select_info);
+    }
+    return profile;
+}
 Common::comparision_result Goals::compare_single_statement(const std::shared_ptr<AbstractSyntaxTree::Node> &reference_root, const std::shared_ptr<AbstractSyntaxTree::Node> &student_root)
+{
+    if (!reference_root || !student_root)
+    {
+        Common::comparision_result info;
+        info.message = "One or both statements are empty.";
+        return info;
+    }
+    return compare_single_statement(compile_statement_profile(reference_root, false), compile_statement_profile(student_root, false));
+}
+Common::comparision_result Goals::compare_single_statement(const clause_profile &reference, const clause_profile &student)
 {
     Common::comparision_result info;
-    AbstractSyntaxTree ast;
 
     // Initialize the output string
     std::ostringstream oss;
     std::string success_message;
 
-    if (!reference_root || !student_root)
+    if (!reference.stmt_root || !student.stmt_root)
     {
         info.message = "One or both statements are empty.";
         return info;
     }
 
-    // Extract statement nodes
-    std::string ref_type = ast.get_statement_type(reference_root);
-    std::string stu_type = ast.get_statement_type(student_root);
-    auto ref_stmt_node = ast.get_statement_node(reference_root);
-    auto stu_stmt_node = ast.get_statement_node(student_root);
+    statement_kind ref_kind = reference.kind;
+    const auto &ref_stmt_node = reference.stmt_node;
+    const auto &stu_stmt_node = student.stmt_node;
 
-    if (ref_type != stu_type)
+    if (!same_statement(reference, student))
     {
         // Different statement types
-        oss << "The correct statement is a " << ref_type << " but your statement is a " << stu_type << ".\n";
+        oss << "The correct statement is a " << statement_name(reference)
+            << " but your statement is a " << statement_name(student) << ".\n";
         info.message = oss.str();
         info.incorrect_parts.push_back("Statement Type");
         return info;
     }
 
-    if (ref_type == "SelectStmt")
+    if (ref_kind == statement_kind::SELECT_STMT)
     {
-
-        // Process the reference query
-        auto reference_goals = process_query(reference_root);
-        // Process the student query
-        auto student_goals = process_query(student_root);
-
-        // Initialize variables to hold clause info
-        Select_clause::select_clause_info ref_select_info, stu_select_info;
-        From_clause::from_clause_info ref_from_info, stu_from_info;
-        Where_clause::where_clause_info ref_where_info, stu_where_info;
-        Group_by_clause::group_by_clause_info ref_group_by_info, stu_group_by_info;
-        Where_clause::where_clause_info ref_having_info, stu_having_info;
-        Order_by_clause::order_by_clause_info ref_order_by_info, stu_order_by_info;
-
-        // Process the clauses and collect info
-        // Reference Query
-        auto ref_from_result = From_clause::process(reference_root);
-        ref_from_info = ref_from_result.second;
-
-        auto ref_select_result = Select_clause::process(reference_root, ref_from_info);
-        ref_select_info = ref_select_result.second;
-
-        auto ref_where_result = Where_clause::process(reference_root, ref_from_info, ref_select_info);
-        ref_where_info = ref_where_result.second;
-
-        auto ref_group_by_result = Group_by_clause::process(reference_root, ref_from_info);
-        ref_group_by_info = ref_group_by_result.second;
-
-        auto ref_having_result = Having_clause::process(reference_root, ref_from_info, ref_select_info);
-        ref_having_info = ref_having_result.second;
-
-        auto ref_order_by_result = Order_by_clause::process(reference_root, ref_from_info, ref_select_info);
-        ref_order_by_info = ref_order_by_result.second;
-
-        // Student Query
-        auto stu_from_result = From_clause::process(student_root);
-        stu_from_info = stu_from_result.second;
-
-        auto stu_select_result = Select_clause::process(student_root, stu_from_info);
-        stu_select_info = stu_select_result.second;
-
-        auto stu_where_result = Where_clause::process(student_root, stu_from_info, stu_select_info);
-        stu_where_info = stu_where_result.second;
-
-        auto stu_group_by_result = Group_by_clause::process(student_root, stu_from_info);
-        stu_group_by_info = stu_group_by_result.second;
-
-        auto stu_having_result = Having_clause::process(student_root, stu_from_info, stu_select_info);
-        stu_having_info = stu_having_result.second;
-
-        auto stu_order_by_result = Order_by_clause::process(student_root, stu_from_info, stu_select_info);
-        stu_order_by_info = stu_order_by_result.second;
+        // The clause infos of both queries were extracted when their profiles were compiled.
+        const auto &ref_select_info = reference.select_info;
+        const auto &stu_select_info = student.select_info;
+        const auto &ref_from_info = reference.from_info;
+        const auto &stu_from_info = student.from_info;
+        const auto &ref_where_info = reference.where_info;
+        const auto &stu_where_info = student.where_info;
+        const auto &ref_group_by_info = reference.group_by_info;
+        const auto &stu_group_by_info = student.group_by_info;
+        const auto &ref_having_info = reference.having_info;
+        const auto &stu_having_info = student.having_info;
+        const auto &ref_order_by_info = reference.order_by_info;
+        const auto &stu_order_by_info = student.order_by_info;
 
         // Keep track of correctly matched clauses
         std::vector<std::string> correct_clauses;
@@ -444,7 +460,7 @@ Common::comparision_result Goals::compare_single_statement(const std::shared_ptr
 
         return info;
     }
-    else if (ref_type == "CreateStmt")
+    else if (ref_kind == statement_kind::CREATE_STMT)
     {
         auto ref_create_info = Create_clause::get_info(ref_stmt_node);
         auto stu_create_info = Create_clause::get_info(stu_stmt_node);
@@ -453,7 +469,7 @@ Common::comparision_result Goals::compare_single_statement(const std::shared_ptr
         info = create_cmp;
         success_message = "Excellent! Your CREATE statement matches the reference.\n";
     }
-    else if (ref_type == "ViewStmt")
+    else if (ref_kind == statement_kind::VIEW_STMT)
     {
         auto ref_view_info = Create_view::get_info(ref_stmt_node);
         auto stu_view_info = Create_view::get_info(stu_stmt_node);
@@ -461,7 +477,7 @@ Common::comparision_result Goals::compare_single_statement(const std::shared_ptr
         info = view_cmp;
         success_message = "Excellent! Your CREATE VIEW statement matches the reference.\n";
     }
-    else if (ref_type == "UpdateStmt")
+    else if (ref_kind == statement_kind::UPDATE_STMT)
     {
         From_clause::from_clause_info dummy_from;
         auto ref_update_result = Update_clause::process(ref_stmt_node, dummy_from);
@@ -471,7 +487,7 @@ Common::comparision_result Goals::compare_single_statement(const std::shared_ptr
         info = update_cmp;
         success_message = "Excellent! Your UPDATE statement matches the reference.\n";
     }
-    else if (ref_type == "DeleteStmt")
+    else if (ref_kind == statement_kind::DELETE_STMT)
     {
         From_clause::from_clause_info dummy_from;
         auto ref_delete_result = Delete_clause::process(ref_stmt_node, dummy_from);
@@ -481,7 +497,7 @@ Common::comparision_result Goals::compare_single_statement(const std::shared_ptr
         info = delete_cmp;
         success_message = "Excellent! Your DELETE statement matches the reference.\n";
     }
-    else if (ref_type == "CreateAssertionStmt")
+    else if (ref_kind == statement_kind::CREATE_ASSERTION_STMT)
     {
         auto ref_assertion_result = Assertion_clause::process(ref_stmt_node);
         auto stu_assertion_result = Assertion_clause::process(stu_stmt_node);
@@ -490,7 +506,7 @@ Common::comparision_result Goals::compare_single_statement(const std::shared_ptr
         info = assertion_cmp;
         success_message = "Excellent! Your ASSERTION statement matches the reference.\n";
     }
-    else if (ref_type == "InsertStmt")
+    else if (ref_kind == statement_kind::INSERT_STMT)
     {
         auto ref_insert_info = Insert_clause::get_info(ref_stmt_node);
         auto stu_insert_info = Insert_clause::get_info(stu_stmt_node);
@@ -499,7 +515,7 @@ Common::comparision_result Goals::compare_single_statement(const std::shared_ptr
         info = insert_cmp;
         success_message = "Excellent! Your INSERT statement matches the reference.\n";
     }
-    else if (ref_type == "AlterTableStmt")
+    else if (ref_kind == statement_kind::ALTER_TABLE_STMT)
     {
         auto ref_alter_info = Alter_clause::get_info(ref_stmt_node);
         auto stu_alter_info = Alter_clause::get_info(stu_stmt_node);
@@ -508,18 +524,9 @@ Common::comparision_result Goals::compare_single_statement(const std::shared_ptr
         info = alter_cmp;
         success_message = "Excellent! Your ALTER statement matches the reference.\n";
     }
-    else if (ref_type == "CreateViewStmt")
-    {
-        auto ref_create_view_info = Create_view::get_info(ref_stmt_node);
-        auto stu_create_view_info = Create_view::get_info(stu_stmt_node);
-        auto create_view_cmp = Create_view::compare(ref_create_view_info, stu_create_view_info);
-
-        info = create_view_cmp;
-        success_message = "Excellent! Your CREATE VIEW statement matches the reference.\n";
-    }
     else
     {
-        oss << "Unsupported statement type: " << ref_type << "\n";
+        oss << "Unsupported statement type: " << statement_name(reference) << "\n";
         info.message = oss.str();
         return info;
     }
@@ -573,48 +580,46 @@ Common::comparision_result Goals::compare_single_statement(const std::shared_ptr
 }
 Common::comparision_result Goals::compare_queries(const std::shared_ptr<AbstractSyntaxTree::Node> &reference_root, const std::shared_ptr<AbstractSyntaxTree::Node> &student_root)
 {
-    Common::comparision_result overall_info;
-    std::ostringstream overall_oss;
-
     if (!reference_root || !student_root)
     {
+        Common::comparision_result overall_info;
         overall_info.message = "One or both statements are empty.";
         return overall_info;
     }
+    return compare_queries(*compile_query_profile(reference_root), *compile_query_profile(student_root, false));
+}
+Common::comparision_result Goals::compare_queries(const query_profile &reference, const query_profile &student)
+{
+    Common::comparision_result overall_info;
+    std::ostringstream overall_oss;
 
-    // Extract all statement nodes from both ASTs.
-    auto ref_statements = AbstractSyntaxTree::get_statements(reference_root);
-    auto stu_statements = AbstractSyntaxTree::get_statements(student_root);
+    const auto &ref_statements = reference.statements;
+    const auto &stu_statements = student.statements;
 
     // Keep track of which student statements we've used
     std::vector<bool> stu_used(stu_statements.size(), false);
 
     // 1) For each reference stmt, find a student stmt of the same type
-    for (auto &ref_stmt : ref_statements)
+    for (const auto &ref_stmt : ref_statements)
     {
-        std::string ref_type = AbstractSyntaxTree::get_statement_type(ref_stmt);
-
         // search for a matching student statement
         int match_idx = -1;
         for (size_t j = 0; j < stu_statements.size(); ++j)
         {
-            if (!stu_used[j] &&
-                AbstractSyntaxTree::get_statement_type(stu_statements[j]) == ref_type)
+            if (!stu_used[j] && same_statement(stu_statements[j], ref_stmt))
             {
                 match_idx = (int)j;
                 break;
             }
         }
 
-        // get the reference query goal
-        auto ref_goal = generate_goal_for_stmt_general(ref_stmt);
-
         if (match_idx >= 0)
         {
             // found a student stmt of same type → compare them
             auto result = compare_single_statement(ref_stmt, stu_statements[match_idx]);
+            // a correct student query as the reference has no goals compiled, its goal is generated when it is shown
             overall_oss << "1️⃣ Goal:\n"
-                        << ref_goal << "\n\n";
+                        << (ref_stmt.goal.empty() ? generate_goal_for_stmt_general(ref_stmt.stmt_root) : ref_stmt.goal) << "\n\n";
             overall_oss << result.message;
             overall_info.correct_parts.insert(overall_info.correct_parts.end(), result.correct_parts.begin(), result.correct_parts.end());
             overall_info.incorrect_parts.insert(overall_info.incorrect_parts.end(), result.incorrect_parts.begin(), result.incorrect_parts.end());
@@ -625,6 +630,7 @@ Common::comparision_result Goals::compare_queries(const std::shared_ptr<Abstract
         else
         {
             // no student statement of this type found
+            std::string ref_type = statement_name(ref_stmt);
             overall_oss << "Missing " << ref_type << " statement.\n";
             overall_info.incorrect_parts.push_back(ref_type + " statement");
         }
@@ -635,7 +641,7 @@ Common::comparision_result Goals::compare_queries(const std::shared_ptr<Abstract
     {
         if (!stu_used[j])
         {
-            std::string extra_type = AbstractSyntaxTree::get_statement_type(stu_statements[j]);
+            std::string extra_type = statement_name(stu_statements[j]);
             overall_oss << "Extra " << extra_type << " statement.\n";
             overall_info.incorrect_parts.push_back("Extra " + extra_type);
         }
@@ -690,8 +696,8 @@ std::string Goals::generate_goal_for_stmt_general(const std::shared_ptr<Abstract
     }
 
     // Get the statement type
-    std::string stmt_type = ast.get_statement_type(root_node);
-    if (stmt_type.empty())
+    statement_kind stmt_kind = AbstractSyntaxTree::get_statement_kind(root_node);
+    if (!AbstractSyntaxTree::get_statement_node(root_node))
     {
         return "Cannot determine the statement type.";
     }
@@ -700,7 +706,7 @@ std::string Goals::generate_goal_for_stmt_general(const std::shared_ptr<Abstract
     std::ostringstream oss;
     oss << "The query is supposed to:";
 
-    if (stmt_type == "SelectStmt")
+    if (stmt_kind == statement_kind::SELECT_STMT)
     {
         // Process each clause of the query to extract information
         auto from_result = From_clause::process(root_node);
@@ -754,45 +760,45 @@ std::string Goals::generate_goal_for_stmt_general(const std::shared_ptr<Abstract
             oss << "\n ● Sort the output data by " << order_by_item_count << " column" << (order_by_item_count > 1 ? "s" : "") << "; ";
         }
     }
-    else if (stmt_type == "CreateStmt")
+    else if (stmt_kind == statement_kind::CREATE_STMT)
     {
         // For CREATE statements, you'd implement Create_clause::create_clause_process if not already done
         auto create_result = Create_clause::process(stmt_node);
         oss << "\n ● " << create_result.first;
     }
-    else if (stmt_type == "UpdateStmt")
+    else if (stmt_kind == statement_kind::UPDATE_STMT)
     {
         // For UPDATE statements
         From_clause::from_clause_info dummy_from;
         auto update_result = Update_clause::process(stmt_node, dummy_from);
         oss << "\n ● " << update_result.first;
     }
-    else if (stmt_type == "DeleteStmt")
+    else if (stmt_kind == statement_kind::DELETE_STMT)
     {
         // For DELETE statements
         From_clause::from_clause_info dummy_from;
         auto delete_result = Delete_clause::process(stmt_node, dummy_from);
         oss << "\n ● " << delete_result.first;
     }
-    else if (stmt_type == "CreateAssertionStmt")
+    else if (stmt_kind == statement_kind::CREATE_ASSERTION_STMT)
     {
         // For ASSERTION statements
         auto assertion_result = Assertion_clause::process(stmt_node);
         oss << "\n ● " << assertion_result.first;
     }
-    else if (stmt_type == "InsertStmt")
+    else if (stmt_kind == statement_kind::INSERT_STMT)
     {
         // NEW: Generate a general goal for INSERT statements
         auto insert_result = Insert_clause::process(stmt_node);
         oss << "\n ● " << insert_result.first;
     }
-    else if (stmt_type == "ViewStmt")
+    else if (stmt_kind == statement_kind::VIEW_STMT)
     {
         // For CREATE VIEW statements
         auto create_view_result = Create_view::process(stmt_node);
         oss << "\n ● " << create_view_result.first;
     }
-    else if (stmt_type == "AlterTableStmt")
+    else if (stmt_kind == statement_kind::ALTER_TABLE_STMT)
     {
         // For ALTER statements
         auto alter_result = Alter_clause::process(stmt_node);
@@ -851,8 +857,8 @@ std::string Goals::generate_goal_for_stmt_specific(const std::shared_ptr<Abstrac
     }
 
     // Get the statement type
-    std::string stmt_type = ast.get_statement_type(root_node);
-    if (stmt_type.empty())
+    statement_kind stmt_kind = AbstractSyntaxTree::get_statement_kind(root_node);
+    if (!AbstractSyntaxTree::get_statement_node(root_node))
     {
         return "Cannot determine the statement type.";
     }
@@ -861,7 +867,7 @@ std::string Goals::generate_goal_for_stmt_specific(const std::shared_ptr<Abstrac
     std::ostringstream oss;
     oss << "The query is supposed to: ";
 
-    if (stmt_type == "SelectStmt")
+    if (stmt_kind == statement_kind::SELECT_STMT)
     {
         // Process each clause of the query to extract information
         auto from_result = From_clause::process(root_node);
@@ -960,44 +966,44 @@ std::string Goals::generate_goal_for_stmt_specific(const std::shared_ptr<Abstrac
             }
         }
     }
-    else if (stmt_type == "CreateStmt")
+    else if (stmt_kind == statement_kind::CREATE_STMT)
     {
         // CREATE
         auto create_result = Create_clause::process(stmt_node);
         oss << "\n ● " << create_result.first;
     }
-    else if (stmt_type == "UpdateStmt")
+    else if (stmt_kind == statement_kind::UPDATE_STMT)
     {
         // UPDATE
         From_clause::from_clause_info dummy_from;
         auto update_result = Update_clause::process(stmt_node, dummy_from);
         oss << "\n ● " << update_result.first;
     }
-    else if (stmt_type == "DeleteStmt")
+    else if (stmt_kind == statement_kind::DELETE_STMT)
     {
         // DELETE
         From_clause::from_clause_info dummy_from;
         auto delete_result = Delete_clause::process(stmt_node, dummy_from);
         oss << "\n ● " << delete_result.first;
     }
-    else if (stmt_type == "CreateAssertionStmt")
+    else if (stmt_kind == statement_kind::CREATE_ASSERTION_STMT)
     {
         // ASSERTION
         auto assertion_result = Assertion_clause::process(stmt_node);
         oss << "\n ● " << assertion_result.first;
     }
-    else if (stmt_type == "InsertStmt")
+    else if (stmt_kind == statement_kind::INSERT_STMT)
     {
         auto insert_result = Insert_clause::process(stmt_node);
         oss << "\n ● " << insert_result.first;
     }
-    else if (stmt_type == "ViewStmt")
+    else if (stmt_kind == statement_kind::VIEW_STMT)
     {
         // CREATE VIEW
         auto create_view_result = Create_view::process(stmt_node);
         oss << "\n ● " << create_view_result.first;
     }
-    else if (stmt_type == "AlterTableStmt")
+    else if (stmt_kind == statement_kind::ALTER_TABLE_STMT)
     {
         // ALTER
         auto alter_result = Alter_clause::process(stmt_node);
@@ -5,8 +5,11 @@
 #include <vector>
 #include <memory>
 #include "abstract_syntax_tree.h"
+#include "clauses/select/from_clause.h"
 #include "clauses/select/select_clause.h"
 #include "clauses/select/where_clause.h"
+#include "clauses/select/group_by_clause.h"
+#include "clauses/select/order_by_clause.h"
 #include "clauses/common.h"
 
 class Goals
@@ -20,6 +23,32 @@ public:
         std::string content; // content of the goal
     };
 
+    /**
+     * The clause information of one statement, extracted once so that comparisons only have to diff it.
+     * The SELECT clause infos are filled for SELECT statements only; other statements are compared from stmt_node.
+     */
+    struct clause_profile
+    {
+        AbstractSyntaxTree::statement_kind kind = AbstractSyntaxTree::statement_kind::UNKNOWN;
+        std::shared_ptr<AbstractSyntaxTree::Node> stmt_root; // the "stmt" node of the statement
+        std::shared_ptr<AbstractSyntaxTree::Node> stmt_node; // the statement node itself, e.g. SelectStmt
+        std::string goal;                                    // the general goal, shown when the query is the reference
+        From_clause::from_clause_info from_info;
+        Select_clause::select_clause_info select_info;
+        Where_clause::where_clause_info where_info;
+        Group_by_clause::group_by_clause_info group_by_info;
+        Where_clause::where_clause_info having_info;
+        Order_by_clause::order_by_clause_info order_by_info;
+    };
+    /**
+     * The clause profiles of all statements in a query, in query order.
+     * A query profile is immutable once compiled and is shared between all comparisons that use the query.
+     */
+    struct query_profile
+    {
+        std::vector<clause_profile> statements;
+    };
+
     Goals();
     /**
      * THis function takes a query parse tree and processes it to extract the different clauses goals
@@ -27,7 +56,21 @@ public:
      * @return: A vector of Goal structures conatining the clause information
      */
     static std::vector<Goal> process_query(const std::shared_ptr<AbstractSyntaxTree::Node> &root_node);
+    /**
+     * This function extracts the clause profile of every statement in a query.
+     * @param root_node: This is a pointer to the root node of the parse tree
+     * @param with_goals: true to also generate the general goal of every statement, only a reference query shows them.
+     * @return: The compiled profile, or nullptr if there is no parse tree.
+     */
+    static std::shared_ptr<const query_profile> compile_query_profile(const std::shared_ptr<AbstractSyntaxTree::Node> &root_node, bool with_goals = true);
     static Common::comparision_result compare_single_statement(const std::shared_ptr<AbstractSyntaxTree::Node> &reference_root, const std::shared_ptr<AbstractSyntaxTree::Node> &student_root);
+    /**
+     * This function compares two statements using their precompiled clause profiles.
+     * @param reference: The profile of the reference statement.
+     * @param student: The profile of the student statement.
+     * @return: A comparison_info structure containing the comparison information
+     */
+    static Common::comparision_result compare_single_statement(const clause_profile &reference, const clause_profile &student);
     /**
      * This function compares two queries and returns the comparison information
      * @param reference_root: This is a pointer to the root node of the reference query
@@ -35,11 +78,24 @@ public:
      * @return: A comparison_info structure containing the comparison information
      */
     static Common::comparision_result compare_queries(const std::shared_ptr<AbstractSyntaxTree::Node> &reference_root, const std::shared_ptr<AbstractSyntaxTree::Node> &student_root);
+    /**
+     * This function compares two queries using their precompiled clause profiles.
+     * @param reference: The profile of the reference query.
+     * @param student: The profile of the student query.
+     * @return: A comparison_info structure containing the comparison information
+     */
+    static Common::comparision_result compare_queries(const query_profile &reference, const query_profile &student);
 
     static std::vector<std::string> generate_query_goal_general(const std::shared_ptr<AbstractSyntaxTree::Node> &root_node);
     static std::vector<std::string> generate_query_goal_specific(const std::shared_ptr<AbstractSyntaxTree::Node> &root_node);
 
 private:
+    /**
+     * This function extracts the clause profile of one statement.
+     * @param stmt_root: The "stmt" node of the statement.
+     * @param with_goal: true to also generate the general goal of the statement.
+     */
+    static clause_profile compile_statement_profile(const std::shared_ptr<AbstractSyntaxTree::Node> &stmt_root, bool with_goal);
     static std::string generate_goal_for_stmt_general(const std::shared_ptr<AbstractSyntaxTree::Node> &stmt_node);
     static std::string generate_goal_for_stmt_specific(const std::shared_ptr<AbstractSyntaxTree::Node> &stmt_node);
 };
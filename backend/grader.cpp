@@ -175,28 +175,51 @@ double Grader::correctness_level_normalized_value(const vector<properties> &matr
 
     return normalized_value;
 }
+const Grader::correctness_table &Grader::get_correctness_table(property_level sn_level, property_level sm_level, property_level rs_level, property_order order)
+{
+    using tables = std::array<correctness_table, property_level_count * property_level_count * property_level_count * property_order_count>;
+    auto table_index = [](property_level sn, property_level sm, property_level rs, property_order ord)
+    {
+        return ((static_cast<std::size_t>(sn) * property_level_count + static_cast<std::size_t>(sm)) * property_level_count + static_cast<std::size_t>(rs)) * property_order_count + static_cast<std::size_t>(ord);
+    };
+    // built once for every combination; the initialization of a static local is thread safe
+    static const tables all_tables = [&]()
+    {
+        tables result{};
+        Grader grader;
+        for (std::size_t sn = 0; sn < property_level_count; ++sn)
+            for (std::size_t sm = 0; sm < property_level_count; ++sm)
+                for (std::size_t rs = 0; rs < property_level_count; ++rs)
+                    for (std::size_t ord = 0; ord < property_order_count; ++ord)
+                    {
+                        auto sn_l = static_cast<property_level>(sn);
+                        auto sm_l = static_cast<property_level>(sm);
+                        auto rs_l = static_cast<property_level>(rs);
+                        auto order_l = static_cast<property_order>(ord);
+                        auto matrix = grader.get_correctness_matrix(rs_l, sm_l, sn_l, order_l);
+                        auto &table = result[table_index(sn_l, sm_l, rs_l, order_l)];
+                        table.size = static_cast<int>(matrix.size());
+                        for (std::size_t level = matrix.size(); level > 0; --level)
+                        {
+                            // walking backwards keeps the first (lowest) level of an outcome, as the linear search did
+                            const auto &outcome = matrix[level - 1];
+                            table.levels[outcome_index(outcome.results, outcome.semantics, outcome.syntax)] = static_cast<std::uint16_t>(level);
+                        }
+                    }
+        return result;
+    }();
+    return all_tables[table_index(sn_level, sm_level, rs_level, order)];
+}
 std::pair<int, double> Grader::calculate_correctness_level(property_level sn_level, property_level sm_level, property_level rs_level, property_order order, property_state results, property_state semantics, property_state syntax)
 {
-    //initialize the correctness matrix
-    vector<properties> correctness_matrix = get_correctness_matrix(rs_level, sm_level, sn_level, order);
-    int correctness_level = 1;
-
-    //calculate the correctness level for the rest of the cases
-    for (auto& correctness_level_outcomes : correctness_matrix)
-    {   
-        if (correctness_level_outcomes.results == results &&
-            correctness_level_outcomes.semantics == semantics &&
-            correctness_level_outcomes.syntax == syntax)
-        {
-            break;
-        }
-        correctness_level++;
-    }
+    const correctness_table &table = get_correctness_table(sn_level, sm_level, rs_level, order);
+    int correctness_level = table.levels[outcome_index(results, semantics, syntax)];
 
-    //If the correctness level is bigger than the size of the matrix, then something is wrong
+    //If the outcome is not in the matrix, then something is wrong
     //print a message with property states
-    if (correctness_level > correctness_matrix.size())
+    if (correctness_level == 0)
     {
+        correctness_level = table.size + 1;
         std::cerr << "Error: The correctness level is bigger than the size of the correctness matrix." << std::endl;
         std::cerr << "Results: " << property_state_to_string(results) << std::endl;
         std::cerr << "Semantics: " << property_state_to_string(semantics) << std::endl;
@@ -204,8 +227,8 @@ std::pair<int, double> Grader::calculate_correctness_level(property_level sn_lev
         //return std::make_pair(-1, -1);
     }
 
-    //calculate the normalized value
-    double normalized_value = correctness_level_normalized_value(correctness_matrix, correctness_level);
+    //calculate the normalized value, as correctness_level_normalized_value does for the matrix
+    double normalized_value = static_cast<double>(correctness_level - 1) / (table.size - 1);
     return std::make_pair(correctness_level, normalized_value);
 }
 
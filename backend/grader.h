@@ -11,6 +11,8 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <array>
+#include <cstdint>
 
 using std::map;
 using std::string;
@@ -62,6 +64,22 @@ public:
 		property_state semantics;
 		property_state syntax;
 	};
+	/**
+	 * The number of values of property_state, property_level and property_order.
+	 */
+	static constexpr std::size_t property_state_count = static_cast<std::size_t>(property_state::CORRECT) + 1;
+	static constexpr std::size_t property_level_count = static_cast<std::size_t>(property_level::SEMATICS_LEVELS_6) + 1;
+	static constexpr std::size_t property_order_count = static_cast<std::size_t>(property_order::RE_SY_SM) + 1;
+	/**
+	 * A correctness level matrix flattened into a lookup table.
+	 * levels is indexed by (results, semantics, syntax) and holds the 1-based correctness level of that outcome,
+	 * or 0 if the outcome is not part of the matrix.
+	 */
+	struct correctness_table
+	{
+		int size = 0;
+		std::array<std::uint16_t, property_state_count * property_state_count * property_state_count> levels{};
+	};
 	struct grading_options
 	{
 		property_level syntax;
@@ -93,6 +111,23 @@ public:
 	 * @param query: the query to be graded.
 	 */
 	std::pair<int, double> calculate_correctness_level(property_level sn_level, property_level sm_level, property_level rs_level, property_order order, property_state results, property_state semantics, property_state syntax);
+	/**
+	 * This function returns the lookup table of a correctness level matrix.
+	 * The tables of all level and order combinations are built once, on first use, and never change afterwards.
+	 * @param sn_level: the syntax level.
+	 * @param sm_level: the semantics level.
+	 * @param rs_level: the results level.
+	 * @param order: the order of importance of the properties.
+	 * @return: the lookup table of the matrix.
+	 */
+	static const correctness_table &get_correctness_table(property_level sn_level, property_level sm_level, property_level rs_level, property_order order);
+	/**
+	 * This function returns the position of an outcome triple in correctness_table::levels.
+	 */
+	static constexpr std::size_t outcome_index(property_state results, property_state semantics, property_state syntax)
+	{
+		return (static_cast<std::size_t>(results) * property_state_count + static_cast<std::size_t>(semantics)) * property_state_count + static_cast<std::size_t>(syntax);
+	}
 	/**
 	 * This function displays the correctness matrix on the console.
 	 * @param syntax: number of syntax outcomes
@@ -0,0 +1,161 @@
+#include "grading_jobs.h"
+#include <algorithm>
+#include <exception>
+#include "utils.h"
+
+GradingJobs::GradingJobs(std::size_t workers, std::size_t max_queued, std::size_t max_finished)
+    : max_queued(max_queued), max_finished(max_finished), executor(std::max<std::size_t>(workers, 1))
+{
+}
+
+GradingJobs::~GradingJobs()
+{
+    executor.wait_until_empty();
+}
+
+bool GradingJobs::submit(task work, std::string &id)
+{
+    auto current = std::make_shared<job>();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queued >= max_queued)
+        {
+            return false;
+        }
+        queued++;
+        id = Utils::random_id();
+        jobs[id] = current;
+    }
+    executor.enqueue([this, id, current, work = std::move(work)]()
+                     { run(id, current, work); });
+    return true;
+}
+
+void GradingJobs::run(const std::string &id, const std::shared_ptr<job> &current, const task &work)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued--;
+        current->state = status::RUNNING;
+    }
+
+    std::string error;
+    bool done = true;
+    auto add_record = [this, &current](std::size_t position, std::string record)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current->records.emplace_back(position, std::move(record));
+    };
+    try
+    {
+        work(current->progress, add_record);
+    }
+    catch (const std::exception &e)
+    {
+        done = false;
+        error = e.what();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    current->error = std::move(error);
+    current->state = done ? status::DONE : status::FAILED;
+    // forget the oldest finished jobs
+    finished.push_back(id);
+    while (finished.size() > max_finished)
+    {
+        jobs.erase(finished.front());
+        finished.pop_front();
+    }
+}
+
+bool GradingJobs::find(const std::string &id, snapshot &result) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = jobs.find(id);
+    if (it == jobs.end())
+    {
+        return false;
+    }
+    const job &current = *it->second;
+    result = {current.state,
+              current.progress.students.load(),
+              current.progress.answers.load(),
+              current.progress.pre_processed.load(),
+              current.progress.syntax.load(),
+              current.progress.results.load(),
+              current.progress.semantics.load(),
+              current.progress.graded.load(),
+              current.released,
+              current.error};
+    return true;
+}
+
+bool GradingJobs::results(const std::string &id, std::string &results) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = jobs.find(id);
+    if (it == jobs.end() || it->second->state != status::DONE || it->second->released > 0)
+    {
+        return false;
+    }
+    // the records come in the order the students are graded
+    std::vector<const std::pair<std::size_t, std::string> *> ordered;
+    for (const auto &record : it->second->records)
+    {
+        ordered.push_back(&record);
+    }
+    std::sort(ordered.begin(), ordered.end(), [](const auto *a, const auto *b)
+              { return a->first < b->first; });
+    results = "[";
+    for (const auto *record : ordered)
+    {
+        if (results.size() > 1)
+        {
+            results += ',';
+        }
+        results += record->second;
+    }
+    results += ']';
+    return true;
+}
+
+bool GradingJobs::records(const std::string &id, std::size_t &from, std::vector<std::string> &records, status &state)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = jobs.find(id);
+    if (it == jobs.end())
+    {
+        return false;
+    }
+    job &current = *it->second;
+    // the client has the records before from, they are not kept for it
+    while (current.released < from && !current.records.empty())
+    {
+        current.records.pop_front();
+        current.released++;
+    }
+    from = std::max(from, current.released);
+    records.clear();
+    for (std::size_t i = from - current.released; i < current.records.size(); i++)
+    {
+        records.push_back(current.records[i].second);
+    }
+    state = current.state;
+    return true;
+}
+
+std::string GradingJobs::to_string(status state)
+{
+    switch (state)
+    {
+    case status::QUEUED:
+        return "queued";
+    case status::RUNNING:
+        return "running";
+    case status::DONE:
+        return "done";
+    case status::FAILED:
+        return "failed";
+    }
+    return "unknown";
+}
@@ -0,0 +1,134 @@
+/**
+ * @file grading_jobs.h
+ * @brief This file contains the declaration of the GradingJobs class.
+ * The class runs grading jobs in the background so that the server can answer a request right away with the id of
+ * its job, and the client polls the job for its progress and its results instead of holding the connection open.
+ * The jobs run on a thread pool of their own, behind a queue of bounded length: a job is refused when the queue is
+ * full. A finished job is kept until a number of newer jobs have finished.
+ * A job adds the record of each student as soon as it is graded, so a client can read the records as they come instead
+ * of waiting for the whole cohort. The records a client has read that way are released, so a job that is read as it
+ * runs does not keep its cohort in memory, but its results can then no longer be looked up as a whole.
+ *
+ * @author Benard Wanjiru
+ * Contact: benard.wanjiru@ru.nl
+ */
+#ifndef GRADING_JOBS_H
+#define GRADING_JOBS_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "process_queries.h"
+#include "thread_pool.h"
+
+class GradingJobs
+{
+public:
+    enum class status
+    {
+        QUEUED,
+        RUNNING,
+        DONE,
+        FAILED
+    };
+    /**
+     * Adds the record of a student to the results of a job, see ProcessQueries::graded_callback.
+     */
+    using record_sink = std::function<void(std::size_t position, std::string record)>;
+    /**
+     * The work of a job. It reports its progress and adds its records, the job fails if it throws.
+     */
+    using task = std::function<void(ProcessQueries::progress &, const record_sink &)>;
+    /**
+     * The state of a job at the time it was looked up.
+     */
+    struct snapshot
+    {
+        status state;
+        std::size_t students;
+        std::size_t answers;
+        std::size_t pre_processed;
+        std::size_t syntax;
+        std::size_t results;
+        std::size_t semantics;
+        std::size_t graded;
+        std::size_t released; /**< The number of records already read and released, see records. */
+        std::string error;    /**< The message of the exception of a failed job. */
+    };
+    /**
+     * @param workers: the number of jobs that run at the same time.
+     * @param max_queued: the number of jobs that can wait for a worker.
+     * @param max_finished: the number of finished jobs that are kept.
+     */
+    explicit GradingJobs(std::size_t workers = 1, std::size_t max_queued = 16, std::size_t max_finished = 64);
+    /**
+     * The destructor waits for the queued jobs to finish.
+     */
+    ~GradingJobs();
+    /**
+     * This function queues a job.
+     * @param work: the work of the job.
+     * @param id: set to the id of the job if it is queued.
+     * @return: true if the job is queued, false if the queue is full.
+     */
+    bool submit(task work, std::string &id);
+    /**
+     * This function looks up the state of a job.
+     * @param id: the id of the job.
+     * @param result: set to the state of the job if it exists.
+     * @return: true if the job exists, false otherwise.
+     */
+    bool find(const std::string &id, snapshot &result) const;
+    /**
+     * This function looks up the results of a job.
+     * @param id: the id of the job.
+     * @param results: set to the records of the job as a JSON array in order of position, if it is done.
+     * @return: true if the job is done and none of its records are released, false otherwise.
+     */
+    bool results(const std::string &id, std::string &results) const;
+    /**
+     * This function looks up the records a job has added so far and releases the first from records, which the client
+     * already has.
+     * @param id: the id of the job.
+     * @param from: the number of records the client already has. Raised to the number of released records if it is
+     * lower, the released records are not returned again.
+     * @param records: set to the records added after the first from records, in the order they were added.
+     * @param state: set to the state of the job when the records were read. No record is added after a job is done.
+     * @return: true if the job exists, false otherwise.
+     */
+    bool records(const std::string &id, std::size_t &from, std::vector<std::string> &records, status &state);
+    /**
+     * This function returns the name of a status as it is reported to the clients.
+     */
+    static std::string to_string(status state);
+
+private:
+    struct job
+    {
+        status state = status::QUEUED;
+        ProcessQueries::progress progress;
+        std::deque<std::pair<std::size_t, std::string>> records; /**< The position and the record of each graded student not released yet. */
+        std::size_t released = 0;                                 /**< The number of records released from the front of records. */
+        std::string error;
+    };
+    /**
+     * This function runs a job on a worker of the pool.
+     */
+    void run(const std::string &id, const std::shared_ptr<job> &current, const task &work);
+
+    const std::size_t max_queued;
+    const std::size_t max_finished;
+    mutable std::mutex mutex;
+    std::map<std::string, std::shared_ptr<job>> jobs;
+    std::deque<std::string> finished; /**< The ids of the finished jobs, the oldest first. */
+    std::size_t queued = 0;
+    ThreadPool executor; /**< Declared last, so that it finishes the queued jobs before the other members are destroyed. */
+};
+
+#endif // GRADING_JOBS_H
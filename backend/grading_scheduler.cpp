@@ -0,0 +1,136 @@
+#include "grading_scheduler.h"
+#include <algorithm>
+#include <cmath>
+
+GradingScheduler::ticket::~ticket()
+{
+    scheduler.release(*this);
+}
+
+GradingScheduler::GradingScheduler(std::size_t budget, std::size_t bulk_cost, std::size_t interactive_reserve, std::size_t max_waiting)
+    : budget(std::max<std::size_t>(budget, 1)),
+      interactive_reserve(std::min(interactive_reserve, this->budget - 1)),
+      bulk_cost(std::clamp<std::size_t>(bulk_cost, 1, this->budget - this->interactive_reserve)),
+      max_waiting(max_waiting)
+{
+}
+
+std::shared_ptr<const GradingScheduler::ticket> GradingScheduler::admit(const std::string &tenant, lane priority, bool bounded)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    waiter current{tenant, priority, priority == lane::BULK ? bulk_cost : 1};
+    tenants[tenant].waiting++;
+    waiting.push_back(&current);
+    grant();
+    // a grading that fits is admitted even when the queue is full
+    if (!current.granted && bounded && waiting.size() > max_waiting)
+    {
+        waiting.remove(&current);
+        auto it = tenants.find(tenant);
+        if (--it->second.waiting == 0 && it->second.running == 0)
+        {
+            tenants.erase(it);
+        }
+        refused++;
+        return nullptr;
+    }
+    granted.wait(lock, [&current]()
+                 { return current.granted; });
+    return std::shared_ptr<const ticket>(new ticket{*this, tenant, priority, current.cost, std::chrono::steady_clock::now()});
+}
+
+std::list<GradingScheduler::waiter *>::iterator GradingScheduler::next(lane priority)
+{
+    auto chosen = waiting.end();
+    for (auto it = waiting.begin(); it != waiting.end(); ++it)
+    {
+        if ((*it)->priority != priority)
+        {
+            continue;
+        }
+        if (chosen == waiting.end())
+        {
+            chosen = it;
+            continue;
+        }
+        // the oldest grading of the tenant with the fewest gradings running, then the one served least
+        const tenant_state &candidate = tenants[(*it)->tenant];
+        const tenant_state &best = tenants[(*chosen)->tenant];
+        if (candidate.running < best.running || (candidate.running == best.running && candidate.served < best.served))
+        {
+            chosen = it;
+        }
+    }
+    return chosen;
+}
+
+void GradingScheduler::grant()
+{
+    bool any = false;
+    while (true)
+    {
+        auto it = next(lane::INTERACTIVE);
+        bool fits = it != waiting.end() && running + 1 <= budget;
+        if (!fits)
+        {
+            // the cohorts leave the reserve of the single submissions free
+            it = next(lane::BULK);
+            fits = it != waiting.end() && running_bulk + bulk_cost <= budget - interactive_reserve && running + bulk_cost <= budget;
+        }
+        if (!fits)
+        {
+            break;
+        }
+        waiter *admitted_waiter = *it;
+        waiting.erase(it);
+        admitted_waiter->granted = true;
+        running += admitted_waiter->cost;
+        if (admitted_waiter->priority == lane::BULK)
+        {
+            running_bulk += admitted_waiter->cost;
+        }
+        tenant_state &state = tenants[admitted_waiter->tenant];
+        state.waiting--;
+        state.running++;
+        state.served++;
+        admitted++;
+        any = true;
+    }
+    if (any)
+    {
+        granted.notify_all();
+    }
+}
+
+void GradingScheduler::release(const ticket &finished)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    running -= finished.cost;
+    if (finished.priority == lane::BULK)
+    {
+        running_bulk -= finished.cost;
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - finished.admitted;
+        bulk_seconds = 0.8 * bulk_seconds + 0.2 * seconds.count();
+    }
+    auto it = tenants.find(finished.tenant);
+    if (--it->second.running == 0 && it->second.waiting == 0)
+    {
+        tenants.erase(it);
+    }
+    grant();
+}
+
+std::size_t GradingScheduler::retry_after() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    // the waiting gradings run as many at a time as the cohorts fit the budget
+    double at_once = static_cast<double>(std::max<std::size_t>((budget - interactive_reserve) / bulk_cost, 1));
+    double seconds = std::ceil(bulk_seconds * static_cast<double>(waiting.size() + 1) / at_once);
+    return std::max<std::size_t>(static_cast<std::size_t>(seconds), 1);
+}
+
+GradingScheduler::stats GradingScheduler::statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return {budget, running, waiting.size(), admitted, refused};
+}
@@ -0,0 +1,130 @@
+/**
+ * @file grading_scheduler.h
+ * @brief This file contains the declaration of the GradingScheduler class.
+ * The class admits the gradings of the server against one budget of cores. Every request runs on a thread of its own
+ * and a cohort grading starts thread pools and DuckDB threads of its own, so without it the gradings of a few
+ * instructors at once oversubscribe the machine and all of them slow down.
+ * A grading waits for its share of the budget in one of two lanes. The interactive lane, the single submissions, goes
+ * first and has a part of the budget the bulk lane, the cohorts, cannot use. Within a lane the tenant with the fewest
+ * gradings running goes first, then the one served least since it became active, so the cohort of one instructor does
+ * not hold back the others. A grading is refused when too many are waiting, with the time after which to try again.
+ *
+ * @author Benard Wanjiru
+ * Contact: benard.wanjiru@ru.nl
+ */
+#ifndef GRADING_SCHEDULER_H
+#define GRADING_SCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class GradingScheduler
+{
+public:
+    enum class lane
+    {
+        INTERACTIVE,
+        BULK
+    };
+    /**
+     * An admitted grading. Its share of the budget is given back when the ticket is gone.
+     */
+    struct ticket
+    {
+        GradingScheduler &scheduler;
+        const std::string tenant;
+        const lane priority;
+        const std::size_t cost; /**< The cores of the grading. */
+        const std::chrono::steady_clock::time_point admitted;
+        ~ticket();
+    };
+    /**
+     * The counters of the scheduler.
+     */
+    struct stats
+    {
+        std::size_t budget;
+        std::size_t running; /**< The cores of the gradings that run. */
+        std::size_t waiting;
+        std::size_t admitted;
+        std::size_t refused;
+    };
+    /**
+     * @param budget: the cores the gradings use together.
+     * @param bulk_cost: the cores of a cohort grading, a single submission uses one.
+     * @param interactive_reserve: the cores only single submissions use.
+     * @param max_waiting: the number of gradings that can wait, see admit.
+     */
+    explicit GradingScheduler(std::size_t budget, std::size_t bulk_cost = 1, std::size_t interactive_reserve = 1, std::size_t max_waiting = 64);
+    GradingScheduler(const GradingScheduler &) = delete;
+    GradingScheduler &operator=(const GradingScheduler &) = delete;
+    /**
+     * This function waits until a grading fits the budget.
+     * @param tenant: the instructor or course the grading is for.
+     * @param priority: the lane of the grading.
+     * @param bounded: false for a grading that waits in a bounded queue of its own, see GradingJobs, it is never refused.
+     * @return: the ticket of the grading, null if it is refused because too many gradings are waiting.
+     */
+    std::shared_ptr<const ticket> admit(const std::string &tenant, lane priority, bool bounded = true);
+    /**
+     * This function estimates when a refused grading could be admitted.
+     * @return: the seconds until then, at least one.
+     */
+    std::size_t retry_after() const;
+    /**
+     * This function returns the counters of the scheduler.
+     */
+    stats statistics() const;
+
+private:
+    struct waiter
+    {
+        std::string tenant;
+        lane priority;
+        std::size_t cost;
+        bool granted = false;
+    };
+    /**
+     * The gradings of a tenant that run or wait.
+     */
+    struct tenant_state
+    {
+        std::size_t running = 0;
+        std::size_t waiting = 0;
+        std::size_t served = 0; /**< The gradings admitted since the tenant had none running or waiting. */
+    };
+    /**
+     * This function admits the waiting gradings that fit, the caller holds the mutex.
+     */
+    void grant();
+    /**
+     * This function returns the next grading of a lane, the end of the waiting list if there is none.
+     */
+    std::list<waiter *>::iterator next(lane priority);
+    /**
+     * This function gives back the share of a ticket, see ticket.
+     */
+    void release(const ticket &finished);
+
+    const std::size_t budget;
+    const std::size_t interactive_reserve;
+    const std::size_t bulk_cost;
+    const std::size_t max_waiting;
+    mutable std::mutex mutex;
+    std::condition_variable granted;
+    std::list<waiter *> waiting; /**< The waiting gradings, the oldest first. */
+    std::map<std::string, tenant_state> tenants;
+    std::size_t running = 0;
+    std::size_t running_bulk = 0;
+    std::size_t admitted = 0;
+    std::size_t refused = 0;
+    double bulk_seconds = 1; /**< The moving average of the time a cohort grading runs. */
+};
+
+#endif // GRADING_SCHEDULER_H
@@ -0,0 +1,108 @@
+#include "keyword_index.h"
+#include "sql_keywords.h"
+#include "utils.h"
+#include <algorithm>
+#include <cctype>
+
+KeywordIndex::KeywordIndex(const std::unordered_set<std::string> &keywords)
+    : keywords_(keywords)
+{
+    // insert in sorted order so the shape of the tree does not depend on the hash order of the set
+    std::vector<std::string> sorted(keywords.begin(), keywords.end());
+    std::sort(sorted.begin(), sorted.end());
+    nodes_.reserve(sorted.size());
+    for (const auto &keyword : sorted)
+    {
+        insert(keyword);
+    }
+}
+
+const KeywordIndex &KeywordIndex::sql_2016()
+{
+    static const KeywordIndex index(sql_keywords_2016);
+    return index;
+}
+
+bool KeywordIndex::contains(std::string word) const
+{
+    to_upper(word);
+    return keywords_.find(word) != keywords_.end();
+}
+
+std::vector<KeywordIndex::candidate> KeywordIndex::find_within(std::string word, int max_distance) const
+{
+    std::vector<candidate> candidates;
+    if (nodes_.empty())
+    {
+        return candidates;
+    }
+    to_upper(word);
+
+    Utils utils;
+    std::vector<std::size_t> pending = {0};
+    while (!pending.empty())
+    {
+        const bk_node &node = nodes_[pending.back()];
+        pending.pop_back();
+
+        int distance = static_cast<int>(utils.general_edit_distance(word, node.keyword));
+        if (distance <= max_distance)
+        {
+            candidates.push_back({node.keyword, distance});
+        }
+        // by the triangle inequality only children at distance [distance - max, distance + max] can match
+        for (const auto &[child_distance, child] : node.children)
+        {
+            if (child_distance >= distance - max_distance && child_distance <= distance + max_distance)
+            {
+                pending.push_back(child);
+            }
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const candidate &a, const candidate &b)
+              { return a.distance != b.distance ? a.distance < b.distance : a.keyword < b.keyword; });
+    return candidates;
+}
+
+std::size_t KeywordIndex::size() const
+{
+    return keywords_.size();
+}
+
+void KeywordIndex::insert(const std::string &keyword)
+{
+    if (nodes_.empty())
+    {
+        nodes_.push_back({keyword, {}});
+        return;
+    }
+
+    Utils utils;
+    std::size_t current = 0;
+    while (true)
+    {
+        int distance = static_cast<int>(utils.general_edit_distance(keyword, nodes_[current].keyword));
+        if (distance == 0)
+        {
+            return;
+        }
+        const auto &children = nodes_[current].children;
+        auto it = std::find_if(children.begin(), children.end(), [distance](const std::pair<int, std::size_t> &child)
+                               { return child.first == distance; });
+        if (it == children.end())
+        {
+            std::size_t child = nodes_.size();
+            nodes_.push_back({keyword, {}});
+            nodes_[current].children.emplace_back(distance, child);
+            return;
+        }
+        current = it->second;
+    }
+}
+
+void KeywordIndex::to_upper(std::string &word)
+{
+    std::transform(word.begin(), word.end(), word.begin(), [](unsigned char c)
+                   { return std::toupper(c); });
+}
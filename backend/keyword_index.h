@@ -0,0 +1,77 @@
+/**
+ * @file keyword_index.h
+ * @brief This file contains the declaration of the KeywordIndex class.
+ * The class indexes a set of SQL keywords for exact lookup and for finding the keywords that are within a small
+ * edit distance of a misspelled word. The near matches are found with a BK-tree, which only computes the distance
+ * to the keywords whose subtrees can still contain a match.
+ *
+ * @author Benard Wanjiru
+ * Contact: benard.wanjiru@ru.nl
+ */
+#ifndef KEYWORD_INDEX_H
+#define KEYWORD_INDEX_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <unordered_set>
+
+class KeywordIndex
+{
+public:
+    /**
+     * A keyword that is close to a searched word.
+     */
+    struct candidate
+    {
+        std::string keyword;
+        int distance; /**< The Levenshtein distance between the keyword and the searched word. */
+    };
+    /**
+     * Constructor that indexes the given keywords. The keywords are expected in upper case.
+     * @param keywords: the keywords to index.
+     */
+    explicit KeywordIndex(const std::unordered_set<std::string> &keywords);
+    /**
+     * This function returns the index of the SQL 2016 keywords. It is built once, on first use, and shared by all threads.
+     * @return: the index of sql_keywords_2016.
+     */
+    static const KeywordIndex &sql_2016();
+    /**
+     * This function checks whether a word is a keyword. The check is case-insensitive.
+     * @param word: the word to check.
+     * @return: true if the word is a keyword, false otherwise.
+     */
+    bool contains(std::string word) const;
+    /**
+     * This function finds the keywords within a maximum edit distance of a word. The search is case-insensitive.
+     * @param word: the word to search for.
+     * @param max_distance: the maximum Levenshtein distance of a candidate.
+     * @return: the candidates, closest first and then in alphabetical order.
+     */
+    std::vector<candidate> find_within(std::string word, int max_distance) const;
+    /**
+     * This function returns the number of keywords in the index.
+     */
+    std::size_t size() const;
+
+private:
+    /**
+     * A node of the BK-tree. Each child is stored with its distance to this node's keyword.
+     */
+    struct bk_node
+    {
+        std::string keyword;
+        std::vector<std::pair<int, std::size_t>> children;
+    };
+    std::unordered_set<std::string> keywords_;
+    std::vector<bk_node> nodes_;
+    /**
+     * This function adds a keyword to the BK-tree.
+     * @param keyword: the keyword to add.
+     */
+    void insert(const std::string &keyword);
+    static void to_upper(std::string &word);
+};
+
+#endif // KEYWORD_INDEX_H
@@ -54,6 +54,7 @@ string ModelQuery::get_fingerprint() const
 void ModelQuery::set_parse_tree(const std::shared_ptr<AbstractSyntaxTree::Node> &parse_tree)
 {
     this->parse_tree = parse_tree;
+    stmt_kind = AbstractSyntaxTree::get_statement_kind(parse_tree);
 }
 
 std::shared_ptr<AbstractSyntaxTree::Node> ModelQuery::get_parse_tree() const
@@ -61,6 +62,11 @@ std::shared_ptr<AbstractSyntaxTree::Node> ModelQuery::get_parse_tree() const
     return parse_tree;
 }
 
+AbstractSyntaxTree::statement_kind ModelQuery::get_statement_kind() const
+{
+    return stmt_kind;
+}
+
 void ModelQuery::create_abstract_syntax_tree()
 {
     AbstractSyntaxTree ast;
@@ -68,6 +74,7 @@ void ModelQuery::create_abstract_syntax_tree()
     nlohmann::json json_parse_tree_current = nlohmann::json::parse(result.parse_tree);
     parse_tree = std::make_shared<AbstractSyntaxTree::Node>("root", "");
     ast.build_tree(json_parse_tree_current, parse_tree);
+    stmt_kind = AbstractSyntaxTree::get_statement_kind(parse_tree);
 
     PgQueryProtobufParseResult protobuf_result = pg_query_parse_protobuf(value.c_str());
     parse_result = protobuf_result.parse_tree;
@@ -79,13 +86,58 @@ void ModelQuery::create_fingerprint()
     fingerprint = result.fingerprint_str;
 }
 
+void ModelQuery::create_clause_profile(bool with_goals)
+{
+    clause_profile = Goals::compile_query_profile(parse_tree, with_goals);
+}
+
+std::shared_ptr<const Goals::query_profile> ModelQuery::get_clause_profile() const
+{
+    if (clause_profile)
+    {
+        return clause_profile;
+    }
+    return Goals::compile_query_profile(parse_tree);
+}
+
+void ModelQuery::create_pq_gram_profile()
+{
+    pq_gram_profile = std::make_shared<const PqGram::profile>(PqGram::make_profile(parse_tree));
+}
+
+std::shared_ptr<const PqGram::profile> ModelQuery::get_pq_gram_profile() const
+{
+    if (pq_gram_profile)
+    {
+        return pq_gram_profile;
+    }
+    return std::make_shared<const PqGram::profile>(PqGram::make_profile(parse_tree));
+}
+
+void ModelQuery::create_words()
+{
+    Utils utils;
+    preprocessed_value = value;
+    utils.preprocess_query(preprocessed_value);
+    words = SqlLexer::intern_words(preprocessed_value);
+}
+
+const std::vector<SqlLexer::word_id> &ModelQuery::get_words() const
+{
+    return words;
+}
+
+const string &ModelQuery::get_preprocessed_value() const
+{
+    return preprocessed_value;
+}
+
 void ModelQuery::create_output(Query_Engine &qe)
 {
     try
     {
         //  Determine the type of statement from the parse tree.
-        std::string stmt_type = AbstractSyntaxTree::get_statement_type(get_parse_tree());
-        if (stmt_type == "SelectStmt")
+        if (get_statement_kind() == AbstractSyntaxTree::statement_kind::SELECT_STMT)
         {
             // For SELECT queries, generate outputs as usual.
             auto out = qe.execute_select(get_value());
@@ -182,3 +234,13 @@ std::vector<string> ModelQuery::get_goal_specific() const
 {
     return goal_specific;
 }
+
+void ModelQuery::set_pre_processed(bool pre_processed)
+{
+    this->pre_processed = pre_processed;
+}
+
+bool ModelQuery::is_pre_processed() const
+{
+    return pre_processed;
+}
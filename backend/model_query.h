@@ -19,6 +19,9 @@ extern "C"
 }
 #include "admin.h"
 #include "query_engine.h"
+#include "goals.h"
+#include "sql_lexer.h"
+#include "pq_gram.h"
 
 class ModelQuery
 {
@@ -84,6 +87,12 @@ public:
      * @return: the root node of the parse tree.
      */
     std::shared_ptr<AbstractSyntaxTree::Node> get_parse_tree() const;
+    /**
+     * This function returns the kind of statement of a query.
+     * It is resolved once when the abstract syntax tree is created.
+     * @return: the statement kind, or statement_kind::UNKNOWN if the tree has not been created.
+     */
+    AbstractSyntaxTree::statement_kind get_statement_kind() const;
     /**
      * This function an abstract syntax tree of a query.
      */
@@ -92,6 +101,45 @@ public:
      * This function creates a fingerprint of a query.
      */
     void create_fingerprint();
+    /**
+     * This function compiles the clause profile of a query from its parse tree.
+     * It is called once when the query is pre-processed, and again if the query is changed.
+     * @param with_goals: true to also generate the goals of its statements, which are only shown for a reference query.
+     */
+    void create_clause_profile(bool with_goals = true);
+    /**
+     * This function returns the clause profile of a query.
+     * If the profile has not been created, a new one is compiled from the parse tree but not stored.
+     * @return: the clause profile of the query, or nullptr if the query has no parse tree.
+     */
+    std::shared_ptr<const Goals::query_profile> get_clause_profile() const;
+    /**
+     * This function computes the pq-gram profile of a query from its parse tree, see PqGram::make_profile.
+     * It is called once when the query is pre-processed, and again if the query is changed.
+     */
+    void create_pq_gram_profile();
+    /**
+     * This function returns the pq-gram profile of a query.
+     * If the profile has not been created, a new one is computed from the parse tree but not stored.
+     * @return: the pq-gram profile of the query.
+     */
+    std::shared_ptr<const PqGram::profile> get_pq_gram_profile() const;
+    /**
+     * This function splits the preprocessed text of a query into interned words, see SqlLexer::intern_words.
+     * Syntax repair compares these words instead of splitting the text again for every pair of queries.
+     * It is called once when the query is pre-processed, and again if the query is changed.
+     */
+    void create_words();
+    /**
+     * This function returns the interned words of a query, empty if create_words has not been called.
+     * @return: the ids of the words of the preprocessed query.
+     */
+    const std::vector<SqlLexer::word_id> &get_words() const;
+    /**
+     * This function returns the preprocessed text the words were taken from, see Utils::preprocess_query.
+     * @return: the preprocessed query, empty if create_words has not been called.
+     */
+    const string &get_preprocessed_value() const;
     /**
      * This function creates the output of a query when it is executed.
      * The function is virtual because the StudentQuery class overrides it.
@@ -116,6 +164,13 @@ public:
     std::vector<string> get_goal_general() const;
     void set_goal_specific(const std::vector<string> &goal_specific);
     std::vector<string> get_goal_specific() const;
+    /**
+     * This function marks a query as pre-processed, see ProcessQueries::pre_process_model_query.
+     * The model queries of a registered quiz are pre-processed once and shared by all the gradings of the quiz.
+     * @param pre_processed: true if the tree, the profiles, the output and the goals of the query are created.
+     */
+    void set_pre_processed(bool pre_processed);
+    bool is_pre_processed() const;
 
 private:
     string id;                                            /**< The id of the query. */
@@ -124,7 +179,13 @@ private:
     string fingerprint;                                   /**< The fingerprint of the query as a hash string. */
     std::shared_ptr<AbstractSyntaxTree::Node> parse_tree; /**< The root node of the parse tree of the query. */
     PgQueryProtobuf parse_result;                         /**< The parse tree of the query. */
+    AbstractSyntaxTree::statement_kind stmt_kind = AbstractSyntaxTree::statement_kind::UNKNOWN; /**< The kind of statement of the query. */
+    std::shared_ptr<const Goals::query_profile> clause_profile;                                  /**< The clause profile of the query, shared between comparisons. */
+    std::shared_ptr<const PqGram::profile> pq_gram_profile;                                      /**< The pq-gram profile of the parse tree, shared between comparisons. */
+    string preprocessed_value;                                                                   /**< The query in lower case with single spaces. */
+    std::vector<SqlLexer::word_id> words;                                                        /**< The interned words of the preprocessed query. */
     std::vector<string> goal_general;                     /**< The general goal of the query. */
     std::vector<string> goal_specific;                    /**< The specific goal of the query. */
+    bool pre_processed = false;                           /**< Whether the query has been pre-processed. */
 };
 #endif // !MODEL_QUERY_H
\ No newline at end of file
@@ -2,10 +2,27 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
-#include <regex>
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include "sql_lexer.h"
 
 using namespace duckdb;
 
+namespace
+{
+    // transaction control that sneaks into submitted queries, removed before the query runs in our own transaction
+    const std::vector<std::vector<std::string_view>> transaction_words = {{"begin"}, {"commit"}, {"rollback"}};
+    const std::vector<std::vector<std::string_view>> transaction_control_words = {{"savepoint"}, {"release"}, {"set", "transaction"}};
+    // the statements that change the settings, the attached databases, the extensions or the files, which a rollback does not undo
+    const std::vector<StatementType> non_transactional_statements = {
+        StatementType::TRANSACTION_STATEMENT, StatementType::SET_STATEMENT, StatementType::VARIABLE_SET_STATEMENT,
+        StatementType::PRAGMA_STATEMENT, StatementType::CALL_STATEMENT, StatementType::VACUUM_STATEMENT,
+        StatementType::LOAD_STATEMENT, StatementType::EXTENSION_STATEMENT, StatementType::UPDATE_EXTENSIONS_STATEMENT,
+        StatementType::ATTACH_STATEMENT, StatementType::DETACH_STATEMENT, StatementType::COPY_STATEMENT,
+        StatementType::COPY_DATABASE_STATEMENT, StatementType::EXPORT_STATEMENT};
+}
+
 MyDuckDB::MyDuckDB()
     : db(nullptr)
 {
@@ -16,7 +33,6 @@ MyDuckDB::MyDuckDB(const std::string &filename)
     : db(nullptr)
 {
     using namespace std;
-    duckdb::Connection con(db);
 
     std::cout << "Using DuckDB database: " << std::endl;
 
@@ -34,19 +50,63 @@ MyDuckDB::MyDuckDB(const std::string &filename)
     file.close();
     string query = buffer.str();
 
-    // run the queries
-    auto result = con.Query(query);
-    if (!result->HasError())
+    // run the queries, unless another engine already did
+    try
     {
+        cached = DatabaseCache::shared().find_or_load(query);
+        db = cached->db;
         cout << "Successfully executed queries in file: " << filename << endl;
     }
-    else
+    catch (const std::runtime_error &e)
     {
         cerr << "Error executing queries in file: " << filename << endl;
-        cerr << result->GetError() << endl;
+        cerr << e.what() << endl;
         exit(1);
     }
 }
+
+MyDuckDB::MyDuckDB(std::shared_ptr<DatabaseCache::entry> cached)
+    : db(cached->db), cached(std::move(cached))
+{
+}
+
+bool MyDuckDB::is_read_only(duckdb::Connection &con, const std::string &query)
+{
+    try
+    {
+        for (const auto &statement : con.ExtractStatements(query))
+        {
+            if (statement->type != StatementType::SELECT_STATEMENT)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+}
+std::string MyDuckDB::outlives_transaction(duckdb::Connection &con, const std::string &query)
+{
+    try
+    {
+        for (const auto &statement : con.ExtractStatements(query))
+        {
+            if (std::find(non_transactional_statements.begin(), non_transactional_statements.end(), statement->type) != non_transactional_statements.end())
+            {
+                return StatementTypeToString(statement->type);
+            }
+        }
+    }
+    catch (const std::exception &)
+    {
+        // the query reports the parse error when it runs
+    }
+    return "";
+}
+
 std::vector<std::vector<std::string>> MyDuckDB::execute_query_select(const std::string &query, std::string &error)
 {
     duckdb::Connection con(db);
@@ -55,10 +115,23 @@ std::vector<std::vector<std::string>> MyDuckDB::execute_query_select(const std::
     bool transaction_started = false;
     // there are those queries that might sneak in a begin, commit, rollback, etc.
     // remove those phrases from the queries and proceed with the execution.
-    std::regex pattern(R"(\b(begin|commit|rollback)\b)", std::regex_constants::icase);
-
-    // Use regex_replace to replace the matched words with an empty string.
-    std::string new_query = std::regex_replace(query, pattern, "");
+    std::string new_query = SqlLexer::remove_phrases(query, transaction_words);
+    // the statements that are not a SELECT may write to a shared database, they run one at a time
+    std::shared_lock<std::shared_mutex> reading;
+    std::unique_lock<std::shared_mutex> writing;
+    if (cached)
+    {
+        std::string refused = outlives_transaction(con, new_query);
+        if (!refused.empty())
+        {
+            error = refused + " is not allowed on a shared database";
+            return data;
+        }
+        if (is_read_only(con, new_query))
+            reading = std::shared_lock<std::shared_mutex>(cached->statements);
+        else
+            writing = std::unique_lock<std::shared_mutex>(cached->statements);
+    }
 
     try
     {
@@ -141,17 +214,17 @@ std::vector<std::vector<std::string>> MyDuckDB::execute_query_not_select(const s
     bool transaction_started = false;
 
     // Remove any explicit BEGIN/COMMIT/ROLLBACK
-    std::regex pattern(R"(\b(begin|commit|rollback)\b)", std::regex_constants::icase);
-    std::string new_query = std::regex_replace(query, pattern, "");
+    std::string new_query = SqlLexer::remove_phrases(query, transaction_words);
     std::string lower_query = new_query;
     std::transform(lower_query.begin(), lower_query.end(), lower_query.begin(), ::tolower);
 
     //  1) Also strip SAVEPOINT, RELEASE, SET TRANSACTION
-    std::regex tx_pattern(R"(\b(savepoint|release|set\s+transaction)\b)", std::regex_constants::icase);
-    new_query = std::regex_replace(new_query, tx_pattern, "");
+    new_query = SqlLexer::remove_phrases(new_query, transaction_control_words);
 
     // 2) Trim leading/trailing whitespace and a trailing semicolon
-    new_query = std::regex_replace(new_query, std::regex(R"(^\s+|\s+$)"), "");
+    const char *whitespace = " \t\n\r\f\v";
+    std::size_t first = new_query.find_first_not_of(whitespace);
+    new_query = first == std::string::npos ? "" : new_query.substr(first, new_query.find_last_not_of(whitespace) - first + 1);
     if (!new_query.empty() && new_query.back() == ';')
     {
         new_query.pop_back();
@@ -165,6 +238,18 @@ std::vector<std::vector<std::string>> MyDuckDB::execute_query_not_select(const s
     }
 
     duckdb::Connection con(db);
+    // the changes are rolled back, but two transactions that write to the same table of a shared database conflict
+    std::unique_lock<std::shared_mutex> writing;
+    if (cached)
+    {
+        std::string refused = outlives_transaction(con, new_query);
+        if (!refused.empty())
+        {
+            error = refused + " is not allowed on a shared database";
+            return data;
+        }
+        writing = std::unique_lock<std::shared_mutex>(cached->statements);
+    }
     con.BeginTransaction();
     transaction_started = true;
 
@@ -639,13 +724,15 @@ Common::comparision_result MyDuckDB::compare(const results_info &ref, const resu
 
 bool MyDuckDB::execute_query_cud(const std::string &query, std::string &error)
 {
+    if (cached)
+    {
+        error = "A cached database is shared with other engines and cannot be changed";
+        return false;
+    }
     duckdb::Connection con(db);
     // there are those queries that might sneak in a begin, commit, rollback, etc.
     // remove those phrases from the queries and proceed with the execution.
-    std::regex pattern(R"(\b(begin|commit|rollback)\b)", std::regex_constants::icase);
-
-    // Use regex_replace to replace the matched words with an empty string.
-    std::string new_query = std::regex_replace(query, pattern, "");
+    std::string new_query = SqlLexer::remove_phrases(query, transaction_words);
 
     try
     {
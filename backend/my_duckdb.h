@@ -2,6 +2,7 @@
  * @file my_duckdb.h
  * @brief This file contains the declaration of the MyDuckDB class.
  * The class is used to connect to DuckDB and execute queries.
+ * A database made from a script comes from the DatabaseCache and is shared with the other engines of the same script.
  *
  * @author Benard Wanjiru
  * Contact: benard.wanjiru@ru.nl
@@ -10,10 +11,13 @@
 #define MY_DUCKDB_H
 
 #include "duckdb/duckdb.hpp"
+#include <memory>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 #include <iostream>
 #include "clauses/common.h"
+#include "database_cache.h"
 
 class MyDuckDB
 {
@@ -29,7 +33,16 @@ public:
         std::vector<diff> diffs;
     };
     MyDuckDB();
+    /**
+     * Opens the database made from the script in a file, see DatabaseCache.
+     * @param filename: the file of the script.
+     */
     MyDuckDB(const std::string &filename);
+    /**
+     * Opens a cached database.
+     * @param cached: the database, see DatabaseCache::find_or_load.
+     */
+    explicit MyDuckDB(std::shared_ptr<DatabaseCache::entry> cached);
     /**
      * Executes a query and returns the result.
      * @param query: the query to be executed.
@@ -40,12 +53,35 @@ public:
     std::vector<std::vector<std::string>> execute_query_not_select(const std::string &query, std::string &error);
     static results_info get_info(const std::vector<std::vector<std::string>> &data);
     static Common::comparision_result compare(const results_info &ref, const results_info &stu);
+    /**
+     * Executes a query and commits it. A cached database is shared and cannot be changed.
+     * @param query: the query to be executed.
+     * @param error: the error message if the query fails.
+     * @return true if the query is committed.
+     */
     bool execute_query_cud(const std::string &query, std::string &error);
 
     std::vector<std::string> get_column_types(const std::string &table_name);
 
 private:
+    /**
+     * This function checks that every statement of a query is a SELECT, see DatabaseCache::entry::statements.
+     * @param con: the connection the query runs on.
+     * @param query: the query.
+     * @return: false if a statement is not a SELECT or the query is not parseable.
+     */
+    static bool is_read_only(duckdb::Connection &con, const std::string &query);
+    /**
+     * This function finds a statement of a query whose effect outlives the transaction it runs in, such as SET,
+     * PRAGMA, ATTACH or CHECKPOINT. It is refused on a cached database, the next gradings would see its effect.
+     * @param con: the connection the query runs on.
+     * @param query: the query.
+     * @return: the type of the statement, empty if there is none or the query is not parseable.
+     */
+    static std::string outlives_transaction(duckdb::Connection &con, const std::string &query);
+
     duckdb::DuckDB db;
+    std::shared_ptr<DatabaseCache::entry> cached; /**< The cached database that db shares, null if db is its own. */
 };
 
 #endif // MY_DUCKDB_H
\ No newline at end of file
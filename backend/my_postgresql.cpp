@@ -1,6 +1,6 @@
 // MyPostgres.cpp
 #include "my_postgresql.h"
-#include <regex>
+#include "sql_lexer.h"
 #include <algorithm>
 #include <sstream>
 #include "clauses/common.h"
@@ -57,8 +57,7 @@ MyPostgres::execute_query_not_select(const std::string &query, std::string &erro
     std::vector<std::vector<std::string>> data;
 
     // Strip explicit transaction keywords
-    std::regex txrx(R"(\b(begin|commit|rollback)\b)", std::regex::icase);
-    std::string clean_q = std::regex_replace(query, txrx, "");
+    std::string clean_q = SqlLexer::remove_phrases(query, {{"begin"}, {"commit"}, {"rollback"}});
 
     try
     {
@@ -0,0 +1,124 @@
+#include "pq_gram.h"
+#include <algorithm>
+#include <functional>
+#include <string>
+
+namespace
+{
+    // the label of the padding nodes, no node label hashes to it
+    constexpr std::uint64_t empty_label = 0;
+
+    // splitmix64 finalizer, spreads the bits of a value over the whole word
+    std::uint64_t mix(std::uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    std::uint64_t label_hash(const AbstractSyntaxTree::Node &node)
+    {
+        std::uint64_t hash = mix(mix(node.kind) ^ std::hash<std::string>{}(node.value));
+        return hash == empty_label ? 1 : hash;
+    }
+
+    std::uint64_t gram_hash(const std::vector<std::uint64_t> &stem, const std::vector<std::uint64_t> &base)
+    {
+        std::uint64_t hash = 0;
+        for (std::uint64_t label : stem)
+        {
+            hash = mix(hash ^ label);
+        }
+        for (std::uint64_t label : base)
+        {
+            hash = mix(hash ^ label);
+        }
+        return hash;
+    }
+
+    /**
+     * This recursive function adds the pq-grams of which a node is the anchor, then those of its descendants.
+     * @param node: the anchor node.
+     * @param ancestors: the labels of the p-1 closest ancestors of the node, the furthest first.
+     * @param q: the number of children in a pq-gram.
+     * @param result: the profile the pq-grams are added to.
+     */
+    void add_grams(const AbstractSyntaxTree::Node &node, const std::vector<std::uint64_t> &ancestors, std::size_t q, PqGram::profile &result)
+    {
+        // the stem is the node with its ancestors, the closest ancestors of a child are the stem without its furthest label
+        std::vector<std::uint64_t> stem(ancestors);
+        stem.push_back(label_hash(node));
+        std::vector<std::uint64_t> child_ancestors(stem.begin() + 1, stem.end());
+
+        std::vector<std::uint64_t> base(q, empty_label);
+        if (node.children.empty())
+        {
+            result.push_back(gram_hash(stem, base));
+            return;
+        }
+        // slide a window of q children over the children padded with q-1 empty nodes on both sides
+        auto shift_in = [&](std::uint64_t label)
+        {
+            std::rotate(base.begin(), base.begin() + 1, base.end());
+            base.back() = label;
+            result.push_back(gram_hash(stem, base));
+        };
+        for (const auto &child : node.children)
+        {
+            shift_in(label_hash(*child));
+            add_grams(*child, child_ancestors, q, result);
+        }
+        for (std::size_t i = 1; i < q; i++)
+        {
+            shift_in(empty_label);
+        }
+    }
+}
+
+PqGram::profile PqGram::make_profile(const std::shared_ptr<AbstractSyntaxTree::Node> &tree, std::size_t p, std::size_t q)
+{
+    profile result;
+    if (!tree || p == 0 || q == 0)
+    {
+        return result;
+    }
+    add_grams(*tree, std::vector<std::uint64_t>(p - 1, empty_label), q, result);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::size_t PqGram::shared_grams(const profile &profile1, const profile &profile2)
+{
+    // both bags are sorted, so equal hashes are matched in one merge pass
+    std::size_t shared = 0;
+    auto it1 = profile1.begin(), it2 = profile2.begin();
+    while (it1 != profile1.end() && it2 != profile2.end())
+    {
+        if (*it1 < *it2)
+        {
+            ++it1;
+        }
+        else if (*it2 < *it1)
+        {
+            ++it2;
+        }
+        else
+        {
+            shared++;
+            ++it1;
+            ++it2;
+        }
+    }
+    return shared;
+}
+
+double PqGram::distance(const profile &profile1, const profile &profile2)
+{
+    std::size_t total = profile1.size() + profile2.size();
+    if (total == 0)
+    {
+        return 0.0;
+    }
+    return 1.0 - 2.0 * shared_grams(profile1, profile2) / total;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file pq_gram.h
+ * @brief This file contains the declaration of the PqGram class.
+ * The class computes the pq-gram profile of a parse tree and the pq-gram distance between two profiles, an
+ * approximation of the tree edit distance. A pq-gram is a small subtree made of a node with its p-1 closest ancestors
+ * and q consecutive children, padded with empty nodes at the borders. Each pq-gram is hashed into 64 bits, so a
+ * profile is a sorted bag of hashes and two profiles are compared by merging them.
+ * The approach is based on the paper: Augsten, Nikolaus & Böhlen, Michael & Gamper, Johann. (2005). Approximate Matching of Hierarchical Data Using pq-Grams. VLDB 2005. 301-312.
+ *
+ * @author Benard Wanjiru
+ * Contact: benard.wanjiru@ru.nl
+ */
+#ifndef PQ_GRAM_H
+#define PQ_GRAM_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "abstract_syntax_tree.h"
+
+class PqGram
+{
+public:
+    /**
+     * The pq-grams of a tree, each hashed into 64 bits, in increasing order. Equal pq-grams are kept.
+     */
+    using profile = std::vector<std::uint64_t>;
+    /**
+     * The number of ancestors, including the node itself, in a pq-gram.
+     */
+    static constexpr std::size_t default_p = 2;
+    /**
+     * The number of consecutive children in a pq-gram.
+     */
+    static constexpr std::size_t default_q = 3;
+    /**
+     * This function computes the pq-gram profile of a tree. A node is labelled by its key and its value, as in
+     * TreeEditDistance::edit_weight. The profile of a tree with n nodes has at most n * q pq-grams.
+     * @param tree: the root of the tree.
+     * @param p: the number of ancestors in a pq-gram, at least 1.
+     * @param q: the number of children in a pq-gram, at least 1.
+     * @return: the profile of the tree, empty if the tree is null.
+     */
+    static profile make_profile(const std::shared_ptr<AbstractSyntaxTree::Node> &tree, std::size_t p = default_p, std::size_t q = default_q);
+    /**
+     * This function counts the pq-grams that two profiles share, counting repeated pq-grams as often as both have them.
+     * @param profile1: the first profile.
+     * @param profile2: the second profile.
+     * @return: the size of the bag intersection of the profiles.
+     */
+    static std::size_t shared_grams(const profile &profile1, const profile &profile2);
+    /**
+     * This function computes the normalized pq-gram distance, 1 - 2|P ∩ Q| / (|P| + |Q|).
+     * Equal trees have distance 0 and trees without a common pq-gram have distance 1.
+     * @param profile1: the first profile.
+     * @param profile2: the second profile.
+     * @return: the distance between the profiles, from 0 to 1.
+     */
+    static double distance(const profile &profile1, const profile &profile2);
+};
+
+#endif // PQ_GRAM_H
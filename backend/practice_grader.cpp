@@ -0,0 +1,100 @@
+#include "practice_grader.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <utility>
+#include "grader.h"
+
+PracticeGrader::PracticeGrader(std::shared_ptr<const QuizStore::quiz> registered, std::size_t engines, std::size_t max_answers)
+    : registered(std::move(registered)), max_answers(max_answers),
+      correct_index(this->registered->admin.get_tree_edit_distance_algorithm())
+{
+    // the engines of a PostgreSQL quiz would load their tables into the same database
+    std::size_t count = this->registered->db_opts.use_postgresql ? 1 : std::max<std::size_t>(engines, 1);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        auto engine = std::make_unique<Query_Engine>(this->registered->db_opts);
+        engine->initialize();
+        idle.push_back(engine.get());
+        pool.push_back(std::move(engine));
+    }
+}
+
+PracticeGrader::~PracticeGrader()
+{
+    for (auto &engine : pool)
+    {
+        try
+        {
+            engine->clear();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Clearing a practice engine failed: " << e.what() << std::endl;
+        }
+    }
+}
+
+Query_Engine *PracticeGrader::acquire()
+{
+    std::unique_lock<std::mutex> lock(pool_mutex);
+    engine_released.wait(lock, [this]()
+                         { return !idle.empty(); });
+    Query_Engine *engine = idle.back();
+    idle.pop_back();
+    return engine;
+}
+
+void PracticeGrader::release(Query_Engine *engine)
+{
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        idle.push_back(engine);
+    }
+    engine_released.notify_one();
+}
+
+ProcessQueries::grading_info PracticeGrader::grade(StudentQuery submission)
+{
+    // pre-processing the model queries again is skipped, but the analysis may still write to them
+    std::vector<ModelQuery> model_queries = registered->model_queries;
+    Grader grader;
+    bool is_correct_answer = false;
+    Query_Engine *engine = acquire();
+    try
+    {
+        std::shared_lock lock(bank_mutex);
+        is_correct_answer = ProcessQueries::grade_submission(&submission, registered->admin, grader, model_queries, correct_answers,
+                                                             repair_index, correct_index, *engine);
+    }
+    catch (...)
+    {
+        release(engine);
+        throw;
+    }
+    release(engine);
+
+    if (is_correct_answer)
+    {
+        std::unique_lock lock(bank_mutex);
+        if (correct_answers.size() < max_answers && answer_texts.insert(submission.get_preprocessed_value()).second)
+        {
+            std::size_t position = correct_answers.size();
+            repair_index.add(position, submission.get_words());
+            correct_index.insert(position, submission.get_parse_tree());
+            correct_answers.push_back(submission);
+        }
+    }
+    return ProcessQueries::get_grading_info(submission, registered->admin);
+}
+
+std::size_t PracticeGrader::bank_size() const
+{
+    std::shared_lock lock(bank_mutex);
+    return correct_answers.size();
+}
+
+std::size_t PracticeGrader::engines() const
+{
+    return pool.size();
+}
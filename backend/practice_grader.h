@@ -0,0 +1,98 @@
+/**
+ * @file practice_grader.h
+ * @brief This file contains the declaration of the PracticeGrader class.
+ * The class grades single submissions of a registered quiz, as a student practicing the quiz submits them one at a time.
+ * A cohort grading loads the database of the quiz, pre-processes its model queries and groups its answers before the
+ * first student is graded; none of that depends on the submission, so the class keeps it warm between submissions:
+ * a pool of engines with the database of the quiz already loaded, the pre-processed model queries of the registered
+ * quiz and a bank of the correct answers submitted so far, which stands in for the other queries of a cohort.
+ *
+ * @author Benard Wanjiru
+ * Contact: benard.wanjiru@ru.nl
+ */
+#ifndef PRACTICE_GRADER_H
+#define PRACTICE_GRADER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "process_queries.h"
+#include "query_engine.h"
+#include "quiz_store.h"
+#include "repair_index.h"
+#include "student_query.h"
+#include "tree_metric_index.h"
+
+class PracticeGrader
+{
+public:
+    /**
+     * The number of engines of the pool, see the constructor.
+     */
+    static constexpr std::size_t default_engines = 4;
+    /**
+     * The number of correct answers the bank keeps.
+     */
+    static constexpr std::size_t default_max_answers = 1000;
+    /**
+     * The constructor loads the database of the quiz into each engine of the pool.
+     * @param registered: the registered quiz, see QuizStore::add.
+     * @param engines: the number of submissions graded at the same time. A quiz on PostgreSQL has one engine, because
+     * the engines of a PostgreSQL quiz share one database.
+     * @param max_answers: the number of correct answers the bank keeps, the first ones submitted.
+     */
+    explicit PracticeGrader(std::shared_ptr<const QuizStore::quiz> registered, std::size_t engines = default_engines,
+                            std::size_t max_answers = default_max_answers);
+    /**
+     * The destructor clears the databases of the engines.
+     */
+    ~PracticeGrader();
+    PracticeGrader(const PracticeGrader &) = delete;
+    PracticeGrader &operator=(const PracticeGrader &) = delete;
+    /**
+     * This function grades a submission. It waits for a free engine if all of them are grading.
+     * A correct answer that is not in the bank yet is added to it.
+     * @param submission: the student query.
+     * @return: the grading of the submission.
+     */
+    ProcessQueries::grading_info grade(StudentQuery submission);
+    /**
+     * This function returns the number of correct answers in the bank.
+     */
+    std::size_t bank_size() const;
+    /**
+     * This function returns the number of engines of the pool.
+     */
+    std::size_t engines() const;
+
+private:
+    /**
+     * This function takes a free engine from the pool, waiting for one if there is none.
+     */
+    Query_Engine *acquire();
+    /**
+     * This function returns an engine to the pool.
+     */
+    void release(Query_Engine *engine);
+
+    const std::shared_ptr<const QuizStore::quiz> registered;
+    const std::size_t max_answers;
+
+    std::vector<std::unique_ptr<Query_Engine>> pool;
+    std::vector<Query_Engine *> idle;
+    std::mutex pool_mutex;
+    std::condition_variable engine_released;
+
+    mutable std::shared_mutex bank_mutex;
+    std::vector<StudentQuery> correct_answers; /**< The correct answers, by position in the indexes below. */
+    std::set<std::string> answer_texts;        /**< The preprocessed texts of the correct answers. */
+    RepairIndex repair_index;
+    TreeMetricIndex correct_index;
+};
+
+#endif // PRACTICE_GRADER_H
@@ -1,4 +1,5 @@
 #include "process_queries.h"
+#include <algorithm>
 #include <iostream>
 #include <pg_query.h>
 #include "utils.h"
@@ -10,10 +11,12 @@
 #include "goals.h"
 #include <mutex>
 #include <exception>
+#include <stdexcept>
 #include <thread>
 #include <semaphore>
 #include <queue>
 #include <atomic>
+#include <unordered_map>
 #include "thread_pool.h"
 
 using namespace std;
@@ -35,11 +38,24 @@ ProcessQueries::ProcessQueries()
 {
 }
 
-ProcessQueries::ProcessQueries(std::vector<ModelQuery> &model_queries, std::vector<StudentQuery> &student_queries, Admin::database_options db_opts,
-                               const Admin &admin, Grader &grader)
+ProcessQueries::ProcessQueries(std::vector<ModelQuery> &model_queries, std::vector<StudentQuery> &all_student_queries, Admin::database_options db_opts,
+                               const Admin &admin, Grader &grader, progress *job_progress, const graded_callback &on_graded, std::size_t threads)
     : query_engine(db_opts) // ← initialize our engine
 {
     query_engine.initialize();
+    // students that submitted the same answer are graded once, the stages below only see one query per answer
+    std::vector<StudentQuery> student_queries = group_student_queries(all_student_queries, answer_class);
+    // the stages report to a local counter when nobody follows the progress
+    progress unreported;
+    progress &stage_progress = job_progress ? *job_progress : unreported;
+    stage_progress.students = all_student_queries.size();
+    stage_progress.answers = student_queries.size();
+    std::vector<std::vector<std::size_t>> students_of_answer(student_queries.size());
+    for (size_t i = 0; i < all_student_queries.size(); i++)
+    {
+        students_of_answer.at(answer_class.at(i)).push_back(i);
+    }
+    std::cout << "Grading " << student_queries.size() << " distinct answers of " << all_student_queries.size() << " students" << std::endl;
     Goals goals;
     // Initialize the worker threads
     std::vector<std::thread> workers;
@@ -61,13 +77,14 @@ ProcessQueries::ProcessQueries(std::vector<ModelQuery> &model_queries, std::vect
     {
         StudentQuery *student_query = &student_queries.at(i);
 
-        pool.enqueue([this, student_query, &cout_mutex, &db_opts]()
+        pool.enqueue([this, student_query, &cout_mutex, &db_opts, &stage_progress]()
                      {
             {
                 std::cout << "Pre-processing student query " << student_query->get_id() << std::endl;
             }
 
-            this->pre_process_student_query(student_query, db_opts); });
+            this->pre_process_student_query(student_query, db_opts);
+            stage_progress.pre_processed++; });
     }
 
     // Wait for tasks to complete
@@ -75,11 +92,27 @@ ProcessQueries::ProcessQueries(std::vector<ModelQuery> &model_queries, std::vect
 
     // Syntax analysis
     std::cout << "Syntax analysis started..." << std::endl;
+    // index the parseable queries once, unparseable queries are only repaired with the nearest of them
+    RepairIndex repair_index;
+    for (size_t i = 0; i < student_queries.size(); i++)
+    {
+        if (student_queries.at(i).is_parseable())
+        {
+            repair_index.add(i, student_queries.at(i).get_words());
+        }
+    }
     for (size_t i = 0; i < student_queries.size(); i++)
     {
         StudentQuery *student_query = &student_queries.at(i);
         std::cout << "Syntax: processing student query " << student_query->get_id() << std::endl;
-        analyze_syntax(student_query, admin, model_queries, student_queries, query_engine);
+        bool was_parseable = student_query->is_parseable();
+        analyze_syntax(student_query, admin, model_queries, student_queries, query_engine, repair_index);
+        // a repaired query can in turn repair the queries after it
+        if (!was_parseable && student_query->is_parseable())
+        {
+            repair_index.add(i, student_query->get_words());
+        }
+        stage_progress.syntax++;
     }
 
     // Wait for tasks to complete
@@ -93,14 +126,15 @@ ProcessQueries::ProcessQueries(std::vector<ModelQuery> &model_queries, std::vect
         StudentQuery *student_query = &student_queries.at(i);
         int sz = student_queries.size();
 
-        pool.enqueue([student_query, i, &admin, &model_queries, &cout_mutex, &sz]()
+        pool.enqueue([student_query, i, &admin, &model_queries, &cout_mutex, &sz, &stage_progress]()
                      {
             {
                 std::lock_guard<std::mutex> lock(cout_mutex);
                 std::cout << "Results: Processing student query " << i + 1 << " of " << sz << std::endl;
             }
 
-            analyze_results(student_query, admin, model_queries.at(0).get_output()); });
+            analyze_results(student_query, admin, model_queries.at(0).get_output());
+            stage_progress.results++; });
     }
 
     // Wait for tasks to complete
@@ -109,47 +143,57 @@ ProcessQueries::ProcessQueries(std::vector<ModelQuery> &model_queries, std::vect
 
     // Semantics analysis
     std::cout << "Semantics analysis started..." << std::endl;
+    // the close pairs of the cohort are computed once, in parallel, and semantics analysis looks them up.
+    // the pq-gram prefilter does not use them
+    const bool use_distance_matrix = admin.get_semantics_prefilter() == Admin::semantics_prefilter::NONE;
+    if (use_distance_matrix)
+    {
+        std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> trees;
+        std::vector<std::string> texts;
+        for (const auto &student_query : student_queries)
+        {
+            trees.push_back(student_query.is_parseable() ? student_query.get_parse_tree() : nullptr);
+            texts.push_back(student_query.get_preprocessed_value());
+        }
+        ThreadPool distance_pool(std::max<std::size_t>(threads, 1));
+        distance_matrix.compute(trees, texts, admin.get_semantics_minor_incorrect_ted(), admin.get_syntax_minor_incorrect_ted(),
+                                admin.get_tree_edit_distance_algorithm(), distance_pool);
+    }
     for (size_t i = 0; i < student_queries.size(); i++)
     {
         StudentQuery *student_query = &student_queries.at(i);
+        const std::vector<DistanceMatrix::entry> *neighbours = use_distance_matrix ? &distance_matrix.neighbours(i) : nullptr;
 
-        pool.enqueue([student_query, i, &admin, &model_queries, &student_queries, &cout_mutex]()
+        pool.enqueue([this, student_query, i, &admin, &grader, &model_queries, &student_queries, &all_student_queries, &students_of_answer,
+                      &cout_mutex, neighbours, &stage_progress, &on_graded]()
                      {
             {
                 std::lock_guard<std::mutex> lock(cout_mutex); 
                 std::cout << "Semantics: Processing student query " << i + 1 << " of " << student_queries.size() << std::endl;
             }
 
-            analyze_semantics(student_query, admin, model_queries, student_queries); });
+            analyze_semantics(student_query, admin, model_queries, student_queries, neighbours);
+            stage_progress.semantics++;
+
+            // the grade of an answer is final once its semantics are known, so its students are graded right away.
+            // the answer itself is left as it is, the semantics analysis of the answers after it still compares with it
+            StudentQuery graded_answer = *student_query;
+            grade_answer(&graded_answer, admin, grader);
+            for (std::size_t student : students_of_answer.at(i))
+            {
+                all_student_queries.at(student).copy_grading(graded_answer);
+                if (on_graded)
+                {
+                    std::lock_guard<std::mutex> lock(cout_mutex);
+                    on_graded(student, get_grading_info(all_student_queries.at(student), admin));
+                }
+            }
+            stage_progress.graded++; });
     }
 
     // Wait for tasks to complete
     pool.wait_until_empty();
-    std::cout << "Semantics analysis finished" << std::endl;
-
-    // Grading the queries
-    std::cout << "Grading the queries started..." << std::endl;
-    for (size_t i = 0; i < student_queries.size(); i++)
-    {
-        StudentQuery *student_query = &student_queries.at(i);
-        student_query->post_process(admin);
-
-        // Get the correctness level and the normalized value
-        std::pair<int, double> correctness_level = grader.calculate_correctness_level(
-            admin.get_syntax_sensitivity(),
-            admin.get_semantics_sensitivity(),
-            admin.get_results_sensitivity(),
-            admin.get_property_order(),
-            student_query->get_results_outcome(),
-            student_query->get_semantics_outcome(),
-            student_query->get_syntax_outcome());
-
-        student_query->set_correctness_level(correctness_level.first);
-        student_query->set_normalized_value(correctness_level.second);
-        student_query->set_grade(admin);
-    }
-
-    std::cout << "Grading the queries finished." << std::endl;
+    std::cout << "Semantics analysis and grading finished" << std::endl;
     // clear the engine
     query_engine.clear();
 }
@@ -252,6 +296,8 @@ void ProcessQueries::output_results_more(const vector<StudentQuery> *queries, co
                  << ","
                  << "tree edit distance"
                  << ","
+                 << "repair candidates"
+                 << ","
                  << "error"
                  << '\n';
     // write the queries
@@ -321,147 +367,190 @@ void ProcessQueries::output_results_more(const vector<StudentQuery> *queries, co
                      << ","
                      << queries->at(i).get_tree_edit_distance()
                      << ","
+                     << queries->at(i).get_repair_candidates()
+                     << ","
                      << execution_error
                      << '\n';
     }
 }
 
 std::vector<ProcessQueries::grading_info> ProcessQueries::get_grading_info(const vector<StudentQuery> *queries, const Admin &admin)
+{
+    vector<grading_info> grading_info_vector;
+    for (const auto &query : *queries)
+    {
+        grading_info_vector.push_back(get_grading_info(query, admin));
+    }
+    return grading_info_vector;
+}
+
+ProcessQueries::grading_info ProcessQueries::get_grading_info(const StudentQuery &student_query, const Admin &admin)
 {
     using namespace std;
 
-    vector<grading_info> grading_info_vector;
+    grading_info info;
+    // use the original query if the query was edited.
+    string query = student_query.is_value_changed() ? student_query.get_old_value() : student_query.get_value();
 
-    // write the queries
-    for (size_t i = 0; i < queries->size(); i++)
+    // calculate final grade
+    double grade;
+    double normalized_value = student_query.get_normalized_value();
+    /*if (admin.get_num_of_syntax_outcomes() == 1 && admin.get_num_of_semantics_outcomes() == 1 && admin.get_num_of_results_outcomes() == 1)
     {
-        grading_info info;
-        // use the original query if the query was edited.
-        string query = queries->at(i).is_value_changed() ? queries->at(i).get_old_value() : queries->at(i).get_value();
-
-        // calculate final grade
-        double grade;
-        double normalized_value = queries->at(i).get_normalized_value();
-        /*if (admin.get_num_of_syntax_outcomes() == 1 && admin.get_num_of_semantics_outcomes() == 1 && admin.get_num_of_results_outcomes() == 1)
-        {
-            normalized_value = normalized_value == 1 ? 1 : 0;
-            grade = final_grade(0.0, 1.0, normalized_value);
-        }
-        else
-        {*/
+        normalized_value = normalized_value == 1 ? 1 : 0;
         grade = final_grade(0.0, 1.0, normalized_value);
-        //}
+    }
+    else
+    {*/
+    grade = final_grade(0.0, 1.0, normalized_value);
+    //}
+
+    // Escape double quotes
+    size_t pos = 0;
+    bool query_escaped = false;
+    while ((pos = query.find('"', pos)) != std::string::npos)
+    {
+        query.replace(pos, 1, "\"\"");
+        pos += 2; // move past the inserted characters
+        query_escaped = true;
+    }
 
-        // Escape double quotes
-        size_t pos = 0;
-        bool query_escaped = false;
-        while ((pos = query.find('"', pos)) != std::string::npos)
-        {
-            query.replace(pos, 1, "\"\"");
-            pos += 2; // move past the inserted characters
-            query_escaped = true;
-        }
+    // surround the queries with quotes if it contains any commas.
+    // this is because we are using commas as separator in the csv file
+    if (query.find(',') != string::npos || query_escaped)
+    {
+        query = '"' + query + '"';
+    }
+    string corrected_query = student_query.is_value_changed() ? student_query.get_value() : "";
+    if (corrected_query.find(',') != string::npos)
+    {
+        corrected_query = '"' + corrected_query + '"';
+    }
 
-        // surround the queries with quotes if it contains any commas.
-        // this is because we are using commas as separator in the csv file
-        if (query.find(',') != string::npos || query_escaped)
-        {
-            query = '"' + query + '"';
-        }
-        string corrected_query = queries->at(i).is_value_changed() ? queries->at(i).get_value() : "";
-        if (corrected_query.find(',') != string::npos)
-        {
-            corrected_query = '"' + corrected_query + '"';
-        }
+    // surround the error message with quotes if it contains any commas.
+    string execution_error = student_query.get_execution_error();
+    // remove newline characters from the error message
+    execution_error.erase(std::remove(execution_error.begin(), execution_error.end(), '\n'), execution_error.end());
+    execution_error.erase(std::remove(execution_error.begin(), execution_error.end(), '\r'), execution_error.end());
+    // replace " with ' in the error message
+    // std::replace(execution_error.begin(), execution_error.end(), '"', '\'');
+    /*if (execution_error.find(',') != string::npos)
+    {
+        execution_error = '"' + execution_error + '"';
+    }*/
+    // get the feedback
+    string feedback = student_query.get_feedback();
+    // create a long text containing the feedback and the error message
+    if (execution_error != "")
+    {
+        feedback = feedback + ". " + execution_error;
+    }
+    // construct grader comments based on the order of importance
+    string grader_comments = "";
+    switch (admin.get_property_order())
+    {
+    case Grader::property_order::SY_SM_RE:
+        grader_comments = "This quiz was graded as an introductory quiz. We placed more weight on syntax, then semantics and finally results.";
+        break;
+    case Grader::property_order::SM_SY_RE:
+        grader_comments = "This quiz was graded as an intermediate quiz. We placed more weight on semantics, then syntax and finally results.";
+        break;
+    case Grader::property_order::RE_SM_SY:
+        grader_comments = "This quiz was graded as an advanced quiz. We placed more weight on results, then semantics and finally syntax.";
+        break;
+    default:
+        grader_comments = "There was an error in grading this quiz.";
+        break;
+    }
 
-        // surround the error message with quotes if it contains any commas.
-        string execution_error = queries->at(i).get_execution_error();
-        // remove newline characters from the error message
-        execution_error.erase(std::remove(execution_error.begin(), execution_error.end(), '\n'), execution_error.end());
-        execution_error.erase(std::remove(execution_error.begin(), execution_error.end(), '\r'), execution_error.end());
-        // replace " with ' in the error message
-        // std::replace(execution_error.begin(), execution_error.end(), '"', '\'');
-        /*if (execution_error.find(',') != string::npos)
-        {
-            execution_error = '"' + execution_error + '"';
-        }*/
-        // get the feedback
-        string feedback = queries->at(i).get_feedback();
-        // create a long text containing the feedback and the error message
-        if (execution_error != "")
-        {
-            feedback = feedback + ". " + execution_error;
-        }
-        // construct grader comments based on the order of importance
-        string grader_comments = "";
-        switch (admin.get_property_order())
-        {
-        case Grader::property_order::SY_SM_RE:
-            grader_comments = "This quiz was graded as an introductory quiz. We placed more weight on syntax, then semantics and finally results.";
-            break;
-        case Grader::property_order::SM_SY_RE:
-            grader_comments = "This quiz was graded as an intermediate quiz. We placed more weight on semantics, then syntax and finally results.";
-            break;
-        case Grader::property_order::RE_SM_SY:
-            grader_comments = "This quiz was graded as an advanced quiz. We placed more weight on results, then semantics and finally syntax.";
-            break;
-        default:
-            grader_comments = "There was an error in grading this quiz.";
-            break;
-        }
+    // add grader comments to the feedback
+    feedback = feedback + ". " + grader_comments;
 
-        // add grader comments to the feedback
-        feedback = feedback + ". " + grader_comments;
+    // Escape double quotes
+    /*pos = 0;
+    bool feedback_escaped = false;
+    while ((pos = feedback.find('"', pos)) != std::string::npos)
+    {
+        feedback.replace(pos, 1, "\"\"");
+        pos += 2; // move past the inserted characters
+        feedback_escaped = true;
+    }
 
-        // Escape double quotes
-        /*pos = 0;
-        bool feedback_escaped = false;
-        while ((pos = feedback.find('"', pos)) != std::string::npos)
-        {
-            feedback.replace(pos, 1, "\"\"");
-            pos += 2; // move past the inserted characters
-            feedback_escaped = true;
-        }
+    //surround the feedback with quotes if it contains any commas.
+    if (feedback.find(',') != string::npos || feedback_escaped)
+    {
+        feedback = '"' + feedback + '"';
+    }*/
 
-        //surround the feedback with quotes if it contains any commas.
-        if (feedback.find(',') != string::npos || feedback_escaped)
-        {
-            feedback = '"' + feedback + '"';
-        }*/
+    std::string message = student_query.construct_message();
 
-        std::string message = queries->at(i).construct_message();
+    // Escape double quotes
+    pos = 0;
+    bool message_escaped = false;
+    while ((pos = message.find('"', pos)) != std::string::npos)
+    {
+        message.replace(pos, 1, "\"\"");
+        pos += 2; // move past the inserted characters
+        message_escaped = true;
+    }
 
-        // Escape double quotes
-        pos = 0;
-        bool message_escaped = false;
-        while ((pos = message.find('"', pos)) != std::string::npos)
-        {
-            message.replace(pos, 1, "\"\"");
-            pos += 2; // move past the inserted characters
-            message_escaped = true;
-        }
+    // surround the message with quotes if it contains any commas.
+    // if (message.find(',') != std::string::npos || message_escaped)
+    {
+        message = '"' + message + '"';
+    }
 
-        // surround the message with quotes if it contains any commas.
-        // if (message.find(',') != std::string::npos || message_escaped)
-        {
-            message = '"' + message + '"';
-        }
+    info.org_defined_id = student_query.get_id();
+    info.attempt_number = student_query.get_attempt_number();
+    info.question_number = student_query.get_question_number();
+    info.query = query;
+    info.grade = grade;
+    info.out_of = 1;
+    info.feedback = message;
 
-        info.org_defined_id = queries->at(i).get_id();
-        info.attempt_number = queries->at(i).get_attempt_number();
-        info.question_number = queries->at(i).get_question_number();
-        info.query = query;
-        info.grade = grade;
-        info.out_of = 1;
-        info.feedback = message;
+    return info;
+}
+
+std::size_t ProcessQueries::get_answer_class(std::size_t position) const
+{
+    return answer_class.at(position);
+}
 
-        grading_info_vector.push_back(info);
+std::vector<StudentQuery> ProcessQueries::group_student_queries(const vector<StudentQuery> &student_queries, std::vector<std::size_t> &answer_class)
+{
+    std::vector<StudentQuery> representatives;
+    std::unordered_map<std::string, std::size_t> class_of_text;
+    answer_class.clear();
+    for (const auto &student_query : student_queries)
+    {
+        // collapse the spaces as Utils::preprocess_query does, but keep the case since it can change the results of a query.
+        // equal texts parse into the same tree, so they also have the same fingerprint
+        std::string text = student_query.get_value();
+        text.erase(std::unique(text.begin(), text.end(), Utils::both_are_spaces), text.end());
+        auto [it, inserted] = class_of_text.emplace(text, representatives.size());
+        if (inserted)
+        {
+            representatives.push_back(student_query);
+        }
+        answer_class.push_back(it->second);
     }
-    return grading_info_vector;
+    return representatives;
+}
+
+const DistanceMatrix &ProcessQueries::get_distance_matrix() const
+{
+    return distance_matrix;
 }
 
 void ProcessQueries::pre_process_student_query(StudentQuery *student_query, Admin::database_options db_opts)
 {
+    pre_process_student_query(student_query, query_engine);
+}
+
+void ProcessQueries::pre_process_student_query(StudentQuery *student_query, Query_Engine &qe)
+{
+    // the words are needed by syntax repair for parseable and unparseable queries alike
+    student_query->create_words();
     PgQueryParseResult result = pg_query_parse(student_query->get_value().c_str());
 
     if (result.error)
@@ -482,23 +571,35 @@ void ProcessQueries::pre_process_student_query(StudentQuery *student_query, Admi
     student_query->set_parseable(true);
     student_query->create_abstract_syntax_tree();
     student_query->create_fingerprint();
-    student_query->create_output(query_engine);
+    // the goals are only shown for the model queries
+    student_query->create_clause_profile(false);
+    student_query->create_pq_gram_profile();
+    student_query->create_output(qe);
 }
 
 void ProcessQueries::pre_process_model_query(ModelQuery *model_query, Query_Engine &qe)
 {
+    // the model queries of a registered quiz come pre-processed
+    if (model_query->is_pre_processed())
+    {
+        return;
+    }
     // Check if the query is parseable
     PgQueryParseResult result = pg_query_parse(model_query->get_value().c_str());
-    if (result.error)
+    bool parseable = result.error == nullptr;
+    pg_query_free_parse_result(result);
+    if (!parseable)
     {
-        // std::lock_guard<std::mutex> lock(cout_mutex);
-        std::cerr << "The query " << model_query->get_value() << " is not parseable." << std::endl;
-        exit(1);
+        // the grading fails, not the server it runs in
+        throw std::invalid_argument("The model query " + model_query->get_value() + " is not parseable");
     }
 
     // The query is parseable
     model_query->create_abstract_syntax_tree();
     model_query->create_fingerprint();
+    model_query->create_clause_profile();
+    model_query->create_pq_gram_profile();
+    model_query->create_words();
     model_query->create_output(qe);
 
     // Set the goal of the exercise
@@ -507,13 +608,14 @@ void ProcessQueries::pre_process_model_query(ModelQuery *model_query, Query_Engi
     std::vector<std::string> goal_specific = Goals::generate_query_goal_specific(root_node);
     model_query->set_goal_general(goal_general);
     model_query->set_goal_specific(goal_specific);
+    model_query->set_pre_processed(true);
 }
 
-void ProcessQueries::analyze_syntax(StudentQuery *student_query, const Admin &admin, vector<ModelQuery> model_queries, vector<StudentQuery> student_queries, Query_Engine &qe)
+void ProcessQueries::analyze_syntax(StudentQuery *student_query, const Admin &admin, vector<ModelQuery> &model_queries, vector<StudentQuery> &student_queries, Query_Engine &qe, const RepairIndex &repair_index)
 {
     try
     {
-        student_query->syntax_analysis(admin, model_queries, student_queries, qe);
+        student_query->syntax_analysis(admin, model_queries, student_queries, qe, &repair_index);
     }
     catch (const std::exception &)
     {
@@ -536,11 +638,52 @@ void ProcessQueries::analyze_results(StudentQuery *student_query, const Admin &a
     }
 }
 
-void ProcessQueries::analyze_semantics(StudentQuery *student_query, const Admin &admin, vector<ModelQuery> model_queries, vector<StudentQuery> student_queries)
+bool ProcessQueries::grade_submission(StudentQuery *student_query, const Admin &admin, Grader &grader, vector<ModelQuery> &model_queries,
+                                      vector<StudentQuery> &correct_answers, const RepairIndex &repair_index, const TreeMetricIndex &correct_index,
+                                      Query_Engine &qe)
+{
+    pre_process_student_query(student_query, qe);
+    analyze_syntax(student_query, admin, model_queries, correct_answers, qe, repair_index);
+    analyze_results(student_query, admin, model_queries.at(0).get_output());
+    // semantics_analysis takes the correct answers by reference and only reads them, the caller holds the bank for reading
+    try
+    {
+        student_query->semantics_analysis(admin, model_queries, correct_answers, &correct_index);
+    }
+    catch (exception &e)
+    {
+        std::cerr << "Semantics exception: " << e.what() << std::endl;
+    }
+    // post-processing changes is_correct, the answer is checked before it as the cohort checks its answers
+    bool is_correct_answer = student_query->is_correct() && student_query->is_parseable();
+    grade_answer(student_query, admin, grader);
+    return is_correct_answer;
+}
+
+void ProcessQueries::grade_answer(StudentQuery *student_query, const Admin &admin, Grader &grader)
+{
+    student_query->post_process(admin);
+
+    // Get the correctness level and the normalized value
+    std::pair<int, double> correctness_level = grader.calculate_correctness_level(
+        admin.get_syntax_sensitivity(),
+        admin.get_semantics_sensitivity(),
+        admin.get_results_sensitivity(),
+        admin.get_property_order(),
+        student_query->get_results_outcome(),
+        student_query->get_semantics_outcome(),
+        student_query->get_syntax_outcome());
+
+    student_query->set_correctness_level(correctness_level.first);
+    student_query->set_normalized_value(correctness_level.second);
+    student_query->set_grade(admin);
+}
+
+void ProcessQueries::analyze_semantics(StudentQuery *student_query, const Admin &admin, const vector<ModelQuery> &model_queries, const vector<StudentQuery> &student_queries, const std::vector<DistanceMatrix::entry> *neighbours)
 {
     try
     {
-        student_query->semantics_analysis(admin, model_queries, student_queries);
+        student_query->semantics_analysis(admin, model_queries, student_queries, nullptr, neighbours);
     }
     catch (exception &e)
     {
@@ -7,6 +7,12 @@
  * @author Benard Wanjiru
  * Contact: benard.wanjiru@ru.nl
  */
+#ifndef PROCESS_QUERIES_H
+#define PROCESS_QUERIES_H
+
+#include <atomic>
+#include <functional>
+#include <thread>
 #include "student_query.h"
 #include "model_query.h"
 #include "admin.h"
@@ -26,8 +32,40 @@ public:
         double out_of;
         std::string feedback;
     };
+    /**
+     * The progress of a grading job, updated while the constructor runs so that another thread can report it.
+     * The stage counters count distinct answers, see get_answer_class.
+     */
+    struct progress
+    {
+        std::atomic<std::size_t> students{0};      /**< The number of student queries, set before pre-processing. */
+        std::atomic<std::size_t> answers{0};       /**< The number of distinct answers, set before pre-processing. */
+        std::atomic<std::size_t> pre_processed{0}; /**< The answers pre-processed. */
+        std::atomic<std::size_t> syntax{0};        /**< The answers whose syntax is analyzed. */
+        std::atomic<std::size_t> results{0};       /**< The answers whose results are analyzed. */
+        std::atomic<std::size_t> semantics{0};     /**< The answers whose semantics are analyzed. */
+        std::atomic<std::size_t> graded{0};        /**< The answers graded. */
+    };
+    /**
+     * Called with the position of a student query and its grading as soon as the grading is final.
+     */
+    using graded_callback = std::function<void(std::size_t position, const grading_info &info)>;
     ProcessQueries();
-    ProcessQueries(vector<ModelQuery> &model_queries, vector<StudentQuery> &student_queries, Admin::database_options db_opts, const Admin &admin, Grader &grader);
+    /**
+     * This constructor grades the student queries.
+     * @param model_queries: the model queries.
+     * @param student_queries: the student queries, set to their grading.
+     * @param db_opts: the database the queries are run on.
+     * @param admin: the admin object that contains the grading parameters.
+     * @param grader: the grader.
+     * @param job_progress: if not null, updated as each stage finishes a query.
+     * @param on_graded: if set, called for each student query as soon as its grading is final, in no particular order.
+     * The calls come from a worker thread, one at a time.
+     * @param threads: the threads the distances between the student queries are computed on, see GradingScheduler.
+     */
+    ProcessQueries(vector<ModelQuery> &model_queries, vector<StudentQuery> &student_queries, Admin::database_options db_opts, const Admin &admin, Grader &grader,
+                   progress *job_progress = nullptr, const graded_callback &on_graded = nullptr,
+                   std::size_t threads = std::thread::hardware_concurrency());
     /**
      * This function outputs the results of the grading to a csv file.
      * In this function we only output the necessary information for the student and the instructor.
@@ -42,7 +80,7 @@ public:
      * @param normalized_value: the normalized value of a query being graded.
      */
     template <typename T>
-    T final_grade(T worst_grade, T best_grade, double normalized_value);
+    static T final_grade(T worst_grade, T best_grade, double normalized_value);
     void output_results(const vector<StudentQuery> *queries, const Admin &admin);
     /**
      * This function outputs the results of the grading to a csv file.
@@ -52,18 +90,80 @@ public:
      */
     void output_results_more(const vector<StudentQuery> *queries, const Admin &admin);
     std::vector<grading_info> get_grading_info(const vector<StudentQuery> *queries, const Admin &admin);
+    /**
+     * This function returns the grading of one student query, as get_grading_info does for each of them.
+     * @param student_query: the graded student query.
+     * @param admin: the admin object that contains the grading parameters.
+     */
+    static grading_info get_grading_info(const StudentQuery &student_query, const Admin &admin);
     void pre_process_student_query(StudentQuery *student_query, Admin::database_options db_opts);
+    /**
+     * This function pre-processes a student query on a given database engine.
+     * @param student_query: the student query.
+     * @param qe: the engine the query is run on.
+     */
+    static void pre_process_student_query(StudentQuery *student_query, Query_Engine &qe);
+    /**
+     * This function pre-processes a model query on a given database engine.
+     * @param model_query: the model query.
+     * @param qe: the engine the query is run on.
+     * @throws std::invalid_argument if the model query is not parseable.
+     */
     static void pre_process_model_query(ModelQuery *model_query, Query_Engine &qe);
+    /**
+     * This function grades a single student query, as the constructor grades a cohort, without grouping, thread pools
+     * or a distance matrix. The query is compared with a bank of correct answers instead of the other queries of a cohort.
+     * The model queries must be pre-processed, see pre_process_model_query.
+     * @param student_query: the student query.
+     * @param admin: the admin object that contains the grading parameters.
+     * @param grader: the grader.
+     * @param model_queries: the pre-processed model queries.
+     * @param correct_answers: the correct answers, parseable and pre-processed.
+     * @param repair_index: the words of the correct answers by position, see RepairIndex.
+     * @param correct_index: the parse trees of the correct answers by position, see TreeMetricIndex.
+     * @param qe: the engine the query is run on.
+     * @return: true if the query is a correct answer that later submissions can be compared with.
+     */
+    static bool grade_submission(StudentQuery *student_query, const Admin &admin, Grader &grader, vector<ModelQuery> &model_queries,
+                                 vector<StudentQuery> &correct_answers, const RepairIndex &repair_index, const TreeMetricIndex &correct_index,
+                                 Query_Engine &qe);
+    /**
+     * This function returns the answer a student query was graded as. Student queries with the same text, up to repeated
+     * spaces, are one answer and only the first of them is analyzed; the others copy its grading.
+     * @param position: the position of the student query.
+     * @return: the position of the answer among the distinct answers.
+     */
+    std::size_t get_answer_class(std::size_t position) const;
+    /**
+     * This function returns the close pairs of the distinct answers of the grading job, see get_answer_class.
+     * @return: the distance matrix, empty if semantics analysis used the pq-gram prefilter.
+     */
+    const DistanceMatrix &get_distance_matrix() const;
 
 private:
-    static void analyze_syntax(StudentQuery *student_query, const Admin &admin, vector<ModelQuery> model_queries, vector<StudentQuery> student_queries, Query_Engine &qe);
+    static void analyze_syntax(StudentQuery *student_query, const Admin &admin, vector<ModelQuery> &model_queries, vector<StudentQuery> &student_queries, Query_Engine &qe, const RepairIndex &repair_index);
     static void analyze_results(StudentQuery *student_query, const Admin &admin, vector<vector<string>> output);
-    static void analyze_semantics(StudentQuery *student_query, const Admin &admin, vector<ModelQuery> model_queries, vector<StudentQuery> student_queries);
+    /**
+     * This function grades a student query from the outcomes of its analysis.
+     */
+    static void grade_answer(StudentQuery *student_query, const Admin &admin, Grader &grader);
+    static void analyze_semantics(StudentQuery *student_query, const Admin &admin, const vector<ModelQuery> &model_queries, const vector<StudentQuery> &student_queries, const std::vector<DistanceMatrix::entry> *neighbours);
     Query_Engine query_engine;
+    DistanceMatrix distance_matrix;        /**< The close pairs of the distinct answers, computed once before semantics analysis. */
+    std::vector<std::size_t> answer_class; /**< The distinct answer of each student query. */
+    /**
+     * This function groups the student queries by their text.
+     * @param student_queries: the student queries.
+     * @param answer_class: set to the position of the answer of each student query.
+     * @return: the first student query of each answer, in order of first submission.
+     */
+    static std::vector<StudentQuery> group_student_queries(const vector<StudentQuery> &student_queries, std::vector<std::size_t> &answer_class);
 
     // dummy storage for delegating zero‐arg ctor
     static std::vector<ModelQuery> dummy_model_queries_;
     static std::vector<StudentQuery> dummy_student_queries_;
     static Admin dummy_admin_;
     static Grader dummy_grader_;
-};
\ No newline at end of file
+};
+
+#endif // PROCESS_QUERIES_H
@@ -1,4 +1,5 @@
 #include "query_engine.h"
+#include "database_cache.h"
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
@@ -37,6 +38,8 @@ void Query_Engine::initialize()
 {
     if (use_pg_)
     {
+        if (!opts_.dataset_tables.empty())
+            throw std::runtime_error("Pg init failed: tables of a dataset are only loaded from files into DuckDB");
         if (opts_.is_front_end)
         {
             // If we are using the front end, we need to create the database
@@ -66,16 +69,15 @@ void Query_Engine::initialize()
     {
         if (opts_.is_front_end)
         {
-            std::string err;
-            if (opts_.auto_db == 0)
+            // the script runs once, the engines of the requests with the same script share its database
+            const std::string &script = opts_.auto_db == 0 ? opts_.sql_file : opts_.sql_create;
+            try
             {
-                if (!duckdb_->execute_query_cud(opts_.sql_file, err))
-                    throw std::runtime_error("DuckDB init failed: " + err);
+                duckdb_ = std::make_unique<MyDuckDB>(DatabaseCache::shared().find_or_load(script, opts_.dataset_tables, opts_.dataset_sha256));
             }
-            else
+            catch (const std::runtime_error &e)
             {
-                if (!duckdb_->execute_query_cud(opts_.sql_create, err))
-                    throw std::runtime_error("DuckDB init failed: " + err);
+                throw std::runtime_error("DuckDB init failed: " + std::string(e.what()));
             }
         }
     }
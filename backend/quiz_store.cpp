@@ -0,0 +1,69 @@
+#include "quiz_store.h"
+#include <mutex>
+#include <stdexcept>
+#include <pg_query.h>
+#include "process_queries.h"
+#include "query_engine.h"
+#include "utils.h"
+
+void QuizStore::check(const std::vector<ModelQuery> &model_queries)
+{
+    if (model_queries.empty())
+    {
+        throw std::invalid_argument("A quiz needs at least one model query");
+    }
+    // a model query that is not parseable is refused before the database is made for it
+    for (const auto &model_query : model_queries)
+    {
+        PgQueryParseResult result = pg_query_parse(model_query.get_value().c_str());
+        bool parseable = result.error == nullptr;
+        pg_query_free_parse_result(result);
+        if (!parseable)
+        {
+            throw std::invalid_argument("The model query " + model_query.get_value() + " is not parseable");
+        }
+    }
+}
+
+std::shared_ptr<const QuizStore::quiz> QuizStore::add(std::vector<ModelQuery> model_queries, const Admin &admin, const Admin::database_options &db_opts,
+                                                      std::vector<std::shared_ptr<const DatasetStore::reference>> datasets)
+{
+    check(model_queries);
+
+    auto registered = std::make_shared<quiz>();
+    registered->admin = admin;
+    registered->db_opts = db_opts;
+    registered->model_queries = std::move(model_queries);
+    registered->datasets = std::move(datasets);
+    Query_Engine query_engine(db_opts);
+    query_engine.initialize();
+    for (auto &model_query : registered->model_queries)
+    {
+        ProcessQueries::pre_process_model_query(&model_query, query_engine);
+    }
+    query_engine.clear();
+
+    std::unique_lock lock(mutex);
+    registered->id = Utils::random_id();
+    quizzes[registered->id] = registered;
+    return registered;
+}
+
+std::shared_ptr<const QuizStore::quiz> QuizStore::find(const std::string &id) const
+{
+    std::shared_lock lock(mutex);
+    auto it = quizzes.find(id);
+    return it == quizzes.end() ? nullptr : it->second;
+}
+
+bool QuizStore::remove(const std::string &id)
+{
+    std::unique_lock lock(mutex);
+    return quizzes.erase(id) > 0;
+}
+
+std::size_t QuizStore::size() const
+{
+    std::shared_lock lock(mutex);
+    return quizzes.size();
+}
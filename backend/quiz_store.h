@@ -0,0 +1,74 @@
+/**
+ * @file quiz_store.h
+ * @brief This file contains the declaration of the QuizStore class.
+ * The class keeps the quizzes registered with the server. A quiz is its database, its model queries and its grading
+ * options. The model queries are pre-processed when the quiz is registered, so their parse trees, fingerprints, clause
+ * profiles, outputs and goals are computed once and shared by every grading of the quiz instead of once per request.
+ * A registered quiz never changes, so the gradings read it without a lock.
+ *
+ * @author Benard Wanjiru
+ * Contact: benard.wanjiru@ru.nl
+ */
+#ifndef QUIZ_STORE_H
+#define QUIZ_STORE_H
+
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "admin.h"
+#include "dataset_store.h"
+#include "model_query.h"
+
+class QuizStore
+{
+public:
+    struct quiz
+    {
+        std::string id;
+        Admin admin;                           /**< The grading options. */
+        Admin::database_options db_opts;       /**< The database the queries are run on. */
+        std::vector<ModelQuery> model_queries; /**< The pre-processed model queries. */
+        std::vector<std::shared_ptr<const DatasetStore::reference>> datasets; /**< The stored script and table files of the database, those that came by their hashes. */
+    };
+    /**
+     * This function checks the model queries of a quiz before its database is made.
+     * @param model_queries: the model queries of the quiz.
+     * @throws std::invalid_argument if there is no model query or a model query is not parseable.
+     */
+    static void check(const std::vector<ModelQuery> &model_queries);
+    /**
+     * This function registers a quiz. The model queries are pre-processed on a database of their own.
+     * @param model_queries: the model queries of the quiz.
+     * @param admin: the grading options of the quiz.
+     * @param db_opts: the database of the quiz.
+     * @param datasets: the stored datasets the database is made from, they stay referenced while the quiz is registered.
+     * @return: the registered quiz.
+     * @throws std::invalid_argument if there is no model query or a model query is not parseable.
+     */
+    std::shared_ptr<const quiz> add(std::vector<ModelQuery> model_queries, const Admin &admin, const Admin::database_options &db_opts,
+                                    std::vector<std::shared_ptr<const DatasetStore::reference>> datasets = {});
+    /**
+     * This function looks up a quiz.
+     * @param id: the id of the quiz.
+     * @return: the quiz, null if there is no quiz with the id.
+     */
+    std::shared_ptr<const quiz> find(const std::string &id) const;
+    /**
+     * This function forgets a quiz. The gradings of the quiz that are running keep it until they finish.
+     * @param id: the id of the quiz.
+     * @return: true if the quiz was registered, false otherwise.
+     */
+    bool remove(const std::string &id);
+    /**
+     * This function returns the number of registered quizzes.
+     */
+    std::size_t size() const;
+
+private:
+    mutable std::shared_mutex mutex;
+    std::map<std::string, std::shared_ptr<const quiz>> quizzes;
+};
+
+#endif // QUIZ_STORE_H
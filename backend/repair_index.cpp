@@ -0,0 +1,87 @@
+#include "repair_index.h"
+#include <algorithm>
+#include <limits>
+
+void RepairIndex::add(std::size_t position, const std::vector<SqlLexer::word_id> &words)
+{
+    const std::uint32_t document = static_cast<std::uint32_t>(positions.size());
+    std::vector<gram> query_grams = grams(words);
+    for (gram g : query_grams)
+    {
+        postings[g].push_back(document);
+    }
+    positions.push_back(position);
+    gram_counts.push_back(static_cast<std::uint32_t>(query_grams.size()));
+}
+
+std::vector<std::size_t> RepairIndex::nearest(const std::vector<SqlLexer::word_id> &words, std::size_t k) const
+{
+    std::vector<gram> query_grams = grams(words);
+    // count the n-grams each indexed query shares with this one by walking the posting lists
+    std::vector<std::uint32_t> shared(positions.size(), 0);
+    std::vector<std::uint32_t> touched;
+    for (gram g : query_grams)
+    {
+        auto it = postings.find(g);
+        if (it == postings.end())
+        {
+            continue;
+        }
+        for (std::uint32_t document : it->second)
+        {
+            if (shared[document]++ == 0)
+            {
+                touched.push_back(document);
+            }
+        }
+    }
+
+    auto similarity = [&](std::uint32_t document)
+    {
+        return static_cast<double>(shared[document]) / (query_grams.size() + gram_counts[document] - shared[document]);
+    };
+    // most similar first, the earlier query on ties
+    auto more_similar = [&](std::uint32_t a, std::uint32_t b)
+    {
+        double similarity_a = similarity(a), similarity_b = similarity(b);
+        return similarity_a != similarity_b ? similarity_a > similarity_b : positions[a] < positions[b];
+    };
+    if (touched.size() > k)
+    {
+        std::nth_element(touched.begin(), touched.begin() + k, touched.end(), more_similar);
+        touched.resize(k);
+    }
+
+    std::vector<std::size_t> result;
+    result.reserve(touched.size());
+    for (std::uint32_t document : touched)
+    {
+        result.push_back(positions[document]);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::size_t RepairIndex::size() const
+{
+    return positions.size();
+}
+
+std::vector<RepairIndex::gram> RepairIndex::grams(const std::vector<SqlLexer::word_id> &words)
+{
+    // a unigram is packed with a second half that no word id takes
+    constexpr gram unigram_marker = std::numeric_limits<SqlLexer::word_id>::max();
+    std::vector<gram> result;
+    result.reserve(2 * words.size());
+    for (std::size_t i = 0; i < words.size(); i++)
+    {
+        result.push_back((gram{words[i]} << 32) | unigram_marker);
+        if (i + 1 < words.size())
+        {
+            result.push_back((gram{words[i]} << 32) | words[i + 1]);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file repair_index.h
+ * @brief This file contains the declaration of the RepairIndex class.
+ * The class is an inverted index of word n-grams over the parseable queries of a batch. Syntax repair uses it to pick
+ * the few queries that share the most unigrams and bigrams with a broken query, and only runs the word level edit
+ * distance and the parse check against those, instead of against every parseable query in the batch.
+ *
+ * @author Benard Wanjiru
+ * Contact: benard.wanjiru@ru.nl
+ */
+#ifndef REPAIR_INDEX_H
+#define REPAIR_INDEX_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "sql_lexer.h"
+
+class RepairIndex
+{
+public:
+    /**
+     * The number of candidates syntax repair asks for.
+     */
+    static constexpr std::size_t default_top_k = 10;
+    /**
+     * This function adds a query to the index.
+     * @param position: the position of the query in the caller's vector of queries, returned by nearest.
+     * @param words: the interned words of the query, see ModelQuery::get_words.
+     */
+    void add(std::size_t position, const std::vector<SqlLexer::word_id> &words);
+    /**
+     * This function finds the queries that are most similar to a query. The similarity is the Jaccard index of the
+     * sets of word unigrams and bigrams. Queries that share no n-gram with the query are never returned.
+     * @param words: the interned words of the query.
+     * @param k: the maximum number of queries to return.
+     * @return: the positions of at most k most similar queries, in increasing order of position.
+     */
+    std::vector<std::size_t> nearest(const std::vector<SqlLexer::word_id> &words, std::size_t k) const;
+    /**
+     * This function returns the number of queries in the index.
+     */
+    std::size_t size() const;
+
+private:
+    using gram = std::uint64_t;
+    std::unordered_map<gram, std::vector<std::uint32_t>> postings; /**< For each n-gram, the queries that contain it. */
+    std::vector<std::size_t> positions;                            /**< The position of each indexed query. */
+    std::vector<std::uint32_t> gram_counts;                        /**< The number of distinct n-grams of each indexed query. */
+    /**
+     * This function returns the distinct unigrams and bigrams of a word sequence, each packed into 64 bits.
+     */
+    static std::vector<gram> grams(const std::vector<SqlLexer::word_id> &words);
+};
+
+#endif // REPAIR_INDEX_H
@@ -0,0 +1,272 @@
+#include "script_loader.h"
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <pg_query.h>
+
+namespace
+{
+    // the value of a literal as the INSERT would store it in a column of the type, false if it is not a literal or
+    // the cast could differ from the one of the INSERT
+    bool literal_value(const nlohmann::json &node, const duckdb::LogicalType &type, duckdb::Value &value)
+    {
+        if (!node.contains("A_Const"))
+        {
+            return false;
+        }
+        const nlohmann::json &constant = node["A_Const"];
+        if (constant.value("isnull", false))
+        {
+            value = duckdb::Value(type);
+            return true;
+        }
+        duckdb::Value literal;
+        // libpg_query leaves out the fields that are 0, false or empty
+        if (constant.contains("ival"))
+        {
+            literal = duckdb::Value::INTEGER(constant["ival"].value("ival", 0));
+        }
+        else if (constant.contains("sval"))
+        {
+            literal = duckdb::Value(constant["sval"].value("sval", std::string()));
+        }
+        else if (constant.contains("boolval"))
+        {
+            literal = duckdb::Value::BOOLEAN(constant["boolval"].value("boolval", false));
+        }
+        else if (constant.contains("fval") && type.IsNumeric() && !type.IsIntegral())
+        {
+            // an INSERT rounds a decimal into an integer column and formats it into a text column, the text is only
+            // cast the same way into a decimal or a floating point column
+            literal = duckdb::Value(constant["fval"].value("fval", std::string()));
+        }
+        else
+        {
+            return false;
+        }
+        return literal.DefaultTryCastAs(type, value, nullptr);
+    }
+
+    // the rows of an INSERT ... VALUES whose values are all literals, the columns it names in the cols argument
+    bool values_insert(const nlohmann::json &insert, std::string &table, std::vector<std::string> &columns, const nlohmann::json *&rows)
+    {
+        if (insert.contains("onConflictClause") || insert.contains("returningList") || insert.contains("withClause") ||
+            !insert.contains("relation") || !insert.contains("selectStmt") || !insert["selectStmt"].contains("SelectStmt"))
+        {
+            return false;
+        }
+        const nlohmann::json &select = insert["selectStmt"]["SelectStmt"];
+        for (const auto &field : select.items())
+        {
+            if (field.key() != "valuesLists" && field.key() != "limitOption" && field.key() != "op")
+            {
+                return false;
+            }
+        }
+        if (!select.contains("valuesLists") || select.value("op", std::string("SETOP_NONE")) != "SETOP_NONE")
+        {
+            return false;
+        }
+        const nlohmann::json &relation = insert["relation"];
+        table = relation.value("relname", std::string());
+        if (relation.contains("schemaname"))
+        {
+            table = relation["schemaname"].get<std::string>() + "." + table;
+        }
+        columns.clear();
+        if (insert.contains("cols"))
+        {
+            for (const auto &column : insert["cols"])
+            {
+                if (!column.contains("ResTarget") || column["ResTarget"].contains("indirection"))
+                {
+                    return false;
+                }
+                columns.push_back(column["ResTarget"].value("name", std::string()));
+            }
+        }
+        rows = &select["valuesLists"];
+        return !table.empty();
+    }
+
+    // the appender of the INSERT statements into one table with the same columns
+    struct open_appender
+    {
+        std::unique_ptr<duckdb::Appender> appender;
+        std::string target;
+    };
+
+    // a string as an SQL literal or a quoted identifier
+    std::string quoted(const std::string &text, char quote)
+    {
+        std::string result(1, quote);
+        for (char c : text)
+        {
+            result += c;
+            if (c == quote)
+            {
+                result += quote;
+            }
+        }
+        return result + quote;
+    }
+
+    void close(open_appender &open)
+    {
+        if (open.appender)
+        {
+            // the rows are checked against the constraints of the table when they are flushed
+            std::unique_ptr<duckdb::Appender> appender = std::move(open.appender);
+            open.target.clear();
+            appender->Close();
+        }
+    }
+}
+
+ScriptLoader::report ScriptLoader::run(duckdb::Connection &con, const std::string &script)
+{
+    report result;
+    auto execute = [&con, &result](const std::string &statements)
+    {
+        auto query_result = con.Query(statements);
+        if (query_result->HasError())
+        {
+            throw std::runtime_error(query_result->GetError());
+        }
+        result.executed++;
+    };
+
+    PgQueryParseResult parsed = pg_query_parse(script.c_str());
+    if (parsed.error != nullptr)
+    {
+        pg_query_free_parse_result(parsed);
+        execute(script);
+        return result;
+    }
+    nlohmann::json parse_tree = nlohmann::json::parse(parsed.parse_tree);
+    pg_query_free_parse_result(parsed);
+
+    open_appender open;
+    std::string table;
+    std::vector<std::string> columns;
+    std::vector<duckdb::Value> values;
+    // an appender finds its table in the default schema, a SET of the schema changes where the INSERT statements look
+    bool schema_changed = false;
+    for (const auto &statement : parse_tree["stmts"])
+    {
+        result.statements++;
+        if (statement["stmt"].contains("VariableSetStmt"))
+        {
+            std::string name = statement["stmt"]["VariableSetStmt"].value("name", std::string());
+            schema_changed = schema_changed || name == "search_path" || name == "schema";
+        }
+        const nlohmann::json *rows = nullptr;
+        bool appendable = !schema_changed && statement["stmt"].contains("InsertStmt") &&
+                          values_insert(statement["stmt"]["InsertStmt"], table, columns, rows);
+        if (appendable)
+        {
+            std::string target = table;
+            for (const auto &column : columns)
+            {
+                target += '\0' + column;
+            }
+            if (target != open.target)
+            {
+                close(open);
+                try
+                {
+                    auto dot = table.find('.');
+                    open.appender = dot == std::string::npos ? std::make_unique<duckdb::Appender>(con, table)
+                                                             : std::make_unique<duckdb::Appender>(con, table.substr(0, dot), table.substr(dot + 1));
+                    for (const auto &column : columns)
+                    {
+                        open.appender->AddColumn(column);
+                    }
+                    open.target = target;
+                }
+                catch (const std::exception &)
+                {
+                    // an unknown table or column, the INSERT reports it
+                    open.appender.reset();
+                    appendable = false;
+                }
+            }
+        }
+        // all the rows are checked before the first is appended, so an INSERT runs either way as a whole
+        if (appendable)
+        {
+            const duckdb::vector<duckdb::LogicalType> &types = open.appender->GetActiveTypes();
+            values.clear();
+            for (const auto &row : *rows)
+            {
+                if (!row.contains("List") || !row["List"].contains("items") || row["List"]["items"].size() != types.size())
+                {
+                    appendable = false;
+                    break;
+                }
+                const nlohmann::json &items = row["List"]["items"];
+                for (std::size_t i = 0; i < types.size() && appendable; i++)
+                {
+                    duckdb::Value value;
+                    appendable = literal_value(items[i], types[i], value);
+                    values.push_back(std::move(value));
+                }
+                if (!appendable)
+                {
+                    break;
+                }
+            }
+        }
+        if (!appendable)
+        {
+            close(open);
+            // the location is left out for the first statement and the length for the last one
+            std::size_t location = statement.value("stmt_location", 0);
+            std::size_t length = statement.value("stmt_len", 0);
+            execute(length == 0 ? script.substr(location) : script.substr(location, length));
+            continue;
+        }
+        for (std::size_t i = 0; i < values.size(); i += open.appender->GetActiveTypes().size())
+        {
+            open.appender->BeginRow();
+            for (std::size_t j = 0; j < open.appender->GetActiveTypes().size(); j++)
+            {
+                open.appender->Append(values[i + j]);
+            }
+            open.appender->EndRow();
+            result.rows++;
+        }
+        result.appended++;
+    }
+    close(open);
+    return result;
+}
+
+std::size_t ScriptLoader::load_tables(duckdb::Connection &con, const std::vector<Admin::dataset_table> &tables)
+{
+    std::size_t rows = 0;
+    for (const auto &table : tables)
+    {
+        std::string reader = (table.format == Admin::dataset_format::PARQUET ? "read_parquet(" : "read_csv(") + quoted(table.path, '\'') + ")";
+        // the script may have created the table, with the name in another case
+        auto existing = con.Query("SELECT table_name FROM duckdb_tables() WHERE lower(table_name) = lower(" + quoted(table.name, '\'') + ");");
+        if (existing->HasError())
+        {
+            throw std::runtime_error(existing->GetError());
+        }
+        std::string statement = existing->RowCount() > 0
+                                    ? "INSERT INTO " + quoted(existing->GetValue(0, 0).ToString(), '"') + " BY NAME SELECT * FROM " + reader + ";"
+                                    : "CREATE TABLE " + quoted(table.name, '"') + " AS SELECT * FROM " + reader + ";";
+        auto result = con.Query(statement);
+        if (result->HasError())
+        {
+            throw std::runtime_error("Loading " + table.path + " into " + table.name + " failed: " + result->GetError());
+        }
+        if (result->RowCount() > 0)
+        {
+            rows += static_cast<std::size_t>(result->GetValue(0, 0).GetValue<int64_t>());
+        }
+    }
+    return rows;
+}
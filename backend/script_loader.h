@@ -0,0 +1,56 @@
+/**
+ * @file script_loader.h
+ * @brief This file contains the declaration of the ScriptLoader class.
+ * The class runs the script that creates and fills the tables of a quiz. The datasets come as SQL text with thousands
+ * of INSERT statements, and DuckDB parses and plans each of them on its own. The script is parsed once with libpg_query
+ * instead: the INSERT statements whose values are all literals are appended to their table with a DuckDB Appender,
+ * the consecutive ones into the same table with the same appender. Every other statement, and an INSERT whose values
+ * cannot be appended as they would be inserted, is run as it is, in the order of the script.
+ * The tables of a large dataset come as Parquet or CSV files instead, which the DuckDB readers load without the data
+ * ever being SQL text.
+ *
+ * @author Benard Wanjiru
+ * Contact: benard.wanjiru@ru.nl
+ */
+#ifndef SCRIPT_LOADER_H
+#define SCRIPT_LOADER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "admin.h"
+#include "duckdb/duckdb.hpp"
+
+class ScriptLoader
+{
+public:
+    /**
+     * How the statements of a script were run.
+     */
+    struct report
+    {
+        std::size_t statements = 0; /**< The statements of the script, 0 if libpg_query could not parse it. */
+        std::size_t appended = 0;   /**< The INSERT statements that were appended. */
+        std::size_t rows = 0;       /**< The rows that were appended. */
+        std::size_t executed = 0;   /**< The statements that were run as they are, the whole script counts once. */
+    };
+    /**
+     * This function runs a script. A script libpg_query cannot parse, for instance one with statements only DuckDB
+     * knows, is run as a whole as it is.
+     * @param con: the connection the script runs on.
+     * @param script: the statements that create and fill the tables.
+     * @return: how the statements were run.
+     * @throws std::runtime_error if a statement fails, the statements before it are committed.
+     */
+    static report run(duckdb::Connection &con, const std::string &script);
+    /**
+     * This function loads the tables of a dataset from their files, see Admin::dataset_table.
+     * @param con: the connection the tables are loaded on, after the script that creates them ran.
+     * @param tables: the tables and their files.
+     * @return: the number of rows that were loaded.
+     * @throws std::runtime_error if a file cannot be read into its table.
+     */
+    static std::size_t load_tables(duckdb::Connection &con, const std::vector<Admin::dataset_table> &tables);
+};
+
+#endif // SCRIPT_LOADER_H
@@ -1,6 +1,16 @@
 #include <crow.h>
 #include <crow/middlewares/cors.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 #include <nlohmann/json.hpp>
 #include "goals.h"
@@ -9,13 +19,158 @@
 #include "student_query.h"
 #include "process_queries.h"
 #include "admin.h"
+#include "keyword_index.h"
+#include "grading_jobs.h"
+#include "grading_scheduler.h"
+#include "quiz_store.h"
+#include "practice_grader.h"
+#include "database_cache.h"
+#include "dataset_store.h"
 
 Grader::grading_options set_grading_options(int syntax, int semantics, int results, int order_of_importance);
+/**
+ * This function checks that a quiz registration has all the required fields: the database, the model queries and the
+ * grading options. The database is its script, or the hash of a stored dataset in "dataset_sha256".
+ * @param body: the body of the request.
+ * @return: true if no field is missing, false otherwise.
+ */
+bool has_quiz_fields(const crow::json::rvalue &body);
+/**
+ * This function checks that a grading request has all the required fields: the student queries, and either the id of
+ * a registered quiz or the fields of a quiz, see has_quiz_fields.
+ * @param body: the body of the request.
+ * @return: true if no field is missing, false otherwise.
+ */
+bool has_grading_fields(const crow::json::rvalue &body);
+/**
+ * This function reads the quiz of a request. The model queries are not pre-processed.
+ * @param body: the body of the request, see has_quiz_fields.
+ * @param datasets: the stored datasets, the quiz references the one of its hash.
+ * @return: the quiz, without an id.
+ * @throws std::invalid_argument if a model query is not parseable or the dataset of the hash is not stored, see also
+ * QuizStore::check and read_dataset.
+ */
+QuizStore::quiz read_quiz(const crow::json::rvalue &body, DatasetStore &datasets);
+/**
+ * This function reads the tables of a request that are loaded from files, the optional field
+ * "dataset": [{"table": "artist", "path": "discography/artist.parquet", "format": "parquet"}, ...].
+ * A path is relative to the directory in SOCOLES_DATASET_DIR, the format is taken from the extension if it is left out.
+ * A file that was uploaded to the stored datasets is named by "sha256" instead of "path", with its format.
+ * @param body: the body of the request.
+ * @param datasets: the stored datasets.
+ * @param references: the stored files of the tables are referenced here.
+ * @return: the tables, empty if the request has no dataset.
+ * @throws std::invalid_argument if a table is incomplete, its file is outside the directory or not stored, or datasets are not enabled.
+ */
+std::vector<Admin::dataset_table> read_dataset(const crow::json::rvalue &body, DatasetStore &datasets,
+                                               std::vector<std::shared_ptr<const DatasetStore::reference>> &references);
+/**
+ * This function returns the quiz a grading request is graded with.
+ * @param body: the body of the request, see has_grading_fields.
+ * @param quizzes: the registered quizzes.
+ * @param datasets: the stored datasets, see read_quiz.
+ * @return: the registered quiz of the request, or the quiz read from the request. Null if the quiz id is unknown.
+ */
+std::shared_ptr<const QuizStore::quiz> find_quiz(const crow::json::rvalue &body, const QuizStore &quizzes, DatasetStore &datasets);
+/**
+ * This function grades the student queries of a grading request.
+ * @param body: the body of the request, see has_grading_fields.
+ * @param quiz: the quiz the student queries answer, see find_quiz.
+ * @param job_progress: if not null, updated as the grading goes, see ProcessQueries::progress.
+ * @param on_graded: called with the grading of each student query as soon as it is final.
+ * @param threads: the cores the grading was admitted with, see GradingScheduler::ticket.
+ */
+void grade_queries(const crow::json::rvalue &body, const QuizStore::quiz &quiz, ProcessQueries::progress *job_progress, const ProcessQueries::graded_callback &on_graded,
+                   std::size_t threads);
+/**
+ * This function returns the record of a graded student query as it is sent to the clients.
+ * @param info: the grading of the student query.
+ */
+crow::json::wvalue grading_record(const ProcessQueries::grading_info &info);
+/**
+ * The practice graders of the registered quizzes, by quiz id. A grader is made on the first submission of its quiz.
+ */
+struct practice_graders
+{
+    std::mutex mutex;
+    std::map<std::string, std::shared_ptr<PracticeGrader>> graders;
+};
+/**
+ * This function returns the practice grader of a registered quiz, and makes it if it does not exist yet.
+ * @param quiz_id: the id of the quiz.
+ * @param quizzes: the registered quizzes.
+ * @param practice: the practice graders.
+ * @return: the practice grader, null if the quiz id is unknown or the quiz is removed while its grader is made.
+ */
+std::shared_ptr<PracticeGrader> find_practice_grader(const std::string &quiz_id, const QuizStore &quizzes, practice_graders &practice);
+/**
+ * This function reads the tokens of the tenants, "token1=tenant1,token2=tenant2", see tenant_of.
+ * @param tokens: the tokens, null if there are none.
+ * @return: the tenant of each token.
+ */
+std::map<std::string, std::string> read_tenant_tokens(const char *tokens);
+/**
+ * This function returns the tenant a grading request is admitted for, see GradingScheduler. The tenant is not taken
+ * from the request itself, a client could name any tenant and take its share of the budget.
+ * @param req: the request, its token is in the header "Authorization: Bearer <token>".
+ * @param tenant_tokens: the tenant of each token, see read_tenant_tokens.
+ * @return: the tenant of the token, the address of the client if the request has no known token.
+ */
+std::string tenant_of(const crow::request &req, const std::map<std::string, std::string> &tenant_tokens);
+/**
+ * This function returns the response to a grading that is refused because too many gradings are waiting.
+ * @param scheduler: the scheduler that refused the grading.
+ */
+crow::response too_busy(const GradingScheduler &scheduler);
 int main()
 {
     // Initialize necessary objects
     AbstractSyntaxTree ast;
     Goals goals;
+    // Build the keyword index once at startup rather than on the first syntax repair
+    KeywordIndex::sql_2016();
+    // The datasets uploaded once and sent by their hash, kept in SOCOLES_DATASET_STORE or ./datasets
+    const char *dataset_store = std::getenv("SOCOLES_DATASET_STORE");
+    DatasetStore datasets(dataset_store != nullptr ? dataset_store : "datasets");
+    // The registered quizzes, graded by id without sending their database and model queries again
+    QuizStore quizzes;
+    // The databases made from the quiz scripts are kept for the next requests, up to SOCOLES_DATABASE_CACHE_MB megabytes
+    if (const char *budget = std::getenv("SOCOLES_DATABASE_CACHE_MB"))
+    {
+        DatabaseCache::shared().set_budget(static_cast<std::size_t>(std::strtoull(budget, nullptr, 10)) << 20);
+    }
+    // Single submissions of a registered quiz are graded on engines that keep its database loaded
+    practice_graders practice;
+    // The gradings share SOCOLES_CPU_BUDGET cores, all the cores of the machine by default. A quarter of them is kept
+    // for single submissions and the cohorts run two at a time on the rest
+    std::size_t cpu_budget = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    if (const char *cores = std::getenv("SOCOLES_CPU_BUDGET"))
+    {
+        cpu_budget = std::max<std::size_t>(std::strtoull(cores, nullptr, 10), 1);
+    }
+    std::size_t interactive_reserve = std::max<std::size_t>(cpu_budget / 4, 1);
+    // a grading that runs or waits holds a request thread, the server has threads for all of them and for the other
+    // routes, so a grading is refused with 429 before the requests stop being served
+    const std::size_t max_waiting = 2 * cpu_budget;
+    const std::size_t request_threads = cpu_budget + max_waiting + 4;
+    GradingScheduler scheduler(cpu_budget, (cpu_budget - interactive_reserve) / 2, interactive_reserve, max_waiting);
+    // The tenants the gradings are admitted for, by the tokens of SOCOLES_TENANT_TOKENS
+    const std::map<std::string, std::string> tenant_tokens = read_tenant_tokens(std::getenv("SOCOLES_TENANT_TOKENS"));
+    // DuckDB loads a script on the cores of a cohort and runs the graded queries on one thread, within
+    // SOCOLES_DUCKDB_MEMORY_LIMIT per database and spilling to SOCOLES_DUCKDB_TEMP_DIR
+    DatabaseCache::resource_policy duckdb_resources;
+    duckdb_resources.parallel_threads = std::max<std::size_t>((cpu_budget - interactive_reserve) / 2, 1);
+    if (const char *memory_limit = std::getenv("SOCOLES_DUCKDB_MEMORY_LIMIT"))
+    {
+        duckdb_resources.memory_limit = memory_limit;
+    }
+    if (const char *temp_directory = std::getenv("SOCOLES_DUCKDB_TEMP_DIR"))
+    {
+        duckdb_resources.temp_directory = temp_directory;
+    }
+    DatabaseCache::shared().set_policy(duckdb_resources);
+    // Grading jobs run one at a time, the grading of a job already runs on thread pools of its own
+    GradingJobs jobs(1, 16);
     // crow::SimpleApp app;
     crow::App<crow::CORSHandler> app;
 
@@ -25,7 +180,7 @@ int main()
     cors
         .global()
         .origin("http://localhost:3000") // Specify allowed origin(s)
-        .methods("POST"_method, "OPTIONS"_method)
+        .methods("GET"_method, "HEAD"_method, "POST"_method, "PUT"_method, "DELETE"_method, "OPTIONS"_method)
         .headers("Content-Type", "Authorization")
         .max_age(86400); // Optional: Cache preflight response
 
@@ -119,7 +274,7 @@ int main()
                                                                                                      return res; });
 
     // **New /grade-queries Endpoint**
-    CROW_ROUTE(app, "/grade-queries").methods(crow::HTTPMethod::POST, crow::HTTPMethod::OPTIONS)([&goals](const crow::request &req)
+    CROW_ROUTE(app, "/grade-queries").methods(crow::HTTPMethod::POST, crow::HTTPMethod::OPTIONS)([&goals, &quizzes, &datasets, &scheduler, &tenant_tokens](const crow::request &req)
                                                                                                  {
                                                                                                      std::cout << "Received /grade-queries request with method: " << crow::method_name(req.method) << std::endl;
 
@@ -145,135 +300,33 @@ int main()
 
                                                                                                          //--sql=290/discography.sql --queries=290/original_results.csv --model=290/correct.csv --syntax=3 --semantics=8 --results=3 --prop_order=5 --edit_dist=4 --tree_dist=4 --check_order=0
                                                                                                          // **Validate Required Fields**
-                                                                                                         if (!body.has("sql_data") || !body.has("queries") || !body.has("model_queries") ||
-                                                                                                             !body.has("syntax") || !body.has("semantics") || !body.has("results") ||
-                                                                                                             !body.has("prop_order") || !body.has("edit_dist") || !body.has("tree_dist") || !body.has("check_order") ||
-                                                                                                             !body.has("auto_db") || !body.has("num_db") || !body.has("sql_create_data") || !body.has("dbname") || !body.has("use_postgresql"))
+                                                                                                         if (!has_grading_fields(body))
                                                                                                          {
                                                                                                              res.code = 400; // Bad Request
                                                                                                              res.write("Missing one or more required fields: sqlData, queries, options");
                                                                                                              return res;
                                                                                                          }
 
-                                                                                                         // **Extract Model Queries**
-                                                                                                         // Expected JSON structure:
-                                                                                                         /*
+                                                                                                         std::shared_ptr<const QuizStore::quiz> quiz = find_quiz(body, quizzes, datasets);
+                                                                                                         if (!quiz)
                                                                                                          {
-                                                                                                             "model": [
-                                                                                                                 "SELECT * FROM students;",
-                                                                                                                 "SELECT * FROM courses;"
-                                                                                                             ]
-                                                                                                         }
-                                                                                                         */
-                                                                                                         vector<ModelQuery> model_queries;
-                                                                                                         int index = 1;
-                                                                                                         for (const auto &query : body["model_queries"])
-                                                                                                         {
-                                                                                                             std::string element = query.s();
-                                                                                                             std::string id = std::to_string(index);
-
-                                                                                                             // If the string begins and ends with quotes, remove them
-                                                                                                             if (element.size() > 1 && element.front() == '\"' && element.back() == '\"')
-                                                                                                             {
-                                                                                                                 element.erase(0, 1);               // Remove first character
-                                                                                                                 element.erase(element.size() - 1); // Remove last character
-
-                                                                                                                 // Replace "" with "
-                                                                                                                 size_t position = element.find("\"\"");
-                                                                                                                 while (position != std::string::npos)
-                                                                                                                 {
-                                                                                                                     element.replace(position, 2, "\"");
-                                                                                                                     position = element.find("\"\"", position + 1);
-                                                                                                                 }
-                                                                                                             }
-                                                                                                             ModelQuery model_query(std::to_string(index++), element);
-                                                                                                             model_queries.push_back(model_query);
+                                                                                                             res.code = 404; // Not Found
+                                                                                                             res.write("Unknown quiz");
+                                                                                                             return res;
                                                                                                          }
 
-                                                                                                         // **Extract Student Queries** we only care about Org Defined ID, Attempt #, Q # and Answer
-                                                                                                         // Expected JSON structure:
-                                                                                                         /*
+                                                                                                         // a single student query goes in the lane of the practice submissions
+                                                                                                         GradingScheduler::lane lane = body["queries"].size() > 1 ? GradingScheduler::lane::BULK : GradingScheduler::lane::INTERACTIVE;
+                                                                                                         std::shared_ptr<const GradingScheduler::ticket> ticket = scheduler.admit(tenant_of(req, tenant_tokens), lane);
+                                                                                                         if (!ticket)
                                                                                                          {
-                                                                                                             "queries": [
-                                                                                                                 "ID123",
-                                                                                                                 1,
-                                                                                                                 "Q1",
-                                                                                                                 "SELECT * FROM students;"
-                                                                                                             ],
-                                                                                                             // ... more entries
-                                                                                                         }
-                                                                                                         */
-                                                                                                         std::vector<StudentQuery> student_queries;
-                                                                                                         for (const auto &query : body["queries"])
-                                                                                                         {
-                                                                                                             // StudentQuery student_query(id, query, question_number, attempt_number);
-                                                                                                             StudentQuery student_query(query[0].s(), query[3].s(), query[2].s(), query[1].i());
-                                                                                                             student_queries.push_back(student_query);
+                                                                                                             return too_busy(scheduler);
                                                                                                          }
 
-                                                                                                         // **Extract Options**
-                                                                                                         // Expected JSON structure:
-                                                                                                         /*
-                                                                                                         {
-                                                                                                             "syntax": 3,
-                                                                                                             "semantics": 8,
-                                                                                                             "results": 3,
-                                                                                                             "prop_order": 5,
-                                                                                                             "edit_dist": 4,
-                                                                                                             "tree_dist": 4,
-                                                                                                             "check_order": 0,
-                                                                                                             "auto_db": 1,
-                                                                                                             "num_db": 3,
-                                                                                                             "sql_create": "create table ...",
-                                                                                                             "dbname": "my_database"
-                                                                                                         }
-                                                                                                         */
-                                                                                                         int syntax_sensitivity = body["syntax"].i();
-                                                                                                         int semantics_sensitivity = body["semantics"].i();
-                                                                                                         int results_sensitivity = body["results"].i();
-                                                                                                         int prop_order = body["prop_order"].i();
-                                                                                                         int edit_dist = body["edit_dist"].i();
-                                                                                                         int tree_dist = body["tree_dist"].i();
-                                                                                                         int check_order = body["check_order"].i();
-                                                                                                         int auto_db = body["auto_db"].i();
-                                                                                                         int num_db = body["num_db"].i();
-                                                                                                         std::string sql_create_only = body["sql_create_data"].s();
-                                                                                                         std::string dbname = body["dbname"].s();
-                                                                                                         dbname = "grader";
-                                                                                                         bool use_postgresql = body["use_postgresql"].b();
-
-                                                                                                         // set grading options
-                                                                                                         Grader::grading_options grading_options = set_grading_options(syntax_sensitivity, semantics_sensitivity, results_sensitivity, prop_order);
-
-                                                                                                         // Initialize the Admin object
-                                                                                                         Admin admin;
-                                                                                                         admin.init(grading_options.syntax, grading_options.semantics, grading_options.results, grading_options.order_of_importance, (check_order == 1), edit_dist, tree_dist);
-
-                                                                                                         // Process the queries
-                                                                                                         Grader grader;
-                                                                                                         // Extract the .sql file path
-                                                                                                         std::string sql_create_insert_data = body["sql_data"].s();
-                                                                                                         Admin::database_options db_opts = {sql_create_insert_data, auto_db, num_db, sql_create_insert_data, "", dbname, true, use_postgresql};
-                                                                                                         // for now skip the evosql part in the argment ""
-                                                                                                         ProcessQueries process_queries(model_queries, student_queries, db_opts, admin, grader);
-
-                                                                                                         // Output the results
-                                                                                                         std::vector<ProcessQueries::grading_info> grading_info = process_queries.get_grading_info(&student_queries, admin);
-
-                                                                                                         // Prepare the JSON response
-                                                                                                         index = 0;
+                                                                                                         // the students come as they are graded, each is put back at its place in the request
                                                                                                          crow::json::wvalue jsonResults;
-                                                                                                         for (const auto &info : grading_info)
-                                                                                                         {
-                                                                                                             jsonResults[index]["Org Defined ID"] = info.org_defined_id;
-                                                                                                             jsonResults[index]["Attempt #"] = info.attempt_number;
-                                                                                                             jsonResults[index]["Q #"] = info.question_number;
-                                                                                                             jsonResults[index]["Query"] = info.query;
-                                                                                                             jsonResults[index]["Grade"] = info.grade;
-                                                                                                             jsonResults[index]["Out Of"] = info.out_of;
-                                                                                                             jsonResults[index]["Feedback"] = info.feedback;
-                                                                                                             index++;
-                                                                                                         }
+                                                                                                         grade_queries(body, *quiz, nullptr, [&jsonResults](std::size_t position, const ProcessQueries::grading_info &info)
+                                                                                                                       { jsonResults[static_cast<unsigned>(position)] = grading_record(info); }, ticket->cost);
 
                                                                                                          res.code = 200; // OK
                                                                                                          res.set_header("Content-Type", "application/json");
@@ -281,6 +334,13 @@ int main()
 
                                                                                                          return res;
                                                                                                      }
+                                                                                                     catch (const std::invalid_argument &e)
+                                                                                                     {
+                                                                                                         // the dataset of the request, see read_quiz
+                                                                                                         res.code = 400; // Bad Request
+                                                                                                         res.write(e.what());
+                                                                                                         return res;
+                                                                                                     }
                                                                                                      catch (const std::exception &e)
                                                                                                      {
                                                                                                          std::cerr << "Exception occurred: " << e.what() << std::endl;
@@ -289,7 +349,482 @@ int main()
                                                                                                          return res;
                                                                                                      } });
 
-    app.port(5000).multithreaded().run();
+    // **Quizzes** register the database, the model queries and the options of a quiz once, then grade with its id
+    CROW_ROUTE(app, "/quizzes").methods(crow::HTTPMethod::POST, crow::HTTPMethod::OPTIONS)([&quizzes, &practice, &datasets](const crow::request &req)
+                                                                                                  {
+                                                                                                      std::cout << "Received /quizzes request with method: " << crow::method_name(req.method) << std::endl;
+
+                                                                                                      crow::response res;
+
+                                                                                                      if (req.method == "OPTIONS"_method)
+                                                                                                      {
+                                                                                                          // For preflight requests, return a response with no content
+                                                                                                          res.code = 204; // No Content
+                                                                                                          return res;
+                                                                                                      }
+
+                                                                                                      try
+                                                                                                      {
+                                                                                                          auto body = crow::json::load(req.body);
+                                                                                                          if (!body)
+                                                                                                          {
+                                                                                                              res.code = 400; // Bad Request
+                                                                                                              res.write("Invalid JSON");
+                                                                                                              return res;
+                                                                                                          }
+                                                                                                          // the fields of /grade-queries without the student queries
+                                                                                                          if (!has_quiz_fields(body))
+                                                                                                          {
+                                                                                                              res.code = 400; // Bad Request
+                                                                                                              res.write("Missing one or more required fields: sqlData, model queries, options");
+                                                                                                              return res;
+                                                                                                          }
+
+                                                                                                          QuizStore::quiz quiz = read_quiz(body, datasets);
+                                                                                                          std::shared_ptr<const QuizStore::quiz> registered;
+                                                                                                          try
+                                                                                                          {
+                                                                                                              registered = quizzes.add(std::move(quiz.model_queries), quiz.admin, quiz.db_opts, std::move(quiz.datasets));
+                                                                                                          }
+                                                                                                          catch (const std::invalid_argument &e)
+                                                                                                          {
+                                                                                                              res.code = 400; // Bad Request
+                                                                                                              res.write(e.what());
+                                                                                                              return res;
+                                                                                                          }
+
+                                                                                                          // optional: "practice": true loads the database for single submissions now instead of on the first submission
+                                                                                                          if (body.has("practice") && body["practice"].b())
+                                                                                                          {
+                                                                                                              find_practice_grader(registered->id, quizzes, practice);
+                                                                                                          }
+
+                                                                                                          // the goals of the model queries come for free with the registration
+                                                                                                          crow::json::wvalue result;
+                                                                                                          result["id"] = registered->id;
+                                                                                                          int index = 0;
+                                                                                                          for (const auto &model_query : registered->model_queries)
+                                                                                                          {
+                                                                                                              result["model_queries"][index]["query"] = model_query.get_value();
+                                                                                                              result["model_queries"][index]["goal_general"] = model_query.get_goal_general();
+                                                                                                              result["model_queries"][index]["goal_specific"] = model_query.get_goal_specific();
+                                                                                                              index++;
+                                                                                                          }
+                                                                                                          res.code = 201; // Created
+                                                                                                          res.set_header("Location", "/quizzes/" + registered->id);
+                                                                                                          res.set_header("Content-Type", "application/json");
+                                                                                                          res.write(result.dump());
+
+                                                                                                          return res;
+                                                                                                      }
+                                                                                                      catch (const std::invalid_argument &e)
+                                                                                                      {
+                                                                                                          // the dataset of the request, see read_quiz
+                                                                                                          res.code = 400; // Bad Request
+                                                                                                          res.write(e.what());
+                                                                                                          return res;
+                                                                                                      }
+                                                                                                      catch (const std::exception &e)
+                                                                                                      {
+                                                                                                          std::cerr << "Exception occurred: " << e.what() << std::endl;
+                                                                                                          res.code = 500;
+                                                                                                          res.write("Internal Server Error: " + std::string(e.what()));
+                                                                                                          return res;
+                                                                                                      } });
+
+    CROW_ROUTE(app, "/quizzes/<string>").methods(crow::HTTPMethod::DELETE)([&quizzes, &practice](const std::string &id)
+                                                                           {
+                                                                               crow::response res;
+                                                                               res.code = quizzes.remove(id) ? 204 : 404; // No Content or Not Found
+                                                                               {
+                                                                                   std::lock_guard<std::mutex> lock(practice.mutex);
+                                                                                   practice.graders.erase(id);
+                                                                               }
+                                                                               return res; });
+
+    // **Practice** grades one submission of a registered quiz at a time, on engines that keep the quiz warm
+    CROW_ROUTE(app, "/quizzes/<string>/submissions").methods(crow::HTTPMethod::POST, crow::HTTPMethod::OPTIONS)([&quizzes, &practice, &scheduler, &tenant_tokens](const crow::request &req, const std::string &id)
+                                                                                                                {
+                                                                                                                    crow::response res;
+
+                                                                                                                    if (req.method == "OPTIONS"_method)
+                                                                                                                    {
+                                                                                                                        // For preflight requests, return a response with no content
+                                                                                                                        res.code = 204; // No Content
+                                                                                                                        return res;
+                                                                                                                    }
+
+                                                                                                                    try
+                                                                                                                    {
+                                                                                                                        auto body = crow::json::load(req.body);
+                                                                                                                        if (!body)
+                                                                                                                        {
+                                                                                                                            res.code = 400; // Bad Request
+                                                                                                                            res.write("Invalid JSON");
+                                                                                                                            return res;
+                                                                                                                        }
+                                                                                                                        // one entry of the queries of /grade-queries: Org Defined ID, Attempt #, Q # and Answer
+                                                                                                                        if (!body.has("query") || body["query"].size() != 4)
+                                                                                                                        {
+                                                                                                                            res.code = 400; // Bad Request
+                                                                                                                            res.write("Missing the required field: query");
+                                                                                                                            return res;
+                                                                                                                        }
+
+                                                                                                                        // an unknown quiz does not take a share of the budget
+                                                                                                                        if (!quizzes.find(id))
+                                                                                                                        {
+                                                                                                                            res.code = 404; // Not Found
+                                                                                                                            res.write("Unknown quiz");
+                                                                                                                            return res;
+                                                                                                                        }
+                                                                                                                        std::shared_ptr<const GradingScheduler::ticket> ticket = scheduler.admit(tenant_of(req, tenant_tokens), GradingScheduler::lane::INTERACTIVE);
+                                                                                                                        if (!ticket)
+                                                                                                                        {
+                                                                                                                            return too_busy(scheduler);
+                                                                                                                        }
+                                                                                                                        // the quiz may have been removed while the submission waited
+                                                                                                                        std::shared_ptr<PracticeGrader> grader = find_practice_grader(id, quizzes, practice);
+                                                                                                                        if (!grader)
+                                                                                                                        {
+                                                                                                                            res.code = 404; // Not Found
+                                                                                                                            res.write("Unknown quiz");
+                                                                                                                            return res;
+                                                                                                                        }
+
+                                                                                                                        const auto &query = body["query"];
+                                                                                                                        StudentQuery submission(query[0].s(), query[3].s(), query[2].s(), query[1].i());
+                                                                                                                        crow::json::wvalue record = grading_record(grader->grade(submission));
+
+                                                                                                                        res.code = 200; // OK
+                                                                                                                        res.set_header("Content-Type", "application/json");
+                                                                                                                        res.write(record.dump());
+
+                                                                                                                        return res;
+                                                                                                                    }
+                                                                                                                    catch (const std::exception &e)
+                                                                                                                    {
+                                                                                                                        std::cerr << "Exception occurred: " << e.what() << std::endl;
+                                                                                                                        res.code = 500;
+                                                                                                                        res.write("Internal Server Error: " + std::string(e.what()));
+                                                                                                                        return res;
+                                                                                                                    } });
+
+    // **Grading jobs** grade in the background, the client polls the job instead of waiting on /grade-queries
+    CROW_ROUTE(app, "/jobs").methods(crow::HTTPMethod::POST, crow::HTTPMethod::OPTIONS)([&jobs, &quizzes, &datasets, &scheduler, &tenant_tokens](const crow::request &req)
+                                                                                    {
+                                                                                        std::cout << "Received /jobs request with method: " << crow::method_name(req.method) << std::endl;
+
+                                                                                        crow::response res;
+
+                                                                                        if (req.method == "OPTIONS"_method)
+                                                                                        {
+                                                                                            // For preflight requests, return a response with no content
+                                                                                            res.code = 204; // No Content
+                                                                                            return res;
+                                                                                        }
+
+                                                                                        auto body = crow::json::load(req.body);
+                                                                                        if (!body)
+                                                                                        {
+                                                                                            res.code = 400; // Bad Request
+                                                                                            res.write("Invalid JSON");
+                                                                                            return res;
+                                                                                        }
+                                                                                        // the same fields as /grade-queries
+                                                                                        if (!has_grading_fields(body))
+                                                                                        {
+                                                                                            res.code = 400; // Bad Request
+                                                                                            res.write("Missing one or more required fields: sqlData, queries, options");
+                                                                                            return res;
+                                                                                        }
+
+                                                                                        std::shared_ptr<const QuizStore::quiz> quiz;
+                                                                                        try
+                                                                                        {
+                                                                                            quiz = find_quiz(body, quizzes, datasets);
+                                                                                        }
+                                                                                        catch (const std::invalid_argument &e)
+                                                                                        {
+                                                                                            // the dataset of the request, see read_quiz
+                                                                                            res.code = 400; // Bad Request
+                                                                                            res.write(e.what());
+                                                                                            return res;
+                                                                                        }
+                                                                                        if (!quiz)
+                                                                                        {
+                                                                                            res.code = 404; // Not Found
+                                                                                            res.write("Unknown quiz");
+                                                                                            return res;
+                                                                                        }
+
+                                                                                        // the job parses the body again, the parsed body does not outlive the request
+                                                                                        std::string request_body = req.body;
+                                                                                        std::string id;
+                                                                                        std::string tenant = tenant_of(req, tenant_tokens);
+                                                                                        bool queued = jobs.submit([request_body, quiz, tenant, &scheduler](ProcessQueries::progress &progress, const GradingJobs::record_sink &add_record)
+                                                                                                                  {
+                                                                                                                  // the jobs wait in a queue of their own, so a job is never refused here
+                                                                                                                  auto ticket = scheduler.admit(tenant, GradingScheduler::lane::BULK, false);
+                                                                                            auto job_body = crow::json::load(request_body);
+                                                                                            grade_queries(job_body, *quiz, &progress, [&add_record](std::size_t position, const ProcessQueries::grading_info &info)
+                                                                                                          {
+                                                                                                // the records are added in the order the students are graded, the index is the place of the student in the request
+                                                                                                crow::json::wvalue record = grading_record(info);
+                                                                                                record["Index"] = position;
+                                                                                                add_record(position, record.dump()); }, ticket->cost); }, id);
+                                                                                        if (!queued)
+                                                                                        {
+                                                                                            res.code = 503; // Service Unavailable
+                                                                                            res.set_header("Retry-After", "30");
+                                                                                            res.write("Too many grading jobs, try again later");
+                                                                                            return res;
+                                                                                        }
+
+                                                                                        crow::json::wvalue result;
+                                                                                        result["id"] = id;
+                                                                                        result["status"] = GradingJobs::to_string(GradingJobs::status::QUEUED);
+                                                                                        res.code = 202; // Accepted
+                                                                                        res.set_header("Location", "/jobs/" + id);
+                                                                                        res.set_header("Content-Type", "application/json");
+                                                                                        res.write(result.dump());
+
+                                                                                        return res; });
+
+    CROW_ROUTE(app, "/jobs/<string>").methods(crow::HTTPMethod::GET)([&jobs](const std::string &id)
+                                                                 {
+                                                                     crow::response res;
+
+                                                                     GradingJobs::snapshot job;
+                                                                     if (!jobs.find(id, job))
+                                                                     {
+                                                                         res.code = 404; // Not Found
+                                                                         res.write("Unknown job");
+                                                                         return res;
+                                                                     }
+
+                                                                     // the stage counts are out of the distinct answers, students with the same answer are graded once
+                                                                     crow::json::wvalue result;
+                                                                     result["id"] = id;
+                                                                     result["status"] = GradingJobs::to_string(job.state);
+                                                                     result["students"] = job.students;
+                                                                     result["answers"] = job.answers;
+                                                                     result["progress"]["pre_process"] = job.pre_processed;
+                                                                     result["progress"]["syntax"] = job.syntax;
+                                                                     result["progress"]["results"] = job.results;
+                                                                     result["progress"]["semantics"] = job.semantics;
+                                                                     result["progress"]["grading"] = job.graded;
+                                                                     if (job.state == GradingJobs::status::FAILED)
+                                                                     {
+                                                                         result["error"] = job.error;
+                                                                     }
+
+                                                                     res.code = 200; // OK
+                                                                     res.set_header("Content-Type", "application/json");
+                                                                     res.write(result.dump());
+
+                                                                     return res; });
+
+    CROW_ROUTE(app, "/jobs/<string>/results").methods(crow::HTTPMethod::GET)([&jobs](const std::string &id)
+                                                                         {
+                                                                             crow::response res;
+
+                                                                             GradingJobs::snapshot job;
+                                                                             if (!jobs.find(id, job))
+                                                                             {
+                                                                                 res.code = 404; // Not Found
+                                                                                 res.write("Unknown job");
+                                                                                 return res;
+                                                                             }
+                                                                             if (job.state == GradingJobs::status::FAILED)
+                                                                             {
+                                                                                 res.code = 500;
+                                                                                 res.write("Internal Server Error: " + job.error);
+                                                                                 return res;
+                                                                             }
+
+                                                                             std::string results;
+                                                                             const bool done = jobs.results(id, results);
+                                                                             if (!done && job.state == GradingJobs::status::DONE)
+                                                                             {
+                                                                                 // the records were read from /jobs/{id}/records, which released them
+                                                                                 res.code = 410; // Gone
+                                                                                 res.write("The records of the job were already read from /jobs/" + id + "/records");
+                                                                                 return res;
+                                                                             }
+                                                                             if (!done)
+                                                                             {
+                                                                                 // not finished yet, the client polls /jobs/{id} until it is done
+                                                                                 crow::json::wvalue result;
+                                                                                 result["id"] = id;
+                                                                                 result["status"] = GradingJobs::to_string(job.state);
+                                                                                 res.code = 202; // Accepted
+                                                                                 res.set_header("Content-Type", "application/json");
+                                                                                 res.write(result.dump());
+                                                                                 return res;
+                                                                             }
+
+                                                                             res.code = 200; // OK
+                                                                             res.set_header("Content-Type", "application/json");
+                                                                             res.write(results);
+
+                                                                             return res; });
+
+    CROW_ROUTE(app, "/jobs/<string>/records").methods(crow::HTTPMethod::GET)([&jobs](const crow::request &req, const std::string &id)
+                                                                         {
+                                                                             crow::response res;
+
+                                                                             // ?from=n skips the records the client already has, and releases them on the server
+                                                                             std::size_t from = 0;
+                                                                             if (const char *from_param = req.url_params.get("from"))
+                                                                             {
+                                                                                 from = std::strtoull(from_param, nullptr, 10);
+                                                                             }
+
+                                                                             const std::size_t requested = from;
+                                                                             std::vector<std::string> records;
+                                                                             GradingJobs::status state;
+                                                                             if (!jobs.records(id, from, records, state))
+                                                                             {
+                                                                                 res.code = 404; // Not Found
+                                                                                 res.write("Unknown job");
+                                                                                 return res;
+                                                                             }
+                                                                             if (from != requested)
+                                                                             {
+                                                                                 res.code = 410; // Gone
+                                                                                 res.write("The records before " + std::to_string(from) + " were already read");
+                                                                                 return res;
+                                                                             }
+
+                                                                             // one JSON record per line, in the order the students were graded. The client asks again from the next record
+                                                                             // until the status is done or failed
+                                                                             std::string lines;
+                                                                             for (const auto &record : records)
+                                                                             {
+                                                                                 lines += record;
+                                                                                 lines += '\n';
+                                                                             }
+                                                                             res.code = 200; // OK
+                                                                             res.set_header("Content-Type", "application/x-ndjson");
+                                                                             res.set_header("X-Job-Status", GradingJobs::to_string(state));
+                                                                             res.set_header("X-Next-Record", std::to_string(from + records.size()));
+                                                                             // the frontend is served from another origin
+                                                                             res.set_header("Access-Control-Expose-Headers", "X-Job-Status, X-Next-Record");
+                                                                             res.write(lines);
+
+                                                                             return res; });
+
+    // **Datasets** upload the script of a database or the Parquet or CSV file of a table once, then send its hash with
+    // "dataset_sha256" or the "sha256" of the table instead
+    CROW_ROUTE(app, "/datasets/<string>").methods(crow::HTTPMethod::PUT, crow::HTTPMethod::HEAD, crow::HTTPMethod::DELETE, crow::HTTPMethod::OPTIONS)([&datasets](const crow::request &req, const std::string &hash)
+                                                                                                                                                      {
+                                                                                                                                                          crow::response res;
+
+                                                                                                                                                          if (req.method == "OPTIONS"_method)
+                                                                                                                                                          {
+                                                                                                                                                              // For preflight requests, return a response with no content
+                                                                                                                                                              res.code = 204; // No Content
+                                                                                                                                                              return res;
+                                                                                                                                                          }
+                                                                                                                                                          if (!DatasetStore::is_hash(hash))
+                                                                                                                                                          {
+                                                                                                                                                              res.code = 400; // Bad Request
+                                                                                                                                                              res.write("A dataset is named by the SHA-256 of its content in lowercase hexadecimal");
+                                                                                                                                                              return res;
+                                                                                                                                                          }
+
+                                                                                                                                                          try
+                                                                                                                                                          {
+                                                                                                                                                              if (req.method == "HEAD"_method)
+                                                                                                                                                              {
+                                                                                                                                                                  res.code = datasets.contains(hash) ? 200 : 404; // OK or Not Found
+                                                                                                                                                                  res.set_header("X-Reference-Count", std::to_string(datasets.references(hash)));
+                                                                                                                                                                  // the frontend is served from another origin
+                                                                                                                                                                  res.set_header("Access-Control-Expose-Headers", "X-Reference-Count");
+                                                                                                                                                                  return res;
+                                                                                                                                                              }
+                                                                                                                                                              if (req.method == "DELETE"_method)
+                                                                                                                                                              {
+                                                                                                                                                                  switch (datasets.remove(hash))
+                                                                                                                                                                  {
+                                                                                                                                                                  case DatasetStore::removal::REMOVED:
+                                                                                                                                                                      res.code = 204; // No Content
+                                                                                                                                                                      break;
+                                                                                                                                                                  case DatasetStore::removal::UNKNOWN:
+                                                                                                                                                                      res.code = 404; // Not Found
+                                                                                                                                                                      break;
+                                                                                                                                                                  case DatasetStore::removal::REFERENCED:
+                                                                                                                                                                      res.code = 409; // Conflict
+                                                                                                                                                                      res.write("The dataset is used by a quiz or a grading");
+                                                                                                                                                                      break;
+                                                                                                                                                                  }
+                                                                                                                                                                  return res;
+                                                                                                                                                              }
+                                                                                                                                                              // the body is the script or the file itself, not JSON
+                                                                                                                                                              try
+                                                                                                                                                              {
+                                                                                                                                                                  res.code = datasets.put(hash, req.body) ? 201 : 200; // Created or OK
+                                                                                                                                                              }
+                                                                                                                                                              catch (const std::invalid_argument &e)
+                                                                                                                                                              {
+                                                                                                                                                                  res.code = 400; // Bad Request
+                                                                                                                                                                  res.write(e.what());
+                                                                                                                                                                  return res;
+                                                                                                                                                              }
+                                                                                                                                                              res.set_header("Location", "/datasets/" + hash);
+                                                                                                                                                              return res;
+                                                                                                                                                          }
+                                                                                                                                                          catch (const std::exception &e)
+                                                                                                                                                          {
+                                                                                                                                                              std::cerr << "Exception occurred: " << e.what() << std::endl;
+                                                                                                                                                              res.code = 500;
+                                                                                                                                                              res.write("Internal Server Error: " + std::string(e.what()));
+                                                                                                                                                              return res;
+                                                                                                                                                          } });
+
+    // **Database cache** the counters of the databases kept between requests
+    CROW_ROUTE(app, "/database-cache").methods(crow::HTTPMethod::GET)([]()
+                                                                      {
+                                                                          crow::response res;
+
+                                                                          DatabaseCache::stats stats = DatabaseCache::shared().statistics();
+                                                                          crow::json::wvalue result;
+                                                                          result["hits"] = stats.hits;
+                                                                          result["misses"] = stats.misses;
+                                                                          result["evictions"] = stats.evictions;
+                                                                          result["entries"] = stats.entries;
+                                                                          result["bytes"] = stats.bytes;
+                                                                          result["budget"] = stats.budget;
+
+                                                                          res.code = 200; // OK
+                                                                          res.set_header("Content-Type", "application/json");
+                                                                          res.write(result.dump());
+
+                                                                          return res; });
+
+    // **Scheduler** the counters of the admission of the gradings
+    CROW_ROUTE(app, "/scheduler").methods(crow::HTTPMethod::GET)([&scheduler]()
+                                                                 {
+                                                                     crow::response res;
+
+                                                                     GradingScheduler::stats stats = scheduler.statistics();
+                                                                     crow::json::wvalue result;
+                                                                     result["budget"] = stats.budget;
+                                                                     result["running"] = stats.running;
+                                                                     result["waiting"] = stats.waiting;
+                                                                     result["admitted"] = stats.admitted;
+                                                                     result["refused"] = stats.refused;
+
+                                                                     res.code = 200; // OK
+                                                                     res.set_header("Content-Type", "application/json");
+                                                                     res.write(result.dump());
+
+                                                                     return res; });
+
+    // responses are compressed with gzip for the clients that accept it
+    app.use_compression(crow::compression::algorithm::GZIP);
+    app.port(5000).concurrency(static_cast<std::uint16_t>(std::min<std::size_t>(request_threads, UINT16_MAX))).run();
 }
 
 Grader::grading_options set_grading_options(int syntax, int semantics, int results, int order_of_importance)
@@ -372,3 +907,326 @@ Grader::grading_options set_grading_options(int syntax, int semantics, int resul
     }
     return options;
 }
+
+bool has_quiz_fields(const crow::json::rvalue &body)
+{
+    // a stored dataset stands for the script
+    bool has_database = body.has("dataset_sha256") || (body.has("sql_data") && body.has("sql_create_data"));
+    return has_database && body.has("model_queries") &&
+           body.has("syntax") && body.has("semantics") && body.has("results") &&
+           body.has("prop_order") && body.has("edit_dist") && body.has("tree_dist") && body.has("check_order") &&
+           body.has("auto_db") && body.has("num_db") && body.has("dbname") && body.has("use_postgresql");
+}
+
+bool has_grading_fields(const crow::json::rvalue &body)
+{
+    // a registered quiz stands for the database, the model queries and the options
+    return body.has("queries") && (body.has("quiz_id") || has_quiz_fields(body));
+}
+
+QuizStore::quiz read_quiz(const crow::json::rvalue &body, DatasetStore &datasets)
+{
+    QuizStore::quiz quiz;
+    // **Extract Model Queries**
+    // Expected JSON structure:
+    /*
+    {
+        "model": [
+            "SELECT * FROM students;",
+            "SELECT * FROM courses;"
+        ]
+    }
+    */
+    int index = 1;
+    for (const auto &query : body["model_queries"])
+    {
+        std::string element = query.s();
+        std::string id = std::to_string(index);
+
+        // If the string begins and ends with quotes, remove them
+        if (element.size() > 1 && element.front() == '\"' && element.back() == '\"')
+        {
+            element.erase(0, 1);               // Remove first character
+            element.erase(element.size() - 1); // Remove last character
+
+            // Replace "" with "
+            size_t position = element.find("\"\"");
+            while (position != std::string::npos)
+            {
+                element.replace(position, 2, "\"");
+                position = element.find("\"\"", position + 1);
+            }
+        }
+        ModelQuery model_query(std::to_string(index++), element);
+        quiz.model_queries.push_back(model_query);
+    }
+    // the grading of a model query that is not parseable fails, the request is refused instead
+    QuizStore::check(quiz.model_queries);
+
+    // **Extract Options**
+    // Expected JSON structure:
+    /*
+    {
+        "syntax": 3,
+        "semantics": 8,
+        "results": 3,
+        "prop_order": 5,
+        "edit_dist": 4,
+        "tree_dist": 4,
+        "check_order": 0,
+        "auto_db": 1,
+        "num_db": 3,
+        "sql_create": "create table ...",
+        "dbname": "my_database"
+    }
+    */
+    int syntax_sensitivity = body["syntax"].i();
+    int semantics_sensitivity = body["semantics"].i();
+    int results_sensitivity = body["results"].i();
+    int prop_order = body["prop_order"].i();
+    int edit_dist = body["edit_dist"].i();
+    int tree_dist = body["tree_dist"].i();
+    int check_order = body["check_order"].i();
+    int auto_db = body["auto_db"].i();
+    int num_db = body["num_db"].i();
+    std::string dbname = body["dbname"].s();
+    dbname = "grader";
+    bool use_postgresql = body["use_postgresql"].b();
+
+    // set grading options
+    Grader::grading_options grading_options = set_grading_options(syntax_sensitivity, semantics_sensitivity, results_sensitivity, prop_order);
+
+    // Initialize the Admin object
+    Admin &admin = quiz.admin;
+    admin.init(grading_options.syntax, grading_options.semantics, grading_options.results, grading_options.order_of_importance, (check_order == 1), edit_dist, tree_dist);
+    // optional: "tree_algorithm": "apted" computes the tree edit distances with APTED instead of Zhang-Shasha
+    if (body.has("tree_algorithm") && body["tree_algorithm"].s() == "apted")
+    {
+        admin.set_tree_edit_distance_algorithm(TreeEditDistance::algorithm::APTED);
+    }
+    // optional: "semantics_prefilter": "pq_gram" and "pq_gram_distance": 0.6 skip the exact tree edit distance for obviously different queries
+    if (body.has("semantics_prefilter") && body["semantics_prefilter"].s() == "pq_gram")
+    {
+        double pq_gram_distance = body.has("pq_gram_distance") ? body["pq_gram_distance"].d() : admin.get_max_pq_gram_distance();
+        admin.set_semantics_prefilter(Admin::semantics_prefilter::PQ_GRAM, pq_gram_distance);
+    }
+
+    // Extract the .sql file path, or the script of the stored dataset "dataset_sha256": "9f86d081..."
+    std::string sql_create_insert_data;
+    if (body.has("dataset_sha256"))
+    {
+        std::string hash = body["dataset_sha256"].s();
+        auto dataset = datasets.acquire(hash);
+        if (!dataset)
+        {
+            throw std::invalid_argument("Unknown dataset " + hash + ", upload it with PUT /datasets/" + hash);
+        }
+        sql_create_insert_data = *dataset->content;
+        quiz.datasets.push_back(std::move(dataset));
+    }
+    else
+    {
+        sql_create_insert_data = body["sql_data"].s();
+    }
+    // for now skip the evosql part in the argment ""
+    quiz.db_opts = {sql_create_insert_data, auto_db, num_db, sql_create_insert_data, "", dbname, true, use_postgresql};
+    quiz.db_opts.dataset_tables = read_dataset(body, datasets, quiz.datasets);
+    if (body.has("dataset_sha256"))
+    {
+        // the store checked the hash on upload, the cached database is found without hashing the script again
+        quiz.db_opts.dataset_sha256 = body["dataset_sha256"].s();
+    }
+    return quiz;
+}
+
+std::vector<Admin::dataset_table> read_dataset(const crow::json::rvalue &body, DatasetStore &datasets,
+                                               std::vector<std::shared_ptr<const DatasetStore::reference>> &references)
+{
+    std::vector<Admin::dataset_table> tables;
+    if (!body.has("dataset"))
+    {
+        return tables;
+    }
+    for (const auto &table : body["dataset"])
+    {
+        if (!table.has("table") || (!table.has("path") && !table.has("sha256")))
+        {
+            throw std::invalid_argument("A table of the dataset needs a table and a path or a sha256");
+        }
+        std::filesystem::path path;
+        std::string format;
+        if (table.has("sha256"))
+        {
+            // a stored file, DuckDB reads it from the store
+            std::string hash = table["sha256"].s();
+            auto file = datasets.acquire(hash, false);
+            if (!file)
+            {
+                throw std::invalid_argument("Unknown dataset " + hash + ", upload it with PUT /datasets/" + hash);
+            }
+            if (!table.has("format"))
+            {
+                throw std::invalid_argument("The stored file " + hash + " of table " + std::string(table["table"].s()) + " needs a format");
+            }
+            path = file->path;
+            format = table["format"].s();
+            references.push_back(std::move(file));
+        }
+        else
+        {
+            // the server only reads the files an administrator put in the dataset directory
+            const char *directory = std::getenv("SOCOLES_DATASET_DIR");
+            if (directory == nullptr)
+            {
+                throw std::invalid_argument("Datasets are not enabled on this server");
+            }
+            const std::filesystem::path root = std::filesystem::weakly_canonical(directory);
+            std::string relative = table["path"].s();
+            path = std::filesystem::weakly_canonical(root / relative);
+            bool outside = std::mismatch(root.begin(), root.end(), path.begin(), path.end()).first != root.end();
+            if (relative.empty() || std::filesystem::path(relative).is_absolute() || outside)
+            {
+                throw std::invalid_argument("The file " + relative + " is not in the dataset directory");
+            }
+            format = table.has("format") ? std::string(table["format"].s()) : path.extension().string();
+        }
+        std::transform(format.begin(), format.end(), format.begin(), ::tolower);
+        Admin::dataset_format dataset_format;
+        if (format == "parquet" || format == ".parquet")
+        {
+            dataset_format = Admin::dataset_format::PARQUET;
+        }
+        else if (format == "csv" || format == ".csv")
+        {
+            dataset_format = Admin::dataset_format::CSV;
+        }
+        else
+        {
+            throw std::invalid_argument("The file " + path.filename().string() + " of table " + std::string(table["table"].s()) + " is neither Parquet nor CSV");
+        }
+        tables.push_back({table["table"].s(), path.string(), dataset_format});
+    }
+    return tables;
+}
+
+std::shared_ptr<const QuizStore::quiz> find_quiz(const crow::json::rvalue &body, const QuizStore &quizzes, DatasetStore &datasets)
+{
+    if (body.has("quiz_id"))
+    {
+        return quizzes.find(body["quiz_id"].s());
+    }
+    return std::make_shared<const QuizStore::quiz>(read_quiz(body, datasets));
+}
+
+void grade_queries(const crow::json::rvalue &body, const QuizStore::quiz &quiz, ProcessQueries::progress *job_progress, const ProcessQueries::graded_callback &on_graded,
+                   std::size_t threads)
+{
+    // **Extract Student Queries** we only care about Org Defined ID, Attempt #, Q # and Answer
+    // Expected JSON structure:
+    /*
+    {
+        "queries": [
+            "ID123",
+            1,
+            "Q1",
+            "SELECT * FROM students;"
+        ],
+        // ... more entries
+    }
+    */
+    std::vector<StudentQuery> student_queries;
+    for (const auto &query : body["queries"])
+    {
+        // StudentQuery student_query(id, query, question_number, attempt_number);
+        StudentQuery student_query(query[0].s(), query[3].s(), query[2].s(), query[1].i());
+        student_queries.push_back(student_query);
+    }
+
+    // Process the queries
+    Grader grader;
+    // the model queries of a registered quiz are already pre-processed, the copies share their trees and outputs
+    std::vector<ModelQuery> model_queries = quiz.model_queries;
+    ProcessQueries process_queries(model_queries, student_queries, quiz.db_opts, quiz.admin, grader, job_progress, on_graded, threads);
+}
+
+crow::json::wvalue grading_record(const ProcessQueries::grading_info &info)
+{
+    crow::json::wvalue record;
+    record["Org Defined ID"] = info.org_defined_id;
+    record["Attempt #"] = info.attempt_number;
+    record["Q #"] = info.question_number;
+    record["Query"] = info.query;
+    record["Grade"] = info.grade;
+    record["Out Of"] = info.out_of;
+    record["Feedback"] = info.feedback;
+    return record;
+}
+
+std::shared_ptr<PracticeGrader> find_practice_grader(const std::string &quiz_id, const QuizStore &quizzes, practice_graders &practice)
+{
+    {
+        std::lock_guard<std::mutex> lock(practice.mutex);
+        auto it = practice.graders.find(quiz_id);
+        if (it != practice.graders.end())
+        {
+            return it->second;
+        }
+    }
+    std::shared_ptr<const QuizStore::quiz> quiz = quizzes.find(quiz_id);
+    if (!quiz)
+    {
+        return nullptr;
+    }
+    // the database is loaded without the lock, if two first submissions race the grader made first is kept
+    auto grader = std::make_shared<PracticeGrader>(quiz);
+    std::lock_guard<std::mutex> lock(practice.mutex);
+    // a quiz removed in the meantime gets no grader, it would keep the engines and the datasets of the quiz forever.
+    // the removal erases the grader under this lock after it forgets the quiz
+    if (quizzes.find(quiz_id) != quiz)
+    {
+        return nullptr;
+    }
+    return practice.graders.emplace(quiz_id, grader).first->second;
+}
+
+std::map<std::string, std::string> read_tenant_tokens(const char *tokens)
+{
+    std::map<std::string, std::string> tenant_tokens;
+    std::stringstream list(tokens != nullptr ? tokens : "");
+    std::string entry;
+    while (std::getline(list, entry, ','))
+    {
+        std::size_t equals = entry.find('=');
+        if (equals != std::string::npos && equals > 0 && equals + 1 < entry.size())
+        {
+            tenant_tokens[entry.substr(0, equals)] = entry.substr(equals + 1);
+        }
+    }
+    return tenant_tokens;
+}
+
+std::string tenant_of(const crow::request &req, const std::map<std::string, std::string> &tenant_tokens)
+{
+    const std::string bearer = "Bearer ";
+    std::string authorization = req.get_header_value("Authorization");
+    if (authorization.compare(0, bearer.size(), bearer) == 0)
+    {
+        auto it = tenant_tokens.find(authorization.substr(bearer.size()));
+        if (it != tenant_tokens.end())
+        {
+            return it->second;
+        }
+    }
+    return req.remote_ip_address;
+}
+
+crow::response too_busy(const GradingScheduler &scheduler)
+{
+    crow::response res;
+    res.code = 429; // Too Many Requests
+    res.set_header("Retry-After", std::to_string(scheduler.retry_after()));
+    // the frontend is served from another origin
+    res.set_header("Access-Control-Expose-Headers", "Retry-After");
+    res.write("Too many gradings are waiting, try again later");
+    return res;
+}
@@ -0,0 +1,397 @@
+#include "sql_lexer.h"
+#include "keyword_index.h"
+#include <cctype>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace
+{
+    // "´" in UTF-8. Students use it in place of a backtick, so it is read as a quote.
+    constexpr std::string_view acute_accent = "\xC2\xB4";
+
+    bool is_space(char c)
+    {
+        return std::isspace(static_cast<unsigned char>(c)) != 0;
+    }
+
+    bool is_digit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    bool is_word_char(std::string_view sql, std::size_t pos)
+    {
+        unsigned char c = static_cast<unsigned char>(sql[pos]);
+        if (c >= 0x80)
+        {
+            return sql.substr(pos, acute_accent.size()) != acute_accent;
+        }
+        return std::isalnum(c) || c == '_' || c == '$';
+    }
+
+    bool is_operator_char(char c)
+    {
+        switch (c)
+        {
+        case '+':
+        case '-':
+        case '*':
+        case '/':
+        case '<':
+        case '>':
+        case '=':
+        case '~':
+        case '!':
+        case '@':
+        case '#':
+        case '%':
+        case '^':
+        case '&':
+        case '|':
+        case '?':
+        case ':':
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool starts_comment(std::string_view sql, std::size_t pos)
+    {
+        return pos + 1 < sql.size() && ((sql[pos] == '-' && sql[pos + 1] == '-') || (sql[pos] == '/' && sql[pos + 1] == '*'));
+    }
+
+    /**
+     * Returns the offset just past a quoted run that starts at pos. A doubled closing quote is an escaped quote.
+     */
+    std::size_t skip_quoted(std::string_view sql, std::size_t pos, std::string_view quote)
+    {
+        pos += quote.size();
+        while (pos < sql.size())
+        {
+            if (sql.substr(pos, quote.size()) == quote)
+            {
+                pos += quote.size();
+                if (sql.substr(pos, quote.size()) != quote)
+                {
+                    return pos;
+                }
+                pos += quote.size();
+            }
+            else
+            {
+                ++pos;
+            }
+        }
+        return sql.size();
+    }
+
+    /**
+     * Returns the text between the quotes of a quoted token.
+     */
+    std::string_view unquote(std::string_view text)
+    {
+        std::string_view quote = text.substr(0, text.rfind(acute_accent, 0) == 0 ? acute_accent.size() : 1);
+        text.remove_prefix(quote.size());
+        if (text.size() >= quote.size() && text.substr(text.size() - quote.size()) == quote)
+        {
+            text.remove_suffix(quote.size());
+        }
+        return text;
+    }
+
+    /**
+     * Process-wide table of interned words. Queries are tokenized concurrently by the grading pool, so lookups take
+     * a shared lock and only a new word takes the exclusive one. The words live in a deque so that references to
+     * them stay valid when more words are added.
+     */
+    struct word_registry
+    {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string, SqlLexer::word_id> ids;
+        std::deque<std::string> words;
+    };
+    word_registry &get_word_registry()
+    {
+        static word_registry registry;
+        return registry;
+    }
+}
+
+std::vector<SqlLexer::token> SqlLexer::tokenize(std::string_view sql)
+{
+    const KeywordIndex &keywords = KeywordIndex::sql_2016();
+    std::vector<token> tokens;
+    std::size_t pos = 0;
+    while (pos < sql.size())
+    {
+        char c = sql[pos];
+        std::size_t start = pos;
+        if (is_space(c))
+        {
+            ++pos;
+            continue;
+        }
+        if (starts_comment(sql, pos))
+        {
+            if (c == '-')
+            {
+                std::size_t end = sql.find('\n', pos);
+                pos = end == std::string_view::npos ? sql.size() : end + 1;
+            }
+            else
+            {
+                std::size_t end = sql.find("*/", pos + 2);
+                pos = end == std::string_view::npos ? sql.size() : end + 2;
+            }
+            continue;
+        }
+
+        token_class type;
+        if (c == '\'')
+        {
+            pos = skip_quoted(sql, pos, "'");
+            type = token_class::STRING_LITERAL;
+        }
+        else if (c == '"' || c == '`')
+        {
+            pos = skip_quoted(sql, pos, sql.substr(pos, 1));
+            type = token_class::QUOTED_IDENTIFIER;
+        }
+        else if (sql.substr(pos, acute_accent.size()) == acute_accent)
+        {
+            pos = skip_quoted(sql, pos, acute_accent);
+            type = token_class::QUOTED_IDENTIFIER;
+        }
+        else if (is_digit(c) || (c == '.' && pos + 1 < sql.size() && is_digit(sql[pos + 1])))
+        {
+            while (pos < sql.size() && (is_digit(sql[pos]) || sql[pos] == '.'))
+            {
+                ++pos;
+            }
+            // exponent, e.g. 1e-5
+            if (pos + 1 < sql.size() && (sql[pos] == 'e' || sql[pos] == 'E'))
+            {
+                std::size_t exponent = pos + 1;
+                if (sql[exponent] == '+' || sql[exponent] == '-')
+                {
+                    ++exponent;
+                }
+                if (exponent < sql.size() && is_digit(sql[exponent]))
+                {
+                    pos = exponent;
+                    while (pos < sql.size() && is_digit(sql[pos]))
+                    {
+                        ++pos;
+                    }
+                }
+            }
+            type = token_class::NUMBER;
+        }
+        else if (is_word_char(sql, pos))
+        {
+            while (pos < sql.size() && is_word_char(sql, pos))
+            {
+                ++pos;
+            }
+            type = keywords.contains(std::string(sql.substr(start, pos - start))) ? token_class::KEYWORD : token_class::IDENTIFIER;
+        }
+        else if (is_operator_char(c))
+        {
+            while (pos < sql.size() && is_operator_char(sql[pos]) && !starts_comment(sql, pos))
+            {
+                ++pos;
+            }
+            type = token_class::OPERATOR;
+        }
+        else
+        {
+            ++pos;
+            type = token_class::PUNCTUATION;
+        }
+        tokens.push_back({type, start, pos - start});
+    }
+    return tokens;
+}
+
+std::string_view SqlLexer::text(std::string_view sql, const token &t)
+{
+    return sql.substr(t.begin, t.length);
+}
+
+bool SqlLexer::is_word(const token &t)
+{
+    return t.type == token_class::KEYWORD || t.type == token_class::IDENTIFIER;
+}
+
+std::vector<std::string> SqlLexer::split_words(std::string_view sql)
+{
+    std::vector<std::string> words;
+    std::size_t word_begin = 0;
+    std::size_t word_end = 0;
+    bool in_word = false;
+    for (const auto &t : tokenize(sql))
+    {
+        bool separator = t.type == token_class::PUNCTUATION && (sql[t.begin] == ',' || sql[t.begin] == ';');
+        // tokens that touch belong to the same word
+        if (in_word && (separator || t.begin != word_end))
+        {
+            words.emplace_back(sql.substr(word_begin, word_end - word_begin));
+            in_word = false;
+        }
+        if (separator)
+        {
+            continue;
+        }
+        if (!in_word)
+        {
+            word_begin = t.begin;
+            in_word = true;
+        }
+        word_end = t.begin + t.length;
+    }
+    if (in_word)
+    {
+        words.emplace_back(sql.substr(word_begin, word_end - word_begin));
+    }
+    return words;
+}
+
+SqlLexer::word_id SqlLexer::intern_word(std::string_view word)
+{
+    auto &registry = get_word_registry();
+    std::string key(word);
+    {
+        std::shared_lock lock(registry.mutex);
+        auto it = registry.ids.find(key);
+        if (it != registry.ids.end())
+        {
+            return it->second;
+        }
+    }
+    std::unique_lock lock(registry.mutex);
+    // emplace keeps the existing id if another thread interned the word in between
+    auto [it, inserted] = registry.ids.emplace(key, static_cast<word_id>(registry.words.size()));
+    if (inserted)
+    {
+        registry.words.push_back(key);
+    }
+    return it->second;
+}
+
+const std::string &SqlLexer::word_text(word_id id)
+{
+    auto &registry = get_word_registry();
+    std::shared_lock lock(registry.mutex);
+    return registry.words.at(id);
+}
+
+std::vector<SqlLexer::word_id> SqlLexer::intern_words(std::string_view sql)
+{
+    std::vector<word_id> ids;
+    for (const auto &word : split_words(sql))
+    {
+        ids.push_back(intern_word(word));
+    }
+    return ids;
+}
+
+std::set<std::string> SqlLexer::word_set(std::string_view sql)
+{
+    std::set<std::string> words;
+    for (const auto &t : tokenize(sql))
+    {
+        switch (t.type)
+        {
+        case token_class::KEYWORD:
+        case token_class::IDENTIFIER:
+        case token_class::NUMBER:
+            words.emplace(text(sql, t));
+            break;
+        case token_class::QUOTED_IDENTIFIER:
+        case token_class::STRING_LITERAL:
+            words.emplace(unquote(text(sql, t)));
+            break;
+        default:
+            break;
+        }
+    }
+    return words;
+}
+
+std::string SqlLexer::replace_word(std::string_view sql, std::string_view word, std::string_view replacement)
+{
+    std::string result;
+    result.reserve(sql.size());
+    std::size_t copied = 0;
+    for (const auto &t : tokenize(sql))
+    {
+        if (is_word(t) && equals_ignore_case(text(sql, t), word))
+        {
+            result.append(sql.substr(copied, t.begin - copied));
+            result.append(replacement);
+            copied = t.begin + t.length;
+        }
+    }
+    result.append(sql.substr(copied));
+    return result;
+}
+
+std::string SqlLexer::remove_phrases(std::string_view sql, const std::vector<std::vector<std::string_view>> &phrases)
+{
+    std::vector<token> tokens = tokenize(sql);
+    std::string result;
+    result.reserve(sql.size());
+    std::size_t copied = 0;
+    std::size_t i = 0;
+    while (i < tokens.size())
+    {
+        std::size_t matched = 0;
+        for (const auto &phrase : phrases)
+        {
+            if (phrase.empty() || i + phrase.size() > tokens.size())
+            {
+                continue;
+            }
+            std::size_t k = 0;
+            while (k < phrase.size() && is_word(tokens[i + k]) && equals_ignore_case(text(sql, tokens[i + k]), phrase[k]))
+            {
+                ++k;
+            }
+            if (k == phrase.size())
+            {
+                matched = k;
+                break;
+            }
+        }
+        if (matched == 0)
+        {
+            ++i;
+            continue;
+        }
+        const token &last = tokens[i + matched - 1];
+        result.append(sql.substr(copied, tokens[i].begin - copied));
+        copied = last.begin + last.length;
+        i += matched;
+    }
+    result.append(sql.substr(copied));
+    return result;
+}
+
+bool SqlLexer::equals_ignore_case(std::string_view lhs, std::string_view rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < lhs.size(); i++)
+    {
+        if (std::tolower(static_cast<unsigned char>(lhs[i])) != std::tolower(static_cast<unsigned char>(rhs[i])))
+        {
+            return false;
+        }
+    }
+    return true;
+}
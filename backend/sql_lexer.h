@@ -0,0 +1,126 @@
+/**
+ * @file sql_lexer.h
+ * @brief This file contains the declaration of the SqlLexer class.
+ * The class splits an SQL string into token spans (keywords, identifiers, quoted identifiers, string literals,
+ * numbers, operators and punctuation) in a single pass. String literals, quoted identifiers and comments are skipped
+ * as a whole, so words inside them are never mistaken for keywords. The helpers built on top of the tokens are used
+ * to replace words, split queries into words and strip transaction control words without compiling regular expressions.
+ * Words can also be interned to integer ids so that word sequences are compared as integers.
+ *
+ * @author Benard Wanjiru
+ * Contact: benard.wanjiru@ru.nl
+ */
+#ifndef SQL_LEXER_H
+#define SQL_LEXER_H
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class SqlLexer
+{
+public:
+    enum class token_class
+    {
+        KEYWORD,
+        IDENTIFIER,
+        QUOTED_IDENTIFIER,
+        STRING_LITERAL,
+        NUMBER,
+        OPERATOR,
+        PUNCTUATION
+    };
+    /**
+     * A token of an SQL string. The token does not own its text, it only records where it is in the string.
+     */
+    struct token
+    {
+        token_class type;
+        std::size_t begin;  /**< The offset of the first character of the token. */
+        std::size_t length; /**< The number of characters in the token, including any quotes. */
+    };
+    /**
+     * This function splits an SQL string into tokens. Whitespace and comments are not returned.
+     * Unterminated literals and quoted identifiers run to the end of the string.
+     * @param sql: the SQL string.
+     * @return: the tokens in the order they appear in the string.
+     */
+    static std::vector<token> tokenize(std::string_view sql);
+    /**
+     * This function returns the text of a token.
+     * @param sql: the SQL string the token was taken from.
+     * @param t: the token.
+     * @return: the text of the token.
+     */
+    static std::string_view text(std::string_view sql, const token &t);
+    /**
+     * This function checks whether a token is an unquoted word, i.e. a keyword or an identifier.
+     * @param t: the token.
+     * @return: true if the token is a keyword or an identifier, false otherwise.
+     */
+    static bool is_word(const token &t);
+    /**
+     * This function splits an SQL string into words. Words are separated by whitespace, commas and semicolons,
+     * but never inside a string literal or a quoted identifier.
+     * @param sql: the SQL string.
+     * @return: the words in the order they appear in the string.
+     */
+    static std::vector<std::string> split_words(std::string_view sql);
+    /**
+     * The id of an interned word. Equal words have equal ids.
+     */
+    using word_id = std::uint32_t;
+    /**
+     * This function returns the id of a word, adding the word to the process-wide table if it is new.
+     * @param word: the word.
+     * @return: the id of the word.
+     */
+    static word_id intern_word(std::string_view word);
+    /**
+     * This function returns the word of an id returned by intern_word.
+     * @param id: the id of the word.
+     * @return: the word. The reference stays valid for the lifetime of the program.
+     */
+    static const std::string &word_text(word_id id);
+    /**
+     * This function splits an SQL string into words, as split_words does, and interns them.
+     * @param sql: the SQL string.
+     * @return: the ids of the words in the order they appear in the string.
+     */
+    static std::vector<word_id> intern_words(std::string_view sql);
+    /**
+     * This function collects the words of an SQL string without their quotes.
+     * Keywords, identifiers and numbers are taken as they are, quoted identifiers and string literals without the quotes.
+     * @param sql: the SQL string.
+     * @return: the set of words.
+     */
+    static std::set<std::string> word_set(std::string_view sql);
+    /**
+     * This function replaces every keyword or identifier equal to a word, ignoring case.
+     * Words inside literals, quoted identifiers and comments and words that only contain the word are left as they are.
+     * @param sql: the SQL string.
+     * @param word: the word to replace.
+     * @param replacement: the text to put in place of the word.
+     * @return: the SQL string with the word replaced.
+     */
+    static std::string replace_word(std::string_view sql, std::string_view word, std::string_view replacement);
+    /**
+     * This function removes every occurrence of the given phrases, ignoring case. A phrase is a sequence of keywords
+     * or identifiers, e.g. {"set", "transaction"}. The whitespace around a removed phrase is kept.
+     * @param sql: the SQL string.
+     * @param phrases: the phrases to remove.
+     * @return: the SQL string without the phrases.
+     */
+    static std::string remove_phrases(std::string_view sql, const std::vector<std::vector<std::string_view>> &phrases);
+    /**
+     * This function compares two strings, ignoring the case of ASCII letters.
+     * @param lhs: the first string.
+     * @param rhs: the second string.
+     * @return: true if the strings are equal, false otherwise.
+     */
+    static bool equals_ignore_case(std::string_view lhs, std::string_view rhs);
+};
+
+#endif // SQL_LEXER_H
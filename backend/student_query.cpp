@@ -2,6 +2,7 @@
 #include "utils.h"
 #include "my_duckdb.h"
 #include <iostream>
+#include <map>
 #include "tree_edit_distance.h"
 #include "goals.h"
 #include "clauses/common.h"
@@ -12,6 +13,7 @@ StudentQuery::StudentQuery(const string &id, const string &value)
     set_value(value);
     value_changed = false;
     text_edit_distance = 0;
+    repair_candidates = 0;
     tree_edit_distance = 0;
     feedback = "";
     set_parseable(false);
@@ -25,6 +27,7 @@ StudentQuery::StudentQuery(const string &id, const string &value, const string q
     this->attempt_number = attempt_number;
     value_changed = false;
     text_edit_distance = 0;
+    repair_candidates = 0;
     tree_edit_distance = 0;
     feedback = "";
     // Set the default value for parseable to false so that an query with a syntax error will get a 0 for syntax outcome.
@@ -155,7 +158,7 @@ void StudentQuery::result_analysis(const Admin &admin, const vector<vector<strin
     print_output();
 }
 
-void StudentQuery::syntax_analysis(const Admin &admin, vector<ModelQuery> &model_queries, vector<StudentQuery> &student_queries, Query_Engine &qe)
+void StudentQuery::syntax_analysis(const Admin &admin, vector<ModelQuery> &model_queries, vector<StudentQuery> &student_queries, Query_Engine &qe, const RepairIndex *repair_index)
 {
     Utils my_utils;
 
@@ -187,15 +190,9 @@ void StudentQuery::syntax_analysis(const Admin &admin, vector<ModelQuery> &model
         for (size_t i = 0; i < model_queries.size(); i++)
         {
             ModelQuery *query = &model_queries.at(i);
-            std::string model_query = query->get_value();
-            std::string student_query = get_value();
 
-            // Preprocess the queries to lower case to ensure the distance calculation is accurate
-            my_utils.preprocess_query(model_query);
-            my_utils.preprocess_query(student_query);
-
-            // Calculate edit distance or perform the correction
-            std::tuple<bool, std::string, int> corrected = my_utils.fix_query_syntax_using_another_query(admin, student_query, model_query, get_value());
+            // Calculate edit distance or perform the correction on the preprocessed (lower case) words of both queries
+            std::tuple<bool, std::string, int> corrected = my_utils.fix_query_syntax_using_another_query(admin, get_words(), query->get_preprocessed_value(), query->get_words());
             if (std::get<0>(corrected))
             {
                 size_t current_distance = std::get<2>(corrected);
@@ -218,6 +215,9 @@ void StudentQuery::syntax_analysis(const Admin &admin, vector<ModelQuery> &model
             set_parseable(true);
             create_abstract_syntax_tree();
             create_fingerprint();
+            create_clause_profile(false);
+            create_pq_gram_profile();
+            create_words();
             create_output(qe);
             if (admin.get_syntax_sensitivity() == Grader::property_level::THREE_LEVELS)
             {
@@ -247,7 +247,21 @@ void StudentQuery::syntax_analysis(const Admin &admin, vector<ModelQuery> &model
         min_distance = 1000;
 
         // third try to fix the query using the student queries
-        for (size_t i = 0; i < student_queries.size(); i++)
+        // with an index only the nearest parseable queries are tried, their word level edit distance is likely the smallest
+        std::vector<size_t> candidates;
+        if (repair_index != nullptr)
+        {
+            candidates = repair_index->nearest(get_words(), RepairIndex::default_top_k);
+        }
+        else
+        {
+            for (size_t i = 0; i < student_queries.size(); i++)
+            {
+                candidates.push_back(i);
+            }
+        }
+        repair_candidates = static_cast<int>(candidates.size());
+        for (size_t i : candidates)
         {
             StudentQuery *query = &student_queries.at(i);
             // dont compare with itself
@@ -257,13 +271,7 @@ void StudentQuery::syntax_analysis(const Admin &admin, vector<ModelQuery> &model
             }
             if (query->is_parseable())
             {
-                string other_query = query->get_value();
-                string this_query = get_value();
-
-                my_utils.preprocess_query(other_query);
-                my_utils.preprocess_query(this_query);
-
-                std::tuple<bool, string, int> corrected = my_utils.fix_query_syntax_using_another_query(admin, this_query, other_query, get_value());
+                std::tuple<bool, string, int> corrected = my_utils.fix_query_syntax_using_another_query(admin, get_words(), query->get_preprocessed_value(), query->get_words());
 
                 if (std::get<0>(corrected))
                 {
@@ -285,7 +293,8 @@ void StudentQuery::syntax_analysis(const Admin &admin, vector<ModelQuery> &model
     }
 }
 
-void StudentQuery::semantics_analysis(const Admin &admin, vector<ModelQuery> &model_queries, vector<StudentQuery> &student_queries)
+void StudentQuery::semantics_analysis(const Admin &admin, const vector<ModelQuery> &model_queries, const vector<StudentQuery> &student_queries, const TreeMetricIndex *correct_index,
+                                      const std::vector<DistanceMatrix::entry> *neighbours)
 {
     TreeEditDistance ted;
     Utils my_utils;
@@ -315,6 +324,14 @@ void StudentQuery::semantics_analysis(const Admin &admin, vector<ModelQuery> &mo
         set_semantics_analysis_message("The query is not parseable. Therefore, the semantics could not be verified.\n");
         return;
     }
+    // with the pq-gram prefilter, queries whose trees are obviously too different are skipped before the exact tree edit distance.
+    // queries with the same preprocessed text are always compared, they are the ones that only differ in case
+    const bool use_pq_gram = admin.get_semantics_prefilter() == Admin::semantics_prefilter::PQ_GRAM;
+    auto is_too_distant = [&](const ModelQuery &query)
+    {
+        return use_pq_gram && query.get_preprocessed_value() != get_preprocessed_value() &&
+               PqGram::distance(*get_pq_gram_profile(), *query.get_pq_gram_profile()) > admin.get_max_pq_gram_distance();
+    };
     // first compare with the model queries for minor‐fix suggestions
     int min_tree_edit_dist = 100;
     string closest_correct_query = "";
@@ -322,7 +339,7 @@ void StudentQuery::semantics_analysis(const Admin &admin, vector<ModelQuery> &mo
     bool put_feedback = false;
     for (size_t i = 0; i < model_queries.size(); i++)
     {
-        ModelQuery *query = &model_queries.at(i);
+        const ModelQuery *query = &model_queries.at(i);
         // do the queries have the same fingerprint
         /*if (get_fingerprint() == query->get_fingerprint())
         {
@@ -336,8 +353,12 @@ void StudentQuery::semantics_analysis(const Admin &admin, vector<ModelQuery> &mo
             }
             return;
         }*/
+        if (is_too_distant(*query))
+        {
+            continue;
+        }
         // calculate tree edit distance
-        int current_tree_distance = ted.zhang_shasha(get_parse_tree(), query->get_parse_tree());
+        int current_tree_distance = ted.distance(get_parse_tree(), query->get_parse_tree(), admin.get_tree_edit_distance_algorithm());
 
         if (current_tree_distance < min_tree_edit_dist)
         {
@@ -347,7 +368,8 @@ void StudentQuery::semantics_analysis(const Admin &admin, vector<ModelQuery> &mo
             string model_query = query->get_value();
             my_utils.preprocess_query(current_query);
             my_utils.preprocess_query(model_query);
-            int edit_distance = my_utils.general_edit_distance(current_query, model_query);
+            // only distances up to the syntax threshold decide anything below
+            int edit_distance = my_utils.bounded_edit_distance(current_query, model_query, std::max(0, admin.get_syntax_minor_incorrect_ted()));
 
             // first check if the difference is only in the cases.
             if (edit_distance == 0 && !query->get_output().empty())
@@ -375,9 +397,52 @@ void StudentQuery::semantics_analysis(const Admin &admin, vector<ModelQuery> &mo
         }
     }
 
-    for (size_t i = 0; i < student_queries.size(); i++)
+    // the correct student queries to compare with, by position, with their tree and text edit distances if they are already known
+    std::map<size_t, std::pair<int, int>> student_candidates;
+    if (use_pq_gram)
+    {
+        for (size_t i = 0; i < student_queries.size(); i++)
+        {
+            if (student_queries.at(i).is_correct() && !is_too_distant(student_queries.at(i)))
+            {
+                student_candidates.emplace(i, std::make_pair(-1, -1));
+            }
+        }
+    }
+    else if (neighbours != nullptr)
+    {
+        // the cohort matrix already holds the queries within the minor error distance and those with the same text
+        for (const auto &neighbour : *neighbours)
+        {
+            student_candidates.emplace(neighbour.position, std::make_pair(neighbour.tree_distance, neighbour.text_distance));
+        }
+    }
+    else if (correct_index != nullptr)
+    {
+        // only a query within the minor error distance can be picked below, unless its text only differs in case
+        for (const auto &match : correct_index->within(get_parse_tree(), admin.get_semantics_minor_incorrect_ted()))
+        {
+            student_candidates.emplace(match.position, std::make_pair(match.distance, -1));
+        }
+        for (size_t i = 0; i < student_queries.size(); i++)
+        {
+            if (student_queries.at(i).get_preprocessed_value() == get_preprocessed_value())
+            {
+                student_candidates.emplace(i, std::make_pair(-1, -1));
+            }
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < student_queries.size(); i++)
+        {
+            student_candidates.emplace(i, std::make_pair(-1, -1));
+        }
+    }
+
+    for (const auto &[i, known_distances] : student_candidates)
     {
-        StudentQuery *query = &student_queries.at(i);
+        const StudentQuery *query = &student_queries.at(i);
         // dont compare with itself
         if (query->get_id() == get_id())
         {
@@ -390,17 +455,22 @@ void StudentQuery::semantics_analysis(const Admin &admin, vector<ModelQuery> &mo
         // do the queries have the same fingerprint
 
         // calculate tree edit distance
-        int current_tree_distance = ted.zhang_shasha(get_parse_tree(), query->get_parse_tree());
+        int current_tree_distance = known_distances.first >= 0 ? known_distances.first : ted.distance(get_parse_tree(), query->get_parse_tree(), admin.get_tree_edit_distance_algorithm());
 
         if (current_tree_distance < min_tree_edit_dist)
         {
-            // compare using lower case queries
-            string current_query = get_value();
-            string model_query = query->get_value();
-            my_utils.preprocess_query(current_query);
-            my_utils.preprocess_query(model_query);
-
-            int edit_distance = my_utils.general_edit_distance(current_query, model_query);
+            int edit_distance = known_distances.second;
+            if (edit_distance < 0)
+            {
+                // compare using lower case queries
+                string current_query = get_value();
+                string model_query = query->get_value();
+                my_utils.preprocess_query(current_query);
+                my_utils.preprocess_query(model_query);
+
+                // only distances up to the syntax threshold decide anything below
+                edit_distance = my_utils.bounded_edit_distance(current_query, model_query, std::max(0, admin.get_syntax_minor_incorrect_ted()));
+            }
 
             // first check if the difference is only in the cases.
             if (edit_distance == 0 && !query->get_output().empty())
@@ -466,14 +536,17 @@ void StudentQuery::semantics_analysis(const Admin &admin, vector<ModelQuery> &mo
     // get a goal from the first model query
     std::string main_goal;
 
+    // the profile of this query is compiled once and diffed against every candidate
+    auto student_profile = get_clause_profile();
+
     // compare only against same‐type model queries
     {
-        std::string student_stmt = AbstractSyntaxTree::get_statement_type(get_parse_tree());
-        std::vector<ModelQuery *> model_candidates;
+        AbstractSyntaxTree::statement_kind student_stmt = get_statement_kind();
+        std::vector<const ModelQuery *> model_candidates;
 
         for (auto &mq : model_queries)
         {
-            if (AbstractSyntaxTree::get_statement_type(mq.get_parse_tree()) == student_stmt)
+            if (mq.get_statement_kind() == student_stmt)
                 model_candidates.push_back(&mq);
         }
         // if none match type, compare all
@@ -490,7 +563,10 @@ void StudentQuery::semantics_analysis(const Admin &admin, vector<ModelQuery> &mo
 
         for (auto *mqp : model_candidates)
         {
-            auto comp = Goals::compare_queries(mqp->get_parse_tree(), get_parse_tree());
+            auto model_profile = mqp->get_clause_profile();
+            if (!model_profile || !student_profile)
+                continue;
+            auto comp = Goals::compare_queries(*model_profile, *student_profile);
             if (comp.correct_parts.size() > comparison.correct_parts.size() ||
                 (comp.correct_parts.size() == comparison.correct_parts.size() && comp.incorrect_parts.size() > comparison.incorrect_parts.size()))
             {
@@ -501,13 +577,13 @@ void StudentQuery::semantics_analysis(const Admin &admin, vector<ModelQuery> &mo
 
     // compare only against same‐type, correct student queries
     {
-        std::string student_stmt = AbstractSyntaxTree::get_statement_type(get_parse_tree());
-        std::vector<StudentQuery *> stu_candidates;
+        AbstractSyntaxTree::statement_kind student_stmt = get_statement_kind();
+        std::vector<const StudentQuery *> stu_candidates;
         for (auto &sq : student_queries)
         {
             if (sq.get_id() == get_id() || !sq.is_correct())
                 continue;
-            if (AbstractSyntaxTree::get_statement_type(sq.get_parse_tree()) == student_stmt)
+            if (sq.get_statement_kind() == student_stmt)
                 stu_candidates.push_back(&sq);
         }
         if (stu_candidates.empty())
@@ -521,7 +597,10 @@ void StudentQuery::semantics_analysis(const Admin &admin, vector<ModelQuery> &mo
         }
         for (auto *other : stu_candidates)
         {
-            auto comp = Goals::compare_queries(other->get_parse_tree(), get_parse_tree());
+            auto other_profile = other->get_clause_profile();
+            if (!other_profile || !student_profile)
+                continue;
+            auto comp = Goals::compare_queries(*other_profile, *student_profile);
             if (comp.correct_parts.size() > comparison.correct_parts.size() || (comp.correct_parts.size() == comparison.correct_parts.size() && comp.incorrect_parts.size() > comparison.incorrect_parts.size()))
             {
                 comparison = comp;
@@ -617,8 +696,7 @@ void StudentQuery::create_output(Query_Engine &qe)
     try
     {
         //  Determine the type of statement from the parse tree.
-        std::string stmt_type = AbstractSyntaxTree::get_statement_type(get_parse_tree());
-        if (stmt_type == "SelectStmt")
+        if (get_statement_kind() == AbstractSyntaxTree::statement_kind::SELECT_STMT)
         {
             // For SELECT queries, generate outputs as usual.
             auto out = qe.execute_select(get_value());
@@ -674,6 +752,11 @@ int StudentQuery::get_text_edit_distance() const
     return text_edit_distance;
 }
 
+int StudentQuery::get_repair_candidates() const
+{
+    return repair_candidates;
+}
+
 int StudentQuery::get_tree_edit_distance() const
 {
     return tree_edit_distance;
@@ -724,6 +807,28 @@ void StudentQuery::post_process(const Admin &admin)
     }
 }
 
+void StudentQuery::copy_grading(const StudentQuery &representative)
+{
+    string id = get_id();
+    string value = get_value();
+    string question_number = this->question_number;
+    int attempt_number = this->attempt_number;
+
+    *this = representative;
+    set_id(id);
+    this->question_number = question_number;
+    this->attempt_number = attempt_number;
+    // a repaired query keeps the repaired text, the original text is the one this student wrote
+    if (is_value_changed())
+    {
+        old_value = value;
+    }
+    else
+    {
+        set_value(value);
+    }
+}
+
 void StudentQuery::set_syntax_analysis_message(const string &syntax_analysis_message)
 {
     this->syntax_analysis_message = syntax_analysis_message;
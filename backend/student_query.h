@@ -16,6 +16,9 @@
 #include "admin.h"
 #include <atomic>
 #include "query_engine.h"
+#include "repair_index.h"
+#include "tree_metric_index.h"
+#include "distance_matrix.h"
 
 class StudentQuery : public ModelQuery
 {
@@ -120,15 +123,23 @@ public:
      * @param admin: the admin object that contains the grading parameters.
      * @param model_queries: the model queries to be used for syntax analysis.
      * @param student_queries: the student queries to be used for syntax analysis. We will use those correct queries.
+     * @param repair_index: an index of the parseable student queries by position. If given, only the nearest of them are
+     * tried to repair the query, otherwise all of them are.
      */
-    void syntax_analysis(const Admin &admin, vector<ModelQuery> &model_queries, vector<StudentQuery> &student_queries, Query_Engine &qe);
+    void syntax_analysis(const Admin &admin, vector<ModelQuery> &model_queries, vector<StudentQuery> &student_queries, Query_Engine &qe, const RepairIndex *repair_index = nullptr);
     /**
      * This function sets the outcome of semantics analysis.
      * @param admin: the admin object that contains the grading parameters.
      * @param model_queries: the model queries to be used for semantics analysis.
      * @param student_queries: the student queries to be used for semantics analysis. We will use those correct queries.
+     * @param correct_index: an index of the trees of the correct student queries by position. If given, only the correct
+     * queries within the minor error tree edit distance are compared, otherwise all of them are. It is not used when the
+     * admin asks for the pq-gram prefilter, see Admin::semantics_prefilter.
+     * @param neighbours: the row of the query in the cohort distance matrix. If given, it is used instead of the index and
+     * only the correct queries in it are compared, with the distances it holds.
      */
-    void semantics_analysis(const Admin &admin, vector<ModelQuery> &model_queries, vector<StudentQuery> &student_queries);
+    void semantics_analysis(const Admin &admin, const vector<ModelQuery> &model_queries, const vector<StudentQuery> &student_queries, const TreeMetricIndex *correct_index = nullptr,
+                            const std::vector<DistanceMatrix::entry> *neighbours = nullptr);
     /**
      * This function gets the old value of a query before it was changed to the correct one.
      * This happens when the query is not parseable due to minor syntax mistakes. We edit the query and store the original value.
@@ -171,6 +182,12 @@ public:
      * @return: the closest text edit distance found in syntax analysis.
      */
     int get_text_edit_distance() const;
+    /**
+     * This function gets the number of student queries that syntax analysis tried to repair the query with.
+     * It is 0 if the query did not need the student queries to be repaired.
+     * @return: the number of candidate queries.
+     */
+    int get_repair_candidates() const;
     /**
      * This function gets the closest tree edit distance found in semantics analysis.
      * The edit distance is only set if the query was found to be minor incorrect in semantics.
@@ -207,6 +224,12 @@ public:
      */
     int get_attempt_number() const;
     void post_process(const Admin &admin);
+    /**
+     * This function copies the grading of another query with the same text, see ProcessQueries.
+     * Everything is copied except the id, the question number, the attempt number and the original text of this query.
+     * @param representative: the graded query.
+     */
+    void copy_grading(const StudentQuery &representative);
     /**
      * This function sets the message to be forwarded to the student after syntax analysis.
      * @param syntax_analysis_message: the message to be forwarded to the student after syntax analysis.
@@ -252,6 +275,7 @@ private:
     string old_value;                         /**< The original value of the query before it was edited. */
     string closest_parse_tree;                /**< The query with the closest parse tree to the query. */
     int text_edit_distance;                   /**< The closest text edit distance found in syntax analysis. */
+    int repair_candidates;                    /**< The number of student queries tried to repair the query. */
     int tree_edit_distance;                   /**< The closest tree edit distance found in semantics analysis. */
     double grade;                             /**< The final grade of the query. */
     string question_number;                   /**< The number of the question that the query belongs to. */
@@ -17,6 +17,30 @@
 #include "my_evosql.h"
 #include <regex>
 #include "goals.h"
+#include "keyword_index.h"
+#include "sql_lexer.h"
+#include "repair_index.h"
+#include "tree_metric_index.h"
+#include "pq_gram.h"
+#include "distance_matrix.h"
+#include "grading_jobs.h"
+#include "grading_scheduler.h"
+#include "quiz_store.h"
+#include "dataset_store.h"
+#include "practice_grader.h"
+#include "database_cache.h"
+#include "script_loader.h"
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include "sql_keywords.h"
+#include <set>
+#include <map>
+#include <random>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
 #include "clauses/select/group_by_clause.h"
 #include "clauses/select/having_clause.h"
 #include "clauses/select/order_by_clause.h"
@@ -149,6 +173,111 @@ std::shared_ptr<AbstractSyntaxTree::Node> build_sql_tree(const std::string &sql_
 	pg_query_free_parse_result(result);
 	return root;
 }
+// Row by row edit distance, used as the reference for the faster kernels in Utils
+template <typename StringT>
+std::size_t reference_edit_distance(const StringT &source, const StringT &target, std::size_t insert_cost = 1, std::size_t delete_cost = 1, std::size_t replace_cost = 1)
+{
+	if (source.size() > target.size())
+		return reference_edit_distance(target, source, insert_cost, delete_cost, replace_cost);
+	std::vector<std::size_t> lev_dist(source.size() + 1);
+	for (std::size_t i = 1; i <= source.size(); ++i)
+		lev_dist[i] = lev_dist[i - 1] + delete_cost;
+	for (std::size_t j = 1; j <= target.size(); ++j)
+	{
+		std::size_t previous_diagonal = lev_dist[0], previous_diagonal_save;
+		lev_dist[0] += insert_cost;
+		for (std::size_t i = 1; i <= source.size(); ++i)
+		{
+			previous_diagonal_save = lev_dist[i];
+			if (source[i - 1] == target[j - 1])
+				lev_dist[i] = previous_diagonal;
+			else
+				lev_dist[i] = std::min(std::min(lev_dist[i - 1] + delete_cost, lev_dist[i] + insert_cost), previous_diagonal + replace_cost);
+			previous_diagonal = previous_diagonal_save;
+		}
+	}
+	return lev_dist[source.size()];
+}
+// Utility function to make a random string over the first alphabet_size lower case letters
+std::string random_string(std::mt19937 &generator, std::size_t length, int alphabet_size)
+{
+	std::string result;
+	for (std::size_t i = 0; i < length; i++)
+		result += static_cast<char>('a' + generator() % alphabet_size);
+	return result;
+}
+// Utility function to make a random tree of the given size, each node is attached to a random earlier node
+std::shared_ptr<AbstractSyntaxTree::Node> random_tree(std::mt19937 &generator, std::size_t size, int label_count)
+{
+	std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> nodes = {std::make_shared<AbstractSyntaxTree::Node>("root", "")};
+	for (std::size_t i = 1; i < size; i++)
+	{
+		auto node = std::make_shared<AbstractSyntaxTree::Node>("node_" + std::to_string(generator() % label_count), "");
+		nodes[generator() % nodes.size()]->add_child(node);
+		nodes.push_back(node);
+	}
+	return nodes.front();
+}
+// Utility function to make a tree that is deep on one side, every level has a leaf and a subtree next to each other
+std::shared_ptr<AbstractSyntaxTree::Node> skewed_tree(std::mt19937 &generator, std::size_t depth, int label_count, bool deep_on_the_right)
+{
+	auto root = std::make_shared<AbstractSyntaxTree::Node>("root", "");
+	auto current = root;
+	for (std::size_t i = 0; i < depth; i++)
+	{
+		auto leaf = std::make_shared<AbstractSyntaxTree::Node>("leaf_" + std::to_string(generator() % label_count), "");
+		auto subtree = std::make_shared<AbstractSyntaxTree::Node>("node_" + std::to_string(generator() % label_count), "");
+		current->add_child(deep_on_the_right ? leaf : subtree);
+		current->add_child(deep_on_the_right ? subtree : leaf);
+		current = subtree;
+	}
+	return root;
+}
+// Utility function to compute the exact edit distance between two forests, by removing the rightmost roots one at a time
+int exact_forest_distance(const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> &forest1, const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> &forest2,
+						  std::map<std::pair<std::vector<const void *>, std::vector<const void *>>, int> &memo)
+{
+	auto size = [](const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> &forest)
+	{
+		int nodes = 0;
+		for (const auto &tree : forest)
+			nodes += static_cast<int>(TreeEditDistance().post_order_traversal(tree).size());
+		return nodes;
+	};
+	if (forest1.empty() || forest2.empty())
+		return size(forest1) + size(forest2);
+	auto ids = [](const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> &forest)
+	{
+		std::vector<const void *> result;
+		for (const auto &tree : forest)
+			result.push_back(tree.get());
+		return result;
+	};
+	auto key = std::make_pair(ids(forest1), ids(forest2));
+	auto it = memo.find(key);
+	if (it != memo.end())
+		return it->second;
+	auto root1 = forest1.back(), root2 = forest2.back();
+	std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> rest1(forest1.begin(), forest1.end() - 1), rest2(forest2.begin(), forest2.end() - 1);
+	auto without_root1 = rest1, without_root2 = rest2;
+	without_root1.insert(without_root1.end(), root1->children.begin(), root1->children.end());
+	without_root2.insert(without_root2.end(), root2->children.begin(), root2->children.end());
+	int change = root1->key == root2->key && root1->value == root2->value ? 0 : 1;
+	int distance = std::min({exact_forest_distance(without_root1, forest2, memo) + 1,
+							 exact_forest_distance(forest1, without_root2, memo) + 1,
+							 exact_forest_distance(root1->children, root2->children, memo) + exact_forest_distance(rest1, rest2, memo) + change});
+	memo[key] = distance;
+	return distance;
+}
+// Utility function to time a function, returns the average microseconds per call
+template <typename Function>
+double time_per_call(int repetitions, Function function)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < repetitions; i++)
+		function();
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repetitions;
+}
 //--------------------------------------------------------------------------------------------------------------
 // Test suite for checking the correctness of the function to replace double quotes with single quotes.
 // -------------------------------------------------------------------------------------------------------------
@@ -572,6 +701,177 @@ BOOST_AUTO_TEST_CASE(test_case_4)
 
 	BOOST_TEST(result == expected);
 }
+/**
+ * The bit-parallel kernel is checked against the row by row dynamic program, including strings longer than one
+ * 64 bit block and multibyte strings.
+ */
+BOOST_AUTO_TEST_CASE(test_case_5)
+{
+	Utils my_utils;
+	std::mt19937 generator(5);
+
+	for (int i = 0; i < 500; i++)
+	{
+		std::string source = random_string(generator, generator() % 200, 1 + i % 5);
+		std::string target = random_string(generator, generator() % 200, 1 + i % 5);
+		BOOST_TEST(my_utils.general_edit_distance(source, target) == reference_edit_distance(source, target));
+
+		std::wstring wide_source = L"´" + std::wstring(source.begin(), source.end());
+		std::wstring wide_target(target.begin(), target.end());
+		BOOST_TEST(my_utils.general_edit_distance(wide_source, wide_target) == reference_edit_distance(wide_source, wide_target));
+	}
+}
+/**
+ * The anti-diagonal kernel for other costs is checked against the row by row dynamic program.
+ */
+BOOST_AUTO_TEST_CASE(test_case_6)
+{
+	Utils my_utils;
+	std::mt19937 generator(6);
+
+	for (int i = 0; i < 500; i++)
+	{
+		std::string source = random_string(generator, generator() % 150, 1 + i % 5);
+		std::string target = random_string(generator, generator() % 150, 1 + i % 5);
+		std::size_t insert_cost = 1 + generator() % 3, delete_cost = 1 + generator() % 3, replace_cost = 2 + generator() % 3;
+		BOOST_TEST(my_utils.general_edit_distance(source, target, insert_cost, delete_cost, replace_cost) ==
+				   reference_edit_distance(source, target, insert_cost, delete_cost, replace_cost));
+	}
+}
+/**
+ * The bounded distance is exact up to the maximum and maximum + 1 beyond it.
+ */
+BOOST_AUTO_TEST_CASE(test_case_7)
+{
+	Utils my_utils;
+	std::mt19937 generator(7);
+
+	BOOST_TEST(my_utils.bounded_edit_distance(std::string("kitten"), std::string("sitting"), 3) == 3);
+	BOOST_TEST(my_utils.bounded_edit_distance(std::string("kitten"), std::string("sitting"), 2) == 3);
+	BOOST_TEST(my_utils.bounded_edit_distance(std::string("select"), std::string("select * from t"), 4) == 5);
+	for (int i = 0; i < 500; i++)
+	{
+		std::string source = random_string(generator, generator() % 120, 3);
+		std::string target = source;
+		for (int edits = generator() % 10; edits > 0 && !target.empty(); edits--)
+			target[generator() % target.size()] = 'z';
+		std::size_t max_distance = generator() % 12;
+		BOOST_TEST(my_utils.bounded_edit_distance(source, target, max_distance) == std::min(reference_edit_distance(source, target), max_distance + 1));
+	}
+}
+/**
+ * The word level edit distance on interned words takes the same edits as the string version,
+ * without the equal words.
+ */
+BOOST_AUTO_TEST_CASE(test_case_8)
+{
+	Utils my_utils;
+	std::mt19937 generator(8);
+	const std::vector<std::string> vocabulary = {"select", "name", "from", "artist", "where", "id", "=", "1", "'x y'", "order", "by"};
+
+	for (int i = 0; i < 200; i++)
+	{
+		std::vector<std::string> source, target;
+		for (int w = generator() % 15; w > 0; w--)
+			source.push_back(vocabulary[generator() % vocabulary.size()]);
+		for (int w = generator() % 15; w > 0; w--)
+			target.push_back(vocabulary[generator() % vocabulary.size()]);
+		std::vector<SqlLexer::word_id> source_ids, target_ids;
+		for (const auto &word : source)
+			source_ids.push_back(SqlLexer::intern_word(word));
+		for (const auto &word : target)
+			target_ids.push_back(SqlLexer::intern_word(word));
+
+		auto [distance, path] = my_utils.general_edit_distance_words(source, target);
+		auto [id_distance, script] = my_utils.general_edit_distance_words(source_ids, target_ids);
+		BOOST_TEST(distance == id_distance);
+
+		std::vector<std::tuple<std::string, std::string, std::string>> edits;
+		for (const auto &edit : script)
+		{
+			if (edit.operation == Utils::word_operation::DELETE)
+				edits.emplace_back("delete", source[edit.source_index], "");
+			else if (edit.operation == Utils::word_operation::INSERT)
+				edits.emplace_back("insert", "", target[edit.target_index]);
+			else
+				edits.emplace_back("replace", source[edit.source_index], target[edit.target_index]);
+		}
+		path.erase(std::remove_if(path.begin(), path.end(), [](const auto &edit)
+								  { return std::get<0>(edit) == "equal"; }),
+				   path.end());
+		BOOST_TEST((edits == path));
+	}
+	BOOST_TEST(SqlLexer::word_text(SqlLexer::intern_word("artist")) == "artist");
+	BOOST_TEST((SqlLexer::intern_words("select a, 'x y' from t;") == std::vector<SqlLexer::word_id>{SqlLexer::intern_word("select"), SqlLexer::intern_word("a"), SqlLexer::intern_word("'x y'"), SqlLexer::intern_word("from"), SqlLexer::intern_word("t")}));
+}
+BOOST_AUTO_TEST_SUITE_END()
+//--------------------------------------------------------------------------------------------------------------
+// Benchmarks of the edit distance kernels against the row by row dynamic program.
+// They are disabled by default, run them with --run_test=edit_distance_benchmarks
+// -------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE(edit_distance_benchmarks, *boost::unit_test::disabled())
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	Utils my_utils;
+	std::mt19937 generator(1);
+
+	for (std::size_t length : {16, 64, 256, 1024})
+	{
+		std::string source = random_string(generator, length, 26);
+		std::string target = random_string(generator, length, 26);
+		BOOST_TEST(my_utils.general_edit_distance(source, target) == reference_edit_distance(source, target));
+
+		double reference = time_per_call(200, [&]
+										 { reference_edit_distance(source, target); });
+		double bit_parallel = time_per_call(200, [&]
+											{ my_utils.general_edit_distance(source, target); });
+		std::cout << "unit costs, length " << length << ": row by row " << reference << " us, bit-parallel " << bit_parallel << " us" << std::endl;
+	}
+}
+BOOST_AUTO_TEST_CASE(test_case_2)
+{
+	Utils my_utils;
+	Admin admin;
+	std::mt19937 generator(2);
+	std::size_t max_distance = std::max(0, admin.get_syntax_minor_incorrect_ted());
+
+	for (std::size_t length : {64, 256, 1024})
+	{
+		// a query with a few typos and a completely different one
+		std::string source = random_string(generator, length, 26);
+		std::string close = source;
+		close[length / 2] = '#';
+		std::string far = random_string(generator, length, 26);
+		for (const std::string *target : {&close, &far})
+		{
+			BOOST_TEST(my_utils.bounded_edit_distance(source, *target, max_distance) == std::min(reference_edit_distance(source, *target), max_distance + 1));
+			double reference = time_per_call(200, [&]
+											 { reference_edit_distance(source, *target); });
+			double banded = time_per_call(200, [&]
+										  { my_utils.bounded_edit_distance(source, *target, max_distance); });
+			std::cout << "bounded by " << max_distance << ", length " << length << (target == &close ? " close" : " far")
+					  << ": row by row " << reference << " us, banded " << banded << " us" << std::endl;
+		}
+	}
+}
+BOOST_AUTO_TEST_CASE(test_case_3)
+{
+	Utils my_utils;
+	std::mt19937 generator(3);
+
+	for (std::size_t length : {16, 64, 256, 1024})
+	{
+		std::string source = random_string(generator, length, 26);
+		std::string target = random_string(generator, length, 26);
+		BOOST_TEST(my_utils.general_edit_distance(source, target, 1, 1, 2) == reference_edit_distance(source, target, 1, 1, 2));
+
+		double reference = time_per_call(200, [&]
+										 { reference_edit_distance(source, target, 1, 1, 2); });
+		double anti_diagonal = time_per_call(200, [&]
+											 { my_utils.general_edit_distance(source, target, 1, 1, 2); });
+		std::cout << "replace cost 2, length " << length << ": row by row " << reference << " us, anti-diagonal " << anti_diagonal << " us" << std::endl;
+	}
+}
 BOOST_AUTO_TEST_SUITE_END()
 /*//--------------------------------------------------------------------------------------------------------------
 // Test suite for checking the normalized edit distance algorithm for text using random words.
@@ -646,6 +946,116 @@ BOOST_AUTO_TEST_CASE(test_case_6)
 }
 BOOST_AUTO_TEST_SUITE_END()*/
 //--------------------------------------------------------------------------------------------------------------
+// Test suite for checking the keyword index used by syntax repair.
+// -------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE(keyword_index_test_suite)
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	const KeywordIndex &index = KeywordIndex::sql_2016();
+
+	BOOST_CHECK_EQUAL(index.size(), sql_keywords_2016.size());
+	BOOST_CHECK(index.contains("SELECT"));
+	BOOST_CHECK(index.contains("select"));
+	BOOST_CHECK(!index.contains("selec"));
+	BOOST_CHECK(!index.contains("students"));
+}
+/**
+ * We check that the BK-tree finds exactly the keywords a scan over all keywords finds.
+ */
+BOOST_AUTO_TEST_CASE(test_case_2)
+{
+	Utils my_utils;
+	const KeywordIndex &index = KeywordIndex::sql_2016();
+
+	for (const std::string word : {"SELEC", "FORM", "WHRE", "GROPU", "ODRER", "xyzzy", "A"})
+	{
+		std::set<std::string> expected;
+		for (const auto &keyword : sql_keywords_2016)
+		{
+			if (my_utils.general_edit_distance(word, keyword) <= 2)
+				expected.insert(keyword);
+		}
+		std::set<std::string> found;
+		for (const auto &candidate : index.find_within(word, 2))
+		{
+			BOOST_CHECK_EQUAL(candidate.distance, my_utils.general_edit_distance(word, candidate.keyword));
+			found.insert(candidate.keyword);
+		}
+		BOOST_CHECK(found == expected);
+	}
+
+	// the closest keyword comes first
+	auto candidates = index.find_within("selec", 2);
+	BOOST_REQUIRE(!candidates.empty());
+	BOOST_CHECK_EQUAL(candidates.front().keyword, "SELECT");
+	BOOST_CHECK_EQUAL(candidates.front().distance, 1);
+}
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE(sql_lexer_test_suite)
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	using token_class = SqlLexer::token_class;
+	std::string sql = "SELECT \"First name\", 'it''s' AS x -- note\nFROM t WHERE a <= 1.5e3; /* done */";
+	auto tokens = SqlLexer::tokenize(sql);
+
+	std::vector<std::string> texts;
+	std::vector<token_class> types;
+	for (const auto &token : tokens)
+	{
+		texts.emplace_back(SqlLexer::text(sql, token));
+		types.push_back(token.type);
+	}
+	std::vector<std::string> expected_texts = {"SELECT", "\"First name\"", ",", "'it''s'", "AS", "x", "FROM", "t", "WHERE", "a", "<=", "1.5e3", ";"};
+	std::vector<token_class> expected_types = {token_class::KEYWORD, token_class::QUOTED_IDENTIFIER, token_class::PUNCTUATION,
+											   token_class::STRING_LITERAL, token_class::KEYWORD, token_class::IDENTIFIER,
+											   token_class::KEYWORD, token_class::IDENTIFIER, token_class::KEYWORD,
+											   token_class::IDENTIFIER, token_class::OPERATOR, token_class::NUMBER, token_class::PUNCTUATION};
+	BOOST_CHECK(texts == expected_texts);
+	BOOST_CHECK(types == expected_types);
+}
+/**
+ * Words are only replaced or removed when they are whole words outside literals.
+ */
+BOOST_AUTO_TEST_CASE(test_case_2)
+{
+	BOOST_CHECK_EQUAL(SqlLexer::replace_word("selec name, selection FROM t WHERE c = 'selec'", "SELEC", "SELECT"),
+					  "SELECT name, selection FROM t WHERE c = 'selec'");
+	BOOST_CHECK_EQUAL(SqlLexer::remove_phrases("BEGIN; UPDATE t SET begin_date = 'commit'; COMMIT;", {{"begin"}, {"commit"}, {"rollback"}}),
+					  "; UPDATE t SET begin_date = 'commit'; ;");
+	BOOST_CHECK_EQUAL(SqlLexer::remove_phrases("SET  TRANSACTION ISOLATION LEVEL SERIALIZABLE; SET x = 1", {{"set", "transaction"}}),
+					  " ISOLATION LEVEL SERIALIZABLE; SET x = 1");
+
+	std::vector<std::string> words = SqlLexer::split_words("SELECT a,b FROM t WHERE c = 'x y';");
+	std::vector<std::string> expected = {"SELECT", "a", "b", "FROM", "t", "WHERE", "c", "=", "'x y'"};
+	BOOST_CHECK(words == expected);
+	BOOST_CHECK(SqlLexer::word_set("`name`") == SqlLexer::word_set("name"));
+	BOOST_CHECK(SqlLexer::word_set("\"name\"") == SqlLexer::word_set("\xC2\xB4name\xC2\xB4"));
+}
+BOOST_AUTO_TEST_SUITE_END()
+//--------------------------------------------------------------------------------------------------------------
+// Test suite for checking the index of candidate queries for syntax repair.
+// -------------------------------------------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE(repair_index_test_suite)
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	std::vector<std::string> queries = {"select name from artist where id = 1",
+										"select title from album order by title",
+										"select name from artist where id = 2",
+										"delete from track where id = 3"};
+	RepairIndex index;
+	for (size_t i = 0; i < queries.size(); i++)
+		index.add(i, SqlLexer::intern_words(queries[i]));
+	BOOST_TEST(index.size() == queries.size());
+
+	// the two queries on artist share the most n-grams with the broken query
+	auto nearest = index.nearest(SqlLexer::intern_words("select name form artist where id = 1"), 2);
+	BOOST_TEST((nearest == std::vector<size_t>{0, 2}));
+	// only queries that share an n-gram are returned
+	BOOST_TEST(index.nearest(SqlLexer::intern_words("xyzzy"), 5).empty());
+	BOOST_TEST((index.nearest(SqlLexer::intern_words("select name form artist"), 10) == std::vector<size_t>{0, 1, 2}));
+}
+BOOST_AUTO_TEST_SUITE_END()
+//--------------------------------------------------------------------------------------------------------------
 // Test suite for checking building of a parse tree.
 // -------------------------------------------------------------------------------------------------------------
 BOOST_AUTO_TEST_SUITE(parse_query_tree_tests)
@@ -775,6 +1185,79 @@ BOOST_AUTO_TEST_CASE(test_case_6)
 
 	BOOST_CHECK_EQUAL(statement_type, "CreateStmt");
 }
+/**
+ * We check that the statement kind is resolved once when the parse tree is created.
+ */
+BOOST_AUTO_TEST_CASE(test_case_7)
+{
+	ModelQuery model_query("1", "SELECT * FROM emp WHERE empno = 7934");
+	BOOST_CHECK(model_query.get_statement_kind() == AbstractSyntaxTree::statement_kind::UNKNOWN);
+
+	model_query.create_abstract_syntax_tree();
+
+	BOOST_CHECK(model_query.get_statement_kind() == AbstractSyntaxTree::statement_kind::SELECT_STMT);
+	BOOST_CHECK(AbstractSyntaxTree::get_statement_kind(model_query.get_parse_tree()) == AbstractSyntaxTree::statement_kind::SELECT_STMT);
+}
+/**
+ * We check that statement node names and statement kinds map to each other.
+ */
+BOOST_AUTO_TEST_CASE(test_case_8)
+{
+	BOOST_CHECK(AbstractSyntaxTree::to_statement_kind("UpdateStmt") == AbstractSyntaxTree::statement_kind::UPDATE_STMT);
+	BOOST_CHECK(AbstractSyntaxTree::to_statement_kind("AlterTableStmt") == AbstractSyntaxTree::statement_kind::ALTER_TABLE_STMT);
+	BOOST_CHECK(AbstractSyntaxTree::to_statement_kind("CreatePLangStmt") == AbstractSyntaxTree::statement_kind::CREATE_PLANG_STMT);
+	BOOST_CHECK(AbstractSyntaxTree::to_statement_kind("RawStmt") == AbstractSyntaxTree::statement_kind::UNKNOWN);
+	BOOST_CHECK_EQUAL(AbstractSyntaxTree::statement_kind_to_string(AbstractSyntaxTree::statement_kind::VIEW_STMT), "ViewStmt");
+	BOOST_CHECK_EQUAL(AbstractSyntaxTree::statement_kind_to_string(AbstractSyntaxTree::statement_kind::UNKNOWN), "");
+}
+/**
+ * We check that children are found by kind on narrow nodes and on wide nodes that carry a child index.
+ */
+BOOST_AUTO_TEST_CASE(test_case_9)
+{
+	auto narrow = std::make_shared<AbstractSyntaxTree::Node>("narrow", "");
+	narrow->add_child(std::make_shared<AbstractSyntaxTree::Node>("relname", "emp"));
+	narrow->index_children();
+	BOOST_CHECK(narrow->child_index.empty());
+	BOOST_CHECK_EQUAL(narrow->get_value(AbstractSyntaxTree::intern_key("relname")), "emp");
+
+	auto wide = std::make_shared<AbstractSyntaxTree::Node>("wide", "");
+	for (size_t i = 0; i < AbstractSyntaxTree::child_index_threshold; ++i)
+	{
+		wide->add_child(std::make_shared<AbstractSyntaxTree::Node>("child_" + std::to_string(i), std::to_string(i)));
+	}
+	wide->add_child(std::make_shared<AbstractSyntaxTree::Node>("child_3", "second"));
+	wide->index_children();
+	BOOST_CHECK_EQUAL(wide->child_index.size(), wide->children.size());
+
+	// the first child of a kind wins, as with the linear scan
+	BOOST_CHECK_EQUAL(wide->get_child(AbstractSyntaxTree::intern_key("child_3"))->value, "3");
+	BOOST_CHECK_EQUAL(wide->get_child("child_7")->value, "7");
+	BOOST_CHECK(wide->get_child("never_interned_key") == nullptr);
+	BOOST_CHECK(wide->get_child(AbstractSyntaxTree::intern_key("relname")) == nullptr);
+
+	// adding a child drops the index so lookups fall back to the scan
+	wide->add_child(std::make_shared<AbstractSyntaxTree::Node>("relname", "dept"));
+	BOOST_CHECK(wide->child_index.empty());
+	BOOST_CHECK_EQUAL(wide->get_value("relname"), "dept");
+}
+/**
+ * We check that statements that are not listed in statement_kind are told apart and named by their node names.
+ */
+BOOST_AUTO_TEST_CASE(test_case_10)
+{
+	auto first = build_sql_tree_json(R"({"stmts": [{"stmt": {"FirstUnlistedStmt": {"relation": "emp"}}}]})");
+	auto second = build_sql_tree_json(R"({"stmts": [{"stmt": {"SecondUnlistedStmt": {"relation": "emp"}}}]})");
+	BOOST_CHECK(AbstractSyntaxTree::get_statement_kind(first) == AbstractSyntaxTree::statement_kind::UNKNOWN);
+	BOOST_CHECK(AbstractSyntaxTree::get_statement_kind(second) == AbstractSyntaxTree::statement_kind::UNKNOWN);
+
+	Common::comparision_result different = Goals::compare_single_statement(first, second);
+	BOOST_CHECK(different.incorrect_parts == std::vector<std::string>({"Statement Type"}));
+	BOOST_CHECK(different.message.find("FirstUnlistedStmt but your statement is a SecondUnlistedStmt") != std::string::npos);
+
+	Common::comparision_result same = Goals::compare_single_statement(first, build_sql_tree_json(R"({"stmts": [{"stmt": {"FirstUnlistedStmt": {"relation": "dept"}}}]})"));
+	BOOST_CHECK(same.message == "Unsupported statement type: FirstUnlistedStmt\n");
+}
 BOOST_AUTO_TEST_SUITE_END()
 //--------------------------------------------------------------------------------------------------------------
 // Test suite for checking the post-order traversal of a parse tree.
@@ -1061,6 +1544,8 @@ BOOST_AUTO_TEST_CASE(test_case_1)
 	// print_tree(node_f_2);
 
 	BOOST_CHECK_EQUAL(edit_distance, 0);
+	// the path strategy must agree with zhang_shasha
+	BOOST_CHECK_EQUAL(tree_edit_distance.apted(node_f, node_f_2), edit_distance);
 }
 /*
  * 				f				f
@@ -1106,6 +1591,8 @@ BOOST_AUTO_TEST_CASE(test_case_2)
 	// print_tree(node_f_2);
 
 	BOOST_CHECK_EQUAL(edit_distance, 2);
+	// the path strategy must agree with zhang_shasha
+	BOOST_CHECK_EQUAL(tree_edit_distance.apted(node_f, node_f_2), edit_distance);
 }
 /*
 Tree 1:                Tree 2:
@@ -1157,6 +1644,8 @@ BOOST_AUTO_TEST_CASE(test_case_3)
 	// print_tree(node_a_2);
 
 	BOOST_CHECK_EQUAL(edit_distance, 3);
+	// the path strategy must agree with zhang_shasha
+	BOOST_CHECK_EQUAL(tree_edit_distance.apted(node_a, node_a_2), edit_distance);
 }
 /*
 Tree 1:                Tree 2:
@@ -1208,6 +1697,8 @@ BOOST_AUTO_TEST_CASE(test_case_4)
 	// print_tree(node_a_2);
 
 	BOOST_CHECK_EQUAL(edit_distance, 1);
+	// the path strategy must agree with zhang_shasha
+	BOOST_CHECK_EQUAL(tree_edit_distance.apted(node_a, node_a_2), edit_distance);
 }
 /*
 Tree 1:                Tree 2:
@@ -1250,6 +1741,8 @@ BOOST_AUTO_TEST_CASE(test_case_5)
 	// print_tree(node_a_2);
 
 	BOOST_CHECK_EQUAL(edit_distance, 1);
+	// the path strategy must agree with zhang_shasha
+	BOOST_CHECK_EQUAL(tree_edit_distance.apted(node_a, node_a_2), edit_distance);
 }
 /*
 Tree 1:                Tree 2:
@@ -1300,6 +1793,556 @@ BOOST_AUTO_TEST_CASE(test_case_6)
 	// print_tree(node_a_2);
 
 	BOOST_CHECK_EQUAL(edit_distance, 3);
+	// the path strategy must agree with zhang_shasha
+	BOOST_CHECK_EQUAL(tree_edit_distance.apted(node_a, node_a_2), edit_distance);
+}
+/**
+ * Both algorithms compute the exact distance on random trees, where the subtrees off the leftmost paths are matched
+ * with each other.
+ */
+BOOST_AUTO_TEST_CASE(test_case_7)
+{
+	TreeEditDistance tree_edit_distance;
+	std::mt19937 generator(38);
+	for (int i = 0; i < 300; i++)
+	{
+		auto tree1 = random_tree(generator, 2 + generator() % 10, 3);
+		auto tree2 = random_tree(generator, 2 + generator() % 10, 3);
+		std::map<std::pair<std::vector<const void *>, std::vector<const void *>>, int> memo;
+		int exact = exact_forest_distance({tree1}, {tree2}, memo);
+		BOOST_CHECK_EQUAL(tree_edit_distance.zhang_shasha(tree1, tree2), exact);
+		BOOST_CHECK_EQUAL(tree_edit_distance.apted(tree1, tree2), exact);
+	}
+}
+BOOST_AUTO_TEST_SUITE_END()
+//---------------------------------------------------------------------------
+// Benchmark of the tree edit distance algorithms on trees that are deep on one side, run with --run_test=tree_edit_distance_benchmarks.
+// The timings depend on the build type, the CMakeLists.txt builds Debug.
+//---------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE(tree_edit_distance_benchmarks, *boost::unit_test::disabled())
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	TreeEditDistance tree_edit_distance;
+	std::mt19937 generator(38);
+
+	for (bool deep_on_the_right : {false, true})
+	{
+		for (std::size_t depth : {10, 25, 50})
+		{
+			auto tree1 = skewed_tree(generator, depth, 4, deep_on_the_right);
+			auto tree2 = skewed_tree(generator, depth, 4, deep_on_the_right);
+			int zhang_shasha_distance = 0, apted_distance = 0;
+			double zhang_shasha = time_per_call(3, [&]
+												{ zhang_shasha_distance = tree_edit_distance.zhang_shasha(tree1, tree2); });
+			double apted = time_per_call(3, [&]
+										 { apted_distance = tree_edit_distance.apted(tree1, tree2); });
+			// the timings only compare if both algorithms find the same distance
+			BOOST_TEST(apted_distance == zhang_shasha_distance);
+			std::cout << (deep_on_the_right ? "deep on the right" : "deep on the left") << ", " << 2 * depth + 1 << " nodes, distance " << apted_distance
+					  << ": zhang_shasha " << zhang_shasha << " us, apted " << apted << " us, " << zhang_shasha / apted << "x" << std::endl;
+		}
+	}
+}
+BOOST_AUTO_TEST_SUITE_END()
+//---------------------------------------------------------------------------
+// Test cases for the metric index over tree edit distances.
+// The index must find the same trees as comparing against every tree.
+//---------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE(tree_metric_index_test_suite)
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	for (auto tree_algorithm : {TreeEditDistance::algorithm::ZHANG_SHASHA, TreeEditDistance::algorithm::APTED})
+	{
+		std::mt19937 generator(36);
+		std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> trees;
+		for (int i = 0; i < 60; i++)
+			trees.push_back(random_tree(generator, 4 + generator() % 8, 3));
+		TreeMetricIndex index(tree_algorithm);
+		for (size_t i = 0; i < trees.size(); i++)
+			index.insert(i, trees[i]);
+		BOOST_TEST(index.size() == trees.size());
+
+		size_t within_evaluations = 0;
+		size_t nearest_evaluations = 0;
+		const int queries = 20;
+		for (int q = 0; q < queries; q++)
+		{
+			auto query = random_tree(generator, 4 + generator() % 8, 3);
+			// the exact tree edit distance to every tree
+			std::vector<int> distances;
+			for (const auto &tree : trees)
+			{
+				std::map<std::pair<std::vector<const void *>, std::vector<const void *>>, int> memo;
+				distances.push_back(exact_forest_distance({query}, {tree}, memo));
+			}
+
+			std::vector<size_t> expected;
+			for (size_t i = 0; i < trees.size(); i++)
+				if (distances[i] <= 2)
+					expected.push_back(i);
+			std::vector<size_t> found;
+			size_t evaluations = index.evaluations();
+			for (const auto &m : index.within(query, 2))
+			{
+				found.push_back(m.position);
+				BOOST_TEST(m.distance == distances[m.position]);
+			}
+			within_evaluations += index.evaluations() - evaluations;
+			BOOST_TEST(found == expected);
+
+			TreeMetricIndex::match best;
+			evaluations = index.evaluations();
+			BOOST_REQUIRE(index.nearest(query, best));
+			nearest_evaluations += index.evaluations() - evaluations;
+			auto nearest = std::min_element(distances.begin(), distances.end());
+			BOOST_TEST(best.distance == *nearest);
+			BOOST_TEST(best.position == static_cast<size_t>(nearest - distances.begin()));
+		}
+		// the searches skip part of the trees instead of comparing with every one
+		BOOST_TEST(within_evaluations < queries * trees.size());
+		BOOST_TEST(nearest_evaluations < queries * trees.size());
+	}
+}
+BOOST_AUTO_TEST_CASE(test_case_2)
+{
+	TreeMetricIndex index;
+	TreeMetricIndex::match best;
+	auto tree = std::make_shared<AbstractSyntaxTree::Node>("root", "");
+	BOOST_TEST(!index.nearest(tree, best));
+	BOOST_TEST(index.within(tree, 5).empty());
+
+	// equal trees are all kept and found at distance 0
+	index.insert(4, tree);
+	index.insert(2, std::make_shared<AbstractSyntaxTree::Node>("root", ""));
+	auto matches = index.within(tree, 0);
+	BOOST_REQUIRE(matches.size() == 2);
+	BOOST_TEST(matches[0].position == 2);
+	BOOST_TEST(matches[1].position == 4);
+	BOOST_REQUIRE(index.nearest(tree, best));
+	BOOST_TEST(best.position == 2);
+	BOOST_TEST(best.distance == 0);
+}
+BOOST_AUTO_TEST_SUITE_END()
+//---------------------------------------------------------------------------
+// Test cases for the cohort distance matrix.
+// The kept pairs must be the pairs found by comparing every pair, whatever the tile size.
+//---------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE(distance_matrix_test_suite)
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	std::mt19937 generator(39);
+	std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> trees;
+	std::vector<std::string> texts;
+	for (int i = 0; i < 70; i++)
+	{
+		// a few queries are not parseable and a few have the same text
+		trees.push_back(i % 11 == 5 ? nullptr : random_tree(generator, 3 + generator() % 6, 3));
+		texts.push_back(i % 9 == 0 ? "select 1" : random_string(generator, 4, 3));
+	}
+	const int max_tree_distance = 2, max_text_distance = 1;
+	Utils my_utils;
+	TreeEditDistance tree_edit_distance;
+	ThreadPool pool(4);
+	for (size_t tile_size : {1, 7, 32})
+	{
+		DistanceMatrix matrix;
+		BOOST_TEST(!matrix.is_computed());
+		matrix.compute(trees, texts, max_tree_distance, max_text_distance, TreeEditDistance::algorithm::APTED, pool, tile_size);
+		BOOST_TEST(matrix.is_computed());
+
+		size_t parseable_pairs = 0;
+		for (size_t i = 0; i < trees.size(); i++)
+		{
+			std::vector<size_t> expected;
+			for (size_t j = 0; j < trees.size(); j++)
+			{
+				if (i == j || !trees[i] || !trees[j])
+					continue;
+				parseable_pairs++;
+				int tree_distance = tree_edit_distance.apted(trees[i], trees[j]);
+				if (tree_distance > max_tree_distance && texts[i] != texts[j])
+					continue;
+				expected.push_back(j);
+				DistanceMatrix::entry pair;
+				BOOST_REQUIRE(matrix.find(i, j, pair));
+				BOOST_TEST(pair.tree_distance == tree_distance);
+				BOOST_TEST(pair.text_distance == static_cast<int>(my_utils.bounded_edit_distance(texts[i], texts[j], max_text_distance)));
+			}
+			std::vector<size_t> found;
+			for (const auto &neighbour : matrix.neighbours(i))
+				found.push_back(neighbour.position);
+			BOOST_TEST(found == expected);
+		}
+		// every pair above the diagonal is either pruned or computed once
+		BOOST_TEST(matrix.evaluations() + matrix.pruned() == parseable_pairs / 2);
+		BOOST_TEST(matrix.pruned() > 0);
+	}
+	BOOST_TEST(DistanceMatrix().neighbours(3).empty());
+}
+BOOST_AUTO_TEST_SUITE_END()
+//---------------------------------------------------------------------------
+// Test cases for the background grading jobs.
+//---------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE(grading_jobs_test_suite)
+// waits until a job is in a state, or fails after a few seconds
+GradingJobs::snapshot wait_for_job(const GradingJobs &jobs, const std::string &id, GradingJobs::status state)
+{
+	GradingJobs::snapshot job;
+	for (int i = 0; i < 500; i++)
+	{
+		BOOST_REQUIRE(jobs.find(id, job));
+		if (job.state == state)
+			return job;
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	BOOST_FAIL("job " + id + " is " + GradingJobs::to_string(job.state) + ", expected " + GradingJobs::to_string(state));
+	return job;
+}
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	// one worker and room for one waiting job
+	GradingJobs jobs(1, 1);
+	std::promise<void> release;
+	std::shared_future<void> released = release.get_future().share();
+	std::string first, second, third;
+	BOOST_REQUIRE(jobs.submit([released](ProcessQueries::progress &progress, const GradingJobs::record_sink &add_record)
+							  {
+		progress.students = 3;
+		progress.answers = 2;
+		progress.pre_processed = 2;
+		// the students are graded out of order
+		add_record(2, "{\"c\":2}");
+		progress.syntax = 1;
+		released.wait();
+		add_record(0, "{\"a\":0}");
+		add_record(1, "{\"b\":1}"); }, first));
+	GradingJobs::snapshot job = wait_for_job(jobs, first, GradingJobs::status::RUNNING);
+
+	// the running job does not take the place of a waiting job, the job after the waiting one is refused
+	BOOST_REQUIRE(jobs.submit([](ProcessQueries::progress &, const GradingJobs::record_sink &)
+							  { throw std::runtime_error("no model queries"); }, second));
+	BOOST_TEST(second != first);
+	BOOST_REQUIRE(jobs.find(second, job));
+	BOOST_TEST(GradingJobs::to_string(job.state) == "queued");
+	BOOST_TEST(!jobs.submit([](ProcessQueries::progress &, const GradingJobs::record_sink &) {}, third));
+
+	// the progress of the running job is visible while it runs
+	for (int i = 0; i < 500 && job.syntax == 0; i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		BOOST_REQUIRE(jobs.find(first, job));
+	}
+	BOOST_TEST(GradingJobs::to_string(job.state) == "running");
+	BOOST_TEST(job.students == 3);
+	BOOST_TEST(job.answers == 2);
+	BOOST_TEST(job.pre_processed == 2);
+	BOOST_TEST(job.syntax == 1);
+	BOOST_TEST(job.semantics == 0);
+	std::string results;
+	BOOST_TEST(!jobs.results(first, results));
+	std::vector<std::string> records;
+	GradingJobs::status state;
+	std::size_t from = 0;
+	BOOST_REQUIRE(jobs.records(first, from, records, state));
+	BOOST_TEST(records == std::vector<std::string>({"{\"c\":2}"}));
+
+	// the records come in the order they were added, the results in the order of the students
+	release.set_value();
+	wait_for_job(jobs, first, GradingJobs::status::DONE);
+	BOOST_REQUIRE(jobs.results(first, results));
+	BOOST_TEST(results == "[{\"a\":0},{\"b\":1},{\"c\":2}]");
+	from = 1;
+	BOOST_REQUIRE(jobs.records(first, from, records, state));
+	BOOST_TEST(from == 1);
+	BOOST_TEST(records == std::vector<std::string>({"{\"a\":0}", "{\"b\":1}"}));
+	BOOST_TEST(GradingJobs::to_string(state) == "done");
+
+	// the records the client has are released, they are not returned again and the results are gone
+	BOOST_REQUIRE(jobs.find(first, job));
+	BOOST_TEST(job.released == 1);
+	BOOST_TEST(!jobs.results(first, results));
+	from = 0;
+	BOOST_REQUIRE(jobs.records(first, from, records, state));
+	BOOST_TEST(from == 1);
+	BOOST_TEST(records.size() == 2);
+	from = 3;
+	BOOST_REQUIRE(jobs.records(first, from, records, state));
+	BOOST_TEST(records.empty());
+	BOOST_REQUIRE(jobs.find(first, job));
+	BOOST_TEST(job.released == 3);
+
+	job = wait_for_job(jobs, second, GradingJobs::status::FAILED);
+	BOOST_TEST(job.error == "no model queries");
+	BOOST_TEST(!jobs.results(second, results));
+	BOOST_TEST(!jobs.find("unknown", job));
+	from = 0;
+	BOOST_TEST(!jobs.records("unknown", from, records, state));
+}
+BOOST_AUTO_TEST_CASE(test_case_2)
+{
+	// only the two newest finished jobs are kept
+	GradingJobs jobs(1, 4, 2);
+	std::vector<std::string> ids(3);
+	for (size_t i = 0; i < ids.size(); i++)
+	{
+		BOOST_REQUIRE(jobs.submit([i](ProcessQueries::progress &, const GradingJobs::record_sink &add_record)
+								  { add_record(0, std::to_string(i)); }, ids[i]));
+		wait_for_job(jobs, ids[i], GradingJobs::status::DONE);
+	}
+	GradingJobs::snapshot job;
+	std::string results;
+	BOOST_TEST(!jobs.find(ids[0], job));
+	BOOST_REQUIRE(jobs.results(ids[1], results));
+	BOOST_TEST(results == "[1]");
+	BOOST_REQUIRE(jobs.results(ids[2], results));
+	BOOST_TEST(results == "[2]");
+}
+BOOST_AUTO_TEST_SUITE_END()
+//---------------------------------------------------------------------------
+// Test cases for the admission of the gradings.
+//---------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE(grading_scheduler_test_suite)
+// waits until a number of gradings wait, or fails after a few seconds
+void wait_for_waiting(const GradingScheduler &scheduler, std::size_t waiting)
+{
+	for (int i = 0; i < 500 && scheduler.statistics().waiting != waiting; i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	BOOST_REQUIRE(scheduler.statistics().waiting == waiting);
+}
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	// one cohort fits next to the reserve of the single submissions, one more can wait
+	GradingScheduler scheduler(4, 3, 1, 1);
+	auto cohort = scheduler.admit("a", GradingScheduler::lane::BULK);
+	BOOST_REQUIRE(cohort);
+	BOOST_TEST(scheduler.admit("b", GradingScheduler::lane::INTERACTIVE));
+	std::thread waiting([&scheduler]()
+						{ BOOST_TEST(scheduler.admit("a", GradingScheduler::lane::BULK)); });
+	wait_for_waiting(scheduler, 1);
+	BOOST_TEST(!scheduler.admit("c", GradingScheduler::lane::BULK));
+	BOOST_TEST(scheduler.retry_after() >= 1);
+	cohort.reset();
+	waiting.join();
+	GradingScheduler::stats stats = scheduler.statistics();
+	BOOST_TEST(stats.admitted == 3);
+	BOOST_TEST(stats.refused == 1);
+	BOOST_TEST(stats.running == 0);
+}
+BOOST_AUTO_TEST_CASE(test_case_2)
+{
+	// the tenant that is served least goes first, whatever the order the gradings came in
+	GradingScheduler scheduler(2, 1, 1, 8);
+	auto cohort = scheduler.admit("a", GradingScheduler::lane::BULK);
+	std::vector<std::string> order;
+	std::mutex order_mutex;
+	std::vector<std::thread> cohorts;
+	for (const std::string tenant : {"a", "a", "b"})
+	{
+		cohorts.emplace_back([&, tenant]()
+							 {
+			auto admitted = scheduler.admit(tenant, GradingScheduler::lane::BULK);
+			std::lock_guard<std::mutex> lock(order_mutex);
+			order.push_back(tenant); });
+		wait_for_waiting(scheduler, cohorts.size());
+	}
+	// a single submission does not wait behind the cohorts
+	BOOST_TEST(scheduler.admit("c", GradingScheduler::lane::INTERACTIVE));
+	cohort.reset();
+	for (auto &thread : cohorts)
+		thread.join();
+	BOOST_TEST(order == std::vector<std::string>({"b", "a", "a"}));
+}
+BOOST_AUTO_TEST_SUITE_END()
+//---------------------------------------------------------------------------
+// Test cases for the store of the uploaded datasets.
+//---------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE(dataset_store_test_suite)
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "socoles_dataset_store_test";
+	std::filesystem::remove_all(directory);
+	DatasetStore datasets(directory);
+	std::string script = "CREATE TABLE Artist(id INT PRIMARY KEY, name TEXT); INSERT INTO Artist VALUES (1, 'John Lennon');";
+	std::string hash = DatasetStore::sha256(script);
+	BOOST_TEST(DatasetStore::sha256("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+	BOOST_TEST(DatasetStore::is_hash(hash));
+	BOOST_TEST(!DatasetStore::is_hash("../" + hash.substr(3)));
+
+	// a dataset is only stored under the hash of its content, and once
+	BOOST_CHECK_THROW(datasets.put(DatasetStore::sha256("abc"), script), std::invalid_argument);
+	BOOST_TEST(!datasets.contains(hash));
+	BOOST_TEST(!datasets.acquire(hash));
+	BOOST_TEST(datasets.put(hash, script));
+	BOOST_TEST(!datasets.put(hash, script));
+	BOOST_TEST(datasets.contains(hash));
+
+	// a referenced dataset is kept until its last reference is gone, its content is read once
+	auto first = datasets.acquire(hash);
+	auto second = datasets.acquire(hash);
+	auto file = datasets.acquire(hash, false);
+	BOOST_REQUIRE(first);
+	BOOST_TEST(*first->content == script);
+	BOOST_TEST(first->content == second->content);
+	BOOST_TEST(!file->content);
+	BOOST_TEST(file->path == directory / hash);
+	BOOST_TEST(datasets.references(hash) == 3);
+	BOOST_TEST((datasets.remove(hash) == DatasetStore::removal::REFERENCED));
+	first.reset();
+	second.reset();
+	file.reset();
+	BOOST_TEST(datasets.references(hash) == 0);
+	BOOST_TEST((datasets.remove(hash) == DatasetStore::removal::REMOVED));
+	BOOST_TEST((datasets.remove(hash) == DatasetStore::removal::UNKNOWN));
+	BOOST_TEST(!datasets.contains(hash));
+
+	// the files of the tables are stored as they are
+	std::string parquet("PAR1\0\x15\x04PAR1", 11);
+	BOOST_TEST(datasets.put(DatasetStore::sha256(parquet), parquet));
+	BOOST_TEST(*datasets.acquire(DatasetStore::sha256(parquet))->content == parquet);
+	std::filesystem::remove_all(directory);
+}
+BOOST_AUTO_TEST_SUITE_END()
+//---------------------------------------------------------------------------
+// Test cases for the pq-gram profiles and distance.
+//---------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE(pq_gram_test_suite)
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	// a root with two leaves has 2 + 3 - 1 pq-grams anchored at the root and one at each leaf
+	auto root = std::make_shared<AbstractSyntaxTree::Node>("a", "");
+	root->add_child(std::make_shared<AbstractSyntaxTree::Node>("b", ""));
+	root->add_child(std::make_shared<AbstractSyntaxTree::Node>("c", ""));
+	PqGram::profile profile = PqGram::make_profile(root);
+	BOOST_TEST(profile.size() == 6);
+	BOOST_TEST(std::is_sorted(profile.begin(), profile.end()));
+	BOOST_TEST(PqGram::distance(profile, profile) == 0.0);
+	BOOST_TEST(PqGram::make_profile(nullptr).empty());
+
+	// no pq-gram in common
+	auto other = std::make_shared<AbstractSyntaxTree::Node>("x", "");
+	other->add_child(std::make_shared<AbstractSyntaxTree::Node>("y", ""));
+	BOOST_TEST(PqGram::distance(profile, PqGram::make_profile(other)) == 1.0);
+}
+BOOST_AUTO_TEST_CASE(test_case_2)
+{
+	// the value of a node is part of its label, as in the tree edit distance
+	auto tree_a = build_sql_tree("select col1 from table1 where val1 = 2;");
+	auto tree_b = build_sql_tree("select col1 from table1 where val1 = 3;");
+	auto tree_c = build_sql_tree("select col3, col5, col6 from table3 where val1 = 2 and val2 = 4;");
+	PqGram::profile profile_a = PqGram::make_profile(tree_a);
+	PqGram::profile profile_b = PqGram::make_profile(tree_b);
+	PqGram::profile profile_c = PqGram::make_profile(tree_c);
+
+	BOOST_TEST(PqGram::distance(profile_a, PqGram::make_profile(build_sql_tree("SELECT col1 FROM table1 WHERE val1 = 2;"))) == 0.0);
+	BOOST_TEST(PqGram::distance(profile_a, profile_b) > 0.0);
+	BOOST_TEST(PqGram::distance(profile_a, profile_b) == PqGram::distance(profile_b, profile_a));
+	// the closer tree in edit distance is also the closer one in pq-gram distance
+	BOOST_TEST(PqGram::distance(profile_a, profile_b) < PqGram::distance(profile_a, profile_c));
+	BOOST_TEST(PqGram::shared_grams(profile_a, profile_b) <= std::min(profile_a.size(), profile_b.size()));
+}
+BOOST_AUTO_TEST_SUITE_END()
+//---------------------------------------------------------------------------
+// Benchmark of the pq-gram distance against the exact tree edit distance, run with --run_test=pq_gram_benchmarks.
+// The queries are the SELECT queries used in the other test suites.
+//---------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE(pq_gram_benchmarks, *boost::unit_test::disabled())
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	std::vector<std::string> corpus = {
+		"select col1 from table1;",
+		"select col2 from table1;",
+		"select col1 from table2;",
+		"select col1 from table1 where val1 = 2;",
+		"select col1 from table1 where val1 = 3;",
+		"select col1, col2 from table1;",
+		"select col1, col3 from table1;",
+		"select col1 from table2 where val1 = 2;",
+		"select col3, col5, col6 from table3 where val1 = 2 and val2 = 4;",
+		"select * from table1 where val1 = 2;",
+		"select * from table1 where val2 = 2;",
+		"select * from theme where theme_id = 2;",
+		"select * from theme where themeid = 2;",
+		"select * from emp;",
+		"select empno from emp;",
+		"select empno, ename from emp;",
+		"select empno, name from emp;",
+		"select ename from emp e where e.deptno = 10;",
+		"select ename from emp where emp.deptno = 10;",
+		"select ename from emp join dept on emp.deptno = dept.deptno where dept.loc = 'NEW YORK';",
+		"select ename, job from emp order by ename;",
+		"select job,ename from emp order by ename;",
+		"SELECT * FROM emp WHERE empno = 7934",
+		"SELECT name FROM artist;",
+		"SELECT name as a FROM artist;",
+		"SELECT a.name FROM artist a;",
+		"SELECT DISTINCT a.name FROM artist a;",
+		"SELECT a.name FROM artist a WHERE a.id > 3 ORDER BY a.name;",
+		"SELECT artist.name FROM artist WHERE artist.id >= 3;",
+		"SELECT email FROM Person WHERE person_name = 'John Doe';",
+		"SELECT Person.email  FROM Person  WHERE person_name = 'Jo Doe';",
+		"SELECT name, hire_date FROM Employee WHERE salary >= 2500 AND salary <= 3500;",
+		"SELECT name, hire_date FROM Employee WHERE salary BETWEEN 2500.00 AND 3500.00;",
+		"SELECT song FROM Album A, Track T WHERE A.album_id = T.album_id AND A.title = 'Nevermind';",
+		"SELECT song FROM Album A, Track T WHERE A.title = 'Nevermind' AND A.album_id = T.album_id;",
+		"SELECT A.name, COUNT(P.tracks_id) AS least3 FROM Artist A JOIN Performs P ON A.artist_id = P.artist_id",
+		"SELECT COUNT(P.tracks_id) AS least3, A.name FROM Performs P JOIN Artist A ON A.artist_id = P.artist_id",
+		"SELECT department, COUNT(*) FROM employees GROUP BY department HAVING AVG(salary) > 60000 AND COUNT(*) > 5;",
+		"SELECT department, SUM(salary) FROM employees GROUP BY department HAVING COUNT(*) > 50 OR SUM(salary) > 500000;",
+		"SELECT * FROM employees WHERE (department = 'Sales' AND salary > 50000) OR (department = 'Engineering' AND salary > 70000);",
+		"SELECT d.name AS department_name, SUM(e.salary) AS total_salary FROM departments d JOIN employees e ON d.id = e.department_id GROUP BY d.name HAVING total_salary > 500000;",
+	};
+	Admin admin;
+	TreeEditDistance tree_edit_distance;
+	std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> trees;
+	std::vector<PqGram::profile> profiles;
+	for (const auto &query : corpus)
+	{
+		trees.push_back(build_sql_tree(query));
+		profiles.push_back(PqGram::make_profile(trees.back()));
+	}
+
+	// all pairs, with the exact and the approximate distance
+	std::vector<std::pair<int, double>> pairs;
+	for (size_t i = 0; i < trees.size(); i++)
+		for (size_t j = i + 1; j < trees.size(); j++)
+			pairs.push_back({tree_edit_distance.zhang_shasha(trees[i], trees[j]), PqGram::distance(profiles[i], profiles[j])});
+
+	// rank agreement: the share of pairs of pairs that both distances order the same way
+	size_t concordant = 0, discordant = 0;
+	for (size_t a = 0; a < pairs.size(); a++)
+		for (size_t b = a + 1; b < pairs.size(); b++)
+		{
+			int exact = pairs[a].first - pairs[b].first;
+			double approximate = pairs[a].second - pairs[b].second;
+			if ((exact < 0 && approximate < 0) || (exact > 0 && approximate > 0))
+				concordant++;
+			else if ((exact < 0 && approximate > 0) || (exact > 0 && approximate < 0))
+				discordant++;
+		}
+	std::cout << "pq-gram vs tree edit distance over " << pairs.size() << " pairs: " << concordant << " concordant, "
+			  << discordant << " discordant" << std::endl;
+
+	// the pairs a prefilter would keep and the minor error pairs it would lose
+	for (double max_distance : {0.4, 0.5, 0.6, 0.7, 0.8})
+	{
+		size_t kept = 0, minor = 0, minor_kept = 0;
+		for (const auto &[exact, approximate] : pairs)
+		{
+			bool is_kept = approximate <= max_distance;
+			bool is_minor = exact <= admin.get_semantics_minor_incorrect_ted();
+			kept += is_kept;
+			minor += is_minor;
+			minor_kept += is_kept && is_minor;
+		}
+		std::cout << "max pq-gram distance " << max_distance << ": kept " << kept << " of " << pairs.size() << " pairs, "
+				  << minor_kept << " of " << minor << " pairs within tree edit distance " << admin.get_semantics_minor_incorrect_ted() << std::endl;
+	}
+
+	double exact_time = time_per_call(5, [&]
+									  { for (size_t i = 1; i < trees.size(); i++) tree_edit_distance.zhang_shasha(trees[0], trees[i]); });
+	double approximate_time = time_per_call(5, [&]
+											{ for (size_t i = 1; i < trees.size(); i++) PqGram::distance(profiles[0], profiles[i]); });
+	std::cout << "one query against the corpus: zhang_shasha " << exact_time << " us, pq-gram " << approximate_time << " us" << std::endl;
 }
 BOOST_AUTO_TEST_SUITE_END()
 //---------------------------------------------------------------------------
@@ -1470,7 +2513,6 @@ BOOST_AUTO_TEST_CASE(test_case_9)
 	 * Without the pruning of the tree, the edit distance is 4.
 	 * With the pruning of the tree, the edit distance is 1.
 	 */
-	AbstractSyntaxTree ast;
 	// queries
 	std::string query_a = "select * from theme where theme_id = 2;";
 	std::string query_b = "select * from theme where themeid = 2;";
@@ -1482,8 +2524,8 @@ BOOST_AUTO_TEST_CASE(test_case_9)
 	TreeEditDistance tree_edit_distance;
 
 	int edit_distance = tree_edit_distance.zhang_shasha(tree_a, tree_b);
-	// ast.print_tree(tree_a);
-	// ast.print_tree(tree_b);
+	// AbstractSyntaxTree::print_tree(tree_a);
+	// AbstractSyntaxTree::print_tree(tree_b);
 
 	BOOST_CHECK_EQUAL(edit_distance, 1);
 }
@@ -2224,6 +3266,45 @@ BOOST_AUTO_TEST_CASE(test_case_17)
 		BOOST_CHECK(matrix[i].syntax == expected[i].syntax);
 	}
 }
+/**
+ * We check that the precomputed correctness tables give the same level as a linear search through the matrix,
+ * for every level and order combination and every outcome in the matrix.
+ */
+BOOST_AUTO_TEST_CASE(test_case_18)
+{
+	Grader grader;
+
+	using ps = Grader::property_state;
+	using pl = Grader::property_level;
+	using po = Grader::property_order;
+
+	for (size_t sn = 0; sn < Grader::property_level_count; ++sn)
+		for (size_t sm = 0; sm < Grader::property_level_count; ++sm)
+			for (size_t rs = 0; rs < Grader::property_level_count; ++rs)
+				for (size_t order = 0; order < Grader::property_order_count; ++order)
+				{
+					std::vector<Grader::properties> matrix = grader.get_correctness_matrix(static_cast<pl>(rs), static_cast<pl>(sm), static_cast<pl>(sn), static_cast<po>(order));
+					for (size_t i = 0; i < matrix.size(); ++i)
+					{
+						// the first matching row is the level, as in the original linear search
+						int expected_level = 1;
+						while (!(matrix[expected_level - 1].results == matrix[i].results && matrix[expected_level - 1].semantics == matrix[i].semantics && matrix[expected_level - 1].syntax == matrix[i].syntax))
+						{
+							expected_level++;
+						}
+						std::pair<int, double> level = grader.calculate_correctness_level(static_cast<pl>(sn), static_cast<pl>(sm), static_cast<pl>(rs), static_cast<po>(order), matrix[i].results, matrix[i].semantics, matrix[i].syntax);
+						BOOST_CHECK_EQUAL(level.first, expected_level);
+						if (matrix.size() > 1)
+						{
+							BOOST_CHECK_CLOSE(level.second, grader.correctness_level_normalized_value(matrix, expected_level), 1e-9);
+						}
+					}
+				}
+
+	// an outcome that is not in the matrix is placed after the last level
+	std::pair<int, double> level = grader.calculate_correctness_level(pl::TWO_LEVELS, pl::TWO_LEVELS, pl::TWO_LEVELS, po::RE_SM_SY, ps::INCORRECT, ps::CORRECT, ps::CORRECT);
+	BOOST_CHECK_EQUAL(level.first, 7);
+}
 BOOST_AUTO_TEST_SUITE_END()
 //--------------------------------------------------------------------------------------------------------------
 // Test suite for checking fingerprint.
@@ -2232,7 +3313,6 @@ BOOST_AUTO_TEST_SUITE(fingerprint_test_suite)
 BOOST_AUTO_TEST_CASE(test_case_1)
 {
 	Grader grader;
-	AbstractSyntaxTree ast;
 
 	std::string query_a = "SELECT first_name AS forename, last_name AS surname FROM students WHERE class = 'modelling';";
 	std::string query_b = "SELECT first_name AS forename_alias, last_name AS surname_alias FROM students WHERE class = 'modelling';";
@@ -2546,6 +3626,256 @@ BOOST_AUTO_TEST_CASE(test_case_4)
 	BOOST_CHECK_EQUAL(student_queries[0].get_normalized_value(), 1);
 	BOOST_CHECK_EQUAL(student_queries[0].get_grade(), 1);
 }
+/**
+ * students with the same answer are graded once and get the same grading
+ */
+BOOST_AUTO_TEST_CASE(test_case_5)
+{
+	string sql_file = "../samples/test_tables.sql";
+	using pl = Grader::property_level;
+	using po = Grader::property_order;
+	Admin admin(pl::THREE_LEVELS, pl::THREE_LEVELS, pl::THREE_LEVELS, po::RE_SM_SY, 1);
+	Grader grader;
+
+	vector<ModelQuery> model_queries = {ModelQuery("1", "select ename, job from emp order by ename;")};
+	Admin::database_options db_opts = {sql_file, 0, 0, "", "", "", false};
+	vector<StudentQuery> student_queries = {StudentQuery("1", "select empno from emp;", "Q1", 1),
+											StudentQuery("2", "select ename, job from emp order by ename;", "Q1", 1),
+											StudentQuery("3", "select empno  from   emp;", "Q1", 2),
+											StudentQuery("4", "SELECT empno FROM emp;", "Q1", 1)};
+
+	ProcessQueries process_queries(model_queries, student_queries, db_opts, admin, grader);
+
+	// only repeated spaces are ignored, a change of case is another answer
+	BOOST_CHECK_EQUAL(process_queries.get_answer_class(0), 0);
+	BOOST_CHECK_EQUAL(process_queries.get_answer_class(1), 1);
+	BOOST_CHECK_EQUAL(process_queries.get_answer_class(2), 0);
+	BOOST_CHECK_EQUAL(process_queries.get_answer_class(3), 2);
+	// the student fields are kept and the grading is copied
+	BOOST_CHECK_EQUAL(student_queries[2].get_id(), "3");
+	BOOST_CHECK_EQUAL(student_queries[2].get_value(), "select empno  from   emp;");
+	BOOST_CHECK_EQUAL(student_queries[2].get_attempt_number(), 2);
+	BOOST_CHECK_EQUAL(student_queries[2].get_grade(), student_queries[0].get_grade());
+	BOOST_CHECK_EQUAL(student_queries[2].get_correctness_level(), student_queries[0].get_correctness_level());
+	BOOST_CHECK_EQUAL(student_queries[2].get_feedback(), student_queries[0].get_feedback());
+	BOOST_CHECK_EQUAL(student_queries[1].get_grade(), 1);
+}
+BOOST_AUTO_TEST_CASE(test_case_6)
+{
+	string sql_file = "../samples/test_tables.sql";
+	using pl = Grader::property_level;
+	using po = Grader::property_order;
+	Admin admin(pl::THREE_LEVELS, pl::THREE_LEVELS, pl::THREE_LEVELS, po::RE_SM_SY, 1);
+	Grader grader;
+
+	vector<ModelQuery> model_queries = {ModelQuery("1", "select ename, job from emp order by ename;")};
+	Admin::database_options db_opts = {sql_file, 0, 0, "", "", "", false};
+	vector<StudentQuery> student_queries = {StudentQuery("1", "select empno from emp;", "Q1", 1),
+											StudentQuery("2", "select ename, job from emp order by ename;", "Q1", 1),
+											StudentQuery("3", "select empno  from   emp;", "Q1", 2),
+											StudentQuery("4", "select ename, job from emp order by enam;", "Q1", 1)};
+
+	// every student is reported once, with the grading it ends up with
+	// the callback runs on the grading threads, so the reports are only collected there and checked here
+	std::mutex reported_mutex;
+	std::vector<std::pair<size_t, ProcessQueries::grading_info>> reports;
+	ProcessQueries::progress progress;
+	ProcessQueries process_queries(model_queries, student_queries, db_opts, admin, grader, &progress,
+								   [&reported_mutex, &reports](size_t position, const ProcessQueries::grading_info &info)
+								   {
+									   std::lock_guard<std::mutex> lock(reported_mutex);
+									   reports.emplace_back(position, info);
+								   });
+
+	std::map<size_t, ProcessQueries::grading_info> reported;
+	for (const auto &[position, info] : reports)
+		BOOST_CHECK(reported.emplace(position, info).second);
+	BOOST_REQUIRE_EQUAL(reported.size(), student_queries.size());
+	std::vector<ProcessQueries::grading_info> grading_info = process_queries.get_grading_info(&student_queries, admin);
+	for (size_t i = 0; i < student_queries.size(); i++)
+	{
+		BOOST_CHECK_EQUAL(reported[i].org_defined_id, grading_info[i].org_defined_id);
+		BOOST_CHECK_EQUAL(reported[i].query, grading_info[i].query);
+		BOOST_CHECK_EQUAL(reported[i].grade, grading_info[i].grade);
+		BOOST_CHECK_EQUAL(reported[i].feedback, grading_info[i].feedback);
+	}
+	BOOST_CHECK_EQUAL(progress.students, 4);
+	BOOST_CHECK_EQUAL(progress.answers, 3);
+	BOOST_CHECK_EQUAL(progress.semantics, 3);
+	BOOST_CHECK_EQUAL(progress.graded, 3);
+}
+BOOST_AUTO_TEST_CASE(test_case_7)
+{
+	string sql_file = "../samples/test_tables.sql";
+	using pl = Grader::property_level;
+	using po = Grader::property_order;
+	Admin admin(pl::THREE_LEVELS, pl::THREE_LEVELS, pl::THREE_LEVELS, po::RE_SM_SY, 1);
+	Grader grader;
+	Admin::database_options db_opts = {sql_file, 0, 0, "", "", "", false};
+
+	// a quiz with a model query that is not parseable is refused
+	QuizStore quizzes;
+	BOOST_CHECK_THROW(quizzes.add({ModelQuery("1", "select ename, from emp;")}, admin, db_opts), std::invalid_argument);
+	BOOST_CHECK_THROW(quizzes.add({}, admin, db_opts), std::invalid_argument);
+	BOOST_CHECK_EQUAL(quizzes.size(), 0);
+
+	auto quiz = quizzes.add({ModelQuery("1", "select ename, job from emp order by ename;")}, admin, db_opts);
+	BOOST_REQUIRE(quizzes.find(quiz->id) == quiz);
+	BOOST_REQUIRE(quiz->model_queries[0].is_pre_processed());
+	BOOST_CHECK(!quiz->model_queries[0].get_output().empty());
+	BOOST_CHECK(!quiz->model_queries[0].get_goal_general().empty());
+
+	// the registered quiz grades as the quiz sent with the student queries
+	vector<StudentQuery> expected = {StudentQuery("1", "select empno from emp;", "Q1", 1),
+									 StudentQuery("2", "select ename, job from emp order by ename;", "Q1", 1),
+									 StudentQuery("3", "select ename, job from emp order by enam;", "Q1", 1)};
+	vector<StudentQuery> student_queries = expected;
+	vector<ModelQuery> model_queries = {ModelQuery("1", "select ename, job from emp order by ename;")};
+	ProcessQueries process_queries(model_queries, expected, db_opts, admin, grader);
+	for (int run = 0; run < 2; run++)
+	{
+		vector<StudentQuery> graded = student_queries;
+		vector<ModelQuery> quiz_model_queries = quiz->model_queries;
+		ProcessQueries quiz_process_queries(quiz_model_queries, graded, quiz->db_opts, quiz->admin, grader);
+		for (size_t i = 0; i < graded.size(); i++)
+		{
+			BOOST_CHECK_EQUAL(graded[i].get_grade(), expected[i].get_grade());
+			BOOST_CHECK_EQUAL(graded[i].get_feedback(), expected[i].get_feedback());
+		}
+	}
+
+	BOOST_CHECK(quizzes.remove(quiz->id));
+	BOOST_CHECK(!quizzes.remove(quiz->id));
+	BOOST_CHECK(quizzes.find(quiz->id) == nullptr);
+}
+/**
+ * A practice grader grades a single submission as a cohort of that one submission is graded, and keeps the correct
+ * answers once, also when the submissions are graded at the same time.
+ */
+BOOST_AUTO_TEST_CASE(test_case_8)
+{
+	string sql_file = "../samples/test_tables.sql";
+	using pl = Grader::property_level;
+	using po = Grader::property_order;
+	Admin admin(pl::THREE_LEVELS, pl::THREE_LEVELS, pl::THREE_LEVELS, po::RE_SM_SY, 1);
+	Grader grader;
+	Admin::database_options db_opts = {sql_file, 0, 0, "", "", "", false};
+
+	QuizStore quizzes;
+	auto quiz = quizzes.add({ModelQuery("1", "select ename, job from emp order by ename;")}, admin, db_opts);
+	PracticeGrader practice(quiz, 2);
+	BOOST_CHECK_EQUAL(practice.engines(), 2);
+
+	// the correct answer comes last, so the bank is empty as the cohort of one is for the others
+	vector<StudentQuery> submissions = {StudentQuery("1", "select empno from emp;", "Q1", 1),
+										StudentQuery("2", "select ename, job from emp order by enam;", "Q1", 1),
+										StudentQuery("3", "selec ename, job from emp order by ename;", "Q1", 1),
+										StudentQuery("4", "select ename, job from emp order by ename;", "Q1", 1)};
+	for (const auto &submission : submissions)
+	{
+		vector<StudentQuery> cohort = {submission};
+		vector<ModelQuery> model_queries = {ModelQuery("1", "select ename, job from emp order by ename;")};
+		ProcessQueries process_queries(model_queries, cohort, db_opts, admin, grader);
+		ProcessQueries::grading_info expected = ProcessQueries::get_grading_info(cohort[0], admin);
+		ProcessQueries::grading_info graded = practice.grade(submission);
+		BOOST_CHECK_EQUAL(graded.grade, expected.grade);
+		BOOST_CHECK_EQUAL(graded.feedback, expected.feedback);
+		BOOST_CHECK_EQUAL(graded.org_defined_id, expected.org_defined_id);
+	}
+	BOOST_CHECK_EQUAL(practice.bank_size(), 1);
+
+	// a new correct answer graded from several threads at the same time is kept once
+	vector<std::future<ProcessQueries::grading_info>> gradings;
+	for (int i = 0; i < 8; i++)
+	{
+		gradings.push_back(std::async(std::launch::async, [&practice, i]()
+									  { return practice.grade(StudentQuery(std::to_string(i), "select e.ename, e.job from emp e order by e.ename;", "Q1", 1)); }));
+	}
+	ProcessQueries::grading_info correct = practice.grade(submissions[3]);
+	for (auto &grading : gradings)
+	{
+		BOOST_CHECK_EQUAL(grading.get().grade, correct.grade);
+	}
+	BOOST_CHECK_EQUAL(practice.bank_size(), 2);
+}
+BOOST_AUTO_TEST_SUITE_END()
+//---------------------------------------------------------------------------
+// Benchmark of single submissions graded by a practice grader against a cohort of one, run with
+// --run_test=practice_grader_benchmarks. It prints the p50 and p99 latencies of each path.
+//---------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE(practice_grader_benchmarks, *boost::unit_test::disabled())
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	const std::vector<std::string> variants = {
+		"select ename, job from emp order by ename;",
+		"select job, ename from emp order by ename;",
+		"select ename, job from emp;",
+		"select ename from emp order by ename;",
+		"select e.ename, e.job from emp e order by e.ename;",
+		"select ename, job from emp order by enam;",
+		"selec ename, job from emp order by ename;",
+		"select ename, job from emp where deptno = 10 order by ename;",
+		"SELECT ename, job FROM emp ORDER BY ename;",
+		"select empno from emp;",
+	};
+	const std::size_t threads = 4;
+	const std::size_t submissions = 50;
+	using pl = Grader::property_level;
+	using po = Grader::property_order;
+	Admin admin(pl::THREE_LEVELS, pl::THREE_LEVELS, pl::THREE_LEVELS, po::RE_SM_SY, 1);
+	Admin::database_options db_opts = {"../samples/test_tables.sql", 0, 0, "", "", "", false};
+	QuizStore quizzes;
+	auto quiz = quizzes.add({ModelQuery("1", variants[0])}, admin, db_opts);
+
+	auto percentiles = [](std::vector<double> latencies)
+	{
+		std::sort(latencies.begin(), latencies.end());
+		auto at = [&latencies](double fraction)
+		{ return latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(fraction * latencies.size()))]; };
+		return std::make_pair(at(0.5), at(0.99));
+	};
+	auto milliseconds_since = [](std::chrono::steady_clock::time_point start)
+	{ return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+
+	// a cohort of one: the database is loaded and the model query pre-processed for each submission
+	std::vector<double> cohort_latencies;
+	for (std::size_t i = 0; i < submissions; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		Grader grader;
+		vector<StudentQuery> cohort = {StudentQuery(std::to_string(i), variants[i % variants.size()], "Q1", 1)};
+		vector<ModelQuery> model_queries = {ModelQuery("1", variants[0])};
+		ProcessQueries process_queries(model_queries, cohort, db_opts, admin, grader);
+		cohort_latencies.push_back(milliseconds_since(start));
+	}
+
+	// the practice grader, with the submissions of the threads graded at the same time
+	PracticeGrader practice(quiz, threads);
+	std::vector<double> practice_latencies(threads * submissions);
+	std::vector<std::thread> workers;
+	for (std::size_t t = 0; t < threads; t++)
+	{
+		workers.emplace_back([&, t]()
+							 {
+			for (std::size_t i = 0; i < submissions; i++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				practice.grade(StudentQuery(std::to_string(t * submissions + i), variants[(t + i) % variants.size()], "Q1", 1));
+				practice_latencies[t * submissions + i] = milliseconds_since(start);
+			} });
+	}
+	for (auto &worker : workers)
+	{
+		worker.join();
+	}
+
+	auto cohort = percentiles(cohort_latencies);
+	auto warm = percentiles(practice_latencies);
+	std::cout << "cohort of one, 1 thread: p50 " << cohort.first << " ms, p99 " << cohort.second << " ms" << std::endl;
+	std::cout << "practice grader, " << threads << " threads: p50 " << warm.first << " ms, p99 " << warm.second << " ms, "
+			  << practice.bank_size() << " correct answers in the bank" << std::endl;
+	BOOST_TEST(warm.second < 50.0);
+}
 BOOST_AUTO_TEST_SUITE_END()
 /**
  * This grading suite is used to test 8 magnitude grading of queries.
@@ -3601,9 +4931,8 @@ BOOST_AUTO_TEST_CASE(test_case_1)
 	TreeEditDistance tree_edit_distance;
 
 	int edit_distance = tree_edit_distance.zhang_shasha(tree_a, tree_b);
-	AbstractSyntaxTree ast;
 	// print_tree(tree_a);
-	// ast.print_tree(tree_b);
+	// AbstractSyntaxTree::print_tree(tree_b);
 
 	BOOST_CHECK_EQUAL(edit_distance, 1);
 }
@@ -3623,9 +4952,8 @@ BOOST_AUTO_TEST_CASE(test_case_2)
 	TreeEditDistance tree_edit_distance;
 
 	int edit_distance = tree_edit_distance.zhang_shasha(tree_a, tree_b);
-	AbstractSyntaxTree ast;
-	// ast.print_tree(tree_a);
-	// ast.print_tree(tree_b);
+	// AbstractSyntaxTree::print_tree(tree_a);
+	// AbstractSyntaxTree::print_tree(tree_b);
 
 	BOOST_CHECK_EQUAL(edit_distance, 4);
 }
@@ -3834,6 +5162,303 @@ BOOST_AUTO_TEST_CASE(test_case_2)
 	BOOST_TEST(output.size() == 3);
 	qe.clear();
 }
+/**
+ * A script runs once: its database is cached by the hash of the script, shared by the engines of the script and
+ * evicted when the cached databases are over the budget.
+ */
+BOOST_AUTO_TEST_CASE(test_case_3)
+{
+	std::string artists = "CREATE TABLE Artist(artist_id INT, name TEXT, PRIMARY KEY(artist_id));"
+						  "INSERT INTO Artist VALUES (1, 'John Lennon'), (2, 'Paul McCartney');";
+	std::string albums = "CREATE TABLE Album(album_id INT, title TEXT, PRIMARY KEY(album_id));"
+						 "INSERT INTO Album VALUES (1, 'Abbey Road');";
+	DatabaseCache cache;
+	auto first = cache.find_or_load(artists);
+	BOOST_CHECK(cache.find_or_load(artists) == first);
+	BOOST_CHECK_THROW(cache.find_or_load("CREATE TABLE;"), std::runtime_error);
+	DatabaseCache::stats stats = cache.statistics();
+	BOOST_CHECK_EQUAL(stats.hits, 1);
+	BOOST_CHECK_EQUAL(stats.misses, 2);
+	BOOST_CHECK_EQUAL(stats.entries, 1);
+	BOOST_CHECK_EQUAL(stats.bytes, first->bytes + artists.size());
+
+	// the least recently used database is evicted, the engines that use it keep it
+	cache.set_budget(stats.bytes);
+	cache.find_or_load(albums);
+	stats = cache.statistics();
+	BOOST_CHECK_EQUAL(stats.entries, 1);
+	BOOST_CHECK_EQUAL(stats.evictions, 1);
+	BOOST_CHECK(cache.find_or_load(artists) != first);
+
+	// the changes of a graded query are rolled back, so an engine never sees the queries of another
+	Admin::database_options db_opts = {artists, 0, 0, "", "", "", true, false};
+	Query_Engine qe_1(db_opts);
+	qe_1.initialize();
+	Query_Engine qe_2(db_opts);
+	qe_2.initialize();
+	std::string error;
+	auto diff = qe_1.execute_non_select("INSERT INTO Artist VALUES (3, 'George Harrison');", error);
+	BOOST_CHECK(error.empty());
+	BOOST_CHECK_EQUAL(diff.size(), 1);
+	BOOST_CHECK_EQUAL(qe_2.execute_select("SELECT * FROM Artist;").size(), 2);
+	BOOST_CHECK_EQUAL(qe_1.execute_select("SELECT * FROM Artist;").size(), 2);
+}
+/**
+ * The script loader fills the tables of the sample databases as running their scripts does. The INSERT statements it
+ * cannot append run as they are: a typed literal, a decimal into an integer column and a SELECT.
+ */
+BOOST_AUTO_TEST_CASE(test_case_4)
+{
+	auto table_rows = [](duckdb::Connection &con)
+	{
+		std::vector<std::string> rows;
+		auto tables = con.Query("SELECT table_name FROM information_schema.tables ORDER BY table_name;");
+		for (idx_t t = 0; t < tables->RowCount(); t++)
+		{
+			std::string table = tables->GetValue(0, t).ToString();
+			auto result = con.Query("SELECT * FROM \"" + table + "\" ORDER BY ALL;");
+			for (idx_t row = 0; row < result->RowCount(); row++)
+			{
+				std::string line = table;
+				for (idx_t column = 0; column < result->ColumnCount(); column++)
+					line += "|" + result->GetValue(column, row).ToString();
+				rows.push_back(line);
+			}
+		}
+		return rows;
+	};
+	std::string mixed = "CREATE TABLE t(id INT PRIMARY KEY, amount NUMERIC(6, 2), day DATE, note TEXT);"
+						"INSERT INTO t VALUES (1, 2.50, '2024-01-31', 'a'), (2, -3, NULL, 'b');"
+						"INSERT INTO t (note, id) VALUES ('c', 3);"
+						"INSERT INTO t VALUES (4, 1, DATE '2024-02-01', 'd');"
+						"INSERT INTO t (id, note) VALUES (5.6, 'e');"
+						"INSERT INTO t SELECT id + 10, amount, day, note FROM t WHERE id < 3;"
+						"INSERT INTO t VALUES (7, 7.25, '2024-03-01', 'f');";
+	std::vector<std::string> scripts = {mixed};
+	for (const std::string file : {"../samples/discography.sql", "../samples/employees.sql", "../samples/journal.sql", "../samples/test_tables.sql"})
+	{
+		std::ifstream input(file);
+		std::stringstream buffer;
+		buffer << input.rdbuf();
+		scripts.push_back(buffer.str());
+	}
+	for (const auto &script : scripts)
+	{
+		duckdb::DuckDB loaded_db(nullptr), executed_db(nullptr);
+		duckdb::Connection loaded(loaded_db), executed(executed_db);
+		ScriptLoader::report report = ScriptLoader::run(loaded, script);
+		BOOST_REQUIRE(!executed.Query(script)->HasError());
+		BOOST_CHECK(report.appended > 0);
+		BOOST_CHECK(table_rows(loaded) == table_rows(executed));
+	}
+
+	duckdb::DuckDB db(nullptr);
+	duckdb::Connection con(db);
+	ScriptLoader::report report = ScriptLoader::run(con, mixed);
+	BOOST_CHECK_EQUAL(report.statements, 7);
+	BOOST_CHECK_EQUAL(report.appended, 3);
+	BOOST_CHECK_EQUAL(report.rows, 4);
+	BOOST_CHECK_EQUAL(report.executed, 4);
+	// a failing statement fails the load as it fails the script
+	BOOST_CHECK_THROW(ScriptLoader::run(con, "INSERT INTO t VALUES (1, 1, NULL, 'again');"), std::runtime_error);
+}
+/**
+ * The tables of a dataset are loaded from their files after the script: into the table the script created, by the
+ * names of the columns, or into a new table. A file that is replaced is loaded again.
+ */
+BOOST_AUTO_TEST_CASE(test_case_5)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "socoles_dataset_test";
+	std::filesystem::create_directories(directory);
+	std::string albums = (directory / "albums.csv").string();
+	std::string genres = (directory / "genres.csv").string();
+	std::ofstream(albums) << "title,id\nAbbey Road,1\nLet It Be,2\nRevolver,3\n";
+	std::ofstream(genres) << "id,name\n1,Rock\n2,Pop\n";
+	std::vector<Admin::dataset_table> tables = {{"album", albums, Admin::dataset_format::CSV},
+												 {"genre", genres, Admin::dataset_format::CSV}};
+
+	duckdb::DuckDB db(nullptr);
+	duckdb::Connection con(db);
+	ScriptLoader::run(con, "CREATE TABLE Album(id INT PRIMARY KEY, title TEXT);");
+	BOOST_CHECK_EQUAL(ScriptLoader::load_tables(con, tables), 5);
+	BOOST_CHECK_EQUAL(con.Query("SELECT title FROM Album WHERE id = 2;")->GetValue(0, 0).ToString(), "Let It Be");
+	BOOST_CHECK_EQUAL(con.Query("SELECT COUNT(*) FROM genre;")->GetValue(0, 0).GetValue<int64_t>(), 2);
+	BOOST_CHECK_THROW(ScriptLoader::load_tables(con, {{"album", (directory / "none.csv").string(), Admin::dataset_format::CSV}}), std::runtime_error);
+
+	DatabaseCache cache;
+	std::string script = "CREATE TABLE Album(id INT PRIMARY KEY, title TEXT);";
+	auto first = cache.find_or_load(script, tables);
+	BOOST_CHECK(cache.find_or_load(script, tables) == first);
+	BOOST_CHECK(cache.find_or_load(script) != first);
+	std::ofstream(genres) << "id,name\n1,Rock\n2,Pop\n3,Jazz\n";
+	auto replaced = cache.find_or_load(script, tables);
+	BOOST_CHECK(replaced != first);
+	duckdb::Connection replaced_con(replaced->db);
+	BOOST_CHECK_EQUAL(replaced_con.Query("SELECT COUNT(*) FROM genre;")->GetValue(0, 0).GetValue<int64_t>(), 3);
+
+	std::filesystem::remove_all(directory);
+}
+/**
+ * The databases are made with the threads and the memory of the resource policy. A script is loaded with the parallel
+ * threads, the graded queries run on the threads of the policy whatever the size of the database.
+ */
+BOOST_AUTO_TEST_CASE(test_case_6)
+{
+	DatabaseCache cache;
+	DatabaseCache::resource_policy resources;
+	resources.threads = 0;
+	resources.parallel_threads = 2;
+	resources.memory_limit = "1GB";
+	cache.set_policy(resources);
+	BOOST_CHECK_EQUAL(cache.policy().threads, 1);
+
+	std::string script = "CREATE TABLE Artist(id INT PRIMARY KEY, name TEXT); INSERT INTO Artist VALUES (1, 'John Lennon');";
+	auto threads = [](DatabaseCache::entry &database)
+	{
+		duckdb::Connection con(database.db);
+		return con.Query("SELECT current_setting('threads');")->GetValue(0, 0).GetValue<int64_t>();
+	};
+	auto small = cache.find_or_load(script);
+	BOOST_CHECK_EQUAL(small->threads, 1);
+	BOOST_CHECK_EQUAL(threads(*small), 1);
+	std::string large_script = "CREATE TABLE sales AS SELECT i AS id, random() AS amount FROM range(1000000) r(i);";
+	auto large = cache.find_or_load(large_script);
+	BOOST_CHECK_EQUAL(large->threads, 1);
+	BOOST_CHECK_EQUAL(threads(*large), 1);
+
+	// the policy only applies to the databases made after it
+	resources.threads = 2;
+	cache.set_policy(resources);
+	BOOST_CHECK(cache.find_or_load(script) == small);
+	auto other = cache.find_or_load(script + " INSERT INTO Artist VALUES (2, 'Paul McCartney');");
+	BOOST_CHECK_EQUAL(other->threads, 2);
+	BOOST_CHECK_EQUAL(threads(*other), 2);
+
+	resources.memory_limit = "plenty";
+	cache.set_policy(resources);
+	BOOST_CHECK_THROW(cache.find_or_load("CREATE TABLE Album(id INT);"), std::exception);
+}
+/**
+ * A cached database is only found for its own script. The statements whose effect outlives the rolled back
+ * transaction are refused on it and it reads no files, so a grading does not change the database of the next one.
+ */
+BOOST_AUTO_TEST_CASE(test_case_7)
+{
+	DatabaseCache cache;
+	std::string script = "CREATE TABLE Artist(id INT PRIMARY KEY, name TEXT); INSERT INTO Artist VALUES (1, 'John Lennon');";
+	auto database = cache.find_or_load(script);
+	BOOST_CHECK(cache.find_or_load(script) == database);
+	BOOST_CHECK(cache.find_or_load(script, {}, DatasetStore::sha256(script)) == database);
+	BOOST_CHECK(cache.find_or_load(script + " ") != database);
+
+	MyDuckDB engine(database);
+	for (const std::string query : {"SET threads = 8;", "SET VARIABLE x = 1;", "PRAGMA disable_optimizer;", "CHECKPOINT;",
+									"ATTACH ':memory:' AS other;", "INSTALL httpfs;", "END; SELECT 1;",
+									"COPY Artist TO 'artist.csv';"})
+	{
+		std::string error;
+		engine.execute_query_select(query, error);
+		BOOST_CHECK_MESSAGE(!error.empty(), query);
+		error.clear();
+		engine.execute_query_not_select(query, error);
+		BOOST_CHECK_MESSAGE(!error.empty(), query);
+	}
+	std::string error;
+	engine.execute_query_select("SELECT * FROM read_csv('../samples/test_tables.sql');", error);
+	BOOST_CHECK(!error.empty());
+
+	error.clear();
+	BOOST_CHECK_EQUAL(engine.execute_query_select("SELECT current_setting('threads');", error)[0][0], "1");
+	BOOST_CHECK_EQUAL(engine.execute_query_select("SELECT name FROM Artist;", error).size(), 1);
+	BOOST_CHECK(error.empty());
+}
+BOOST_AUTO_TEST_SUITE_END()
+//---------------------------------------------------------------------------
+// Benchmark of the script loader against running the script, on the sample databases 100 times over, run with
+// --run_test=script_loader_benchmarks. Each copy of a sample is created in a schema of its own.
+//---------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE(script_loader_benchmarks, *boost::unit_test::disabled())
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	const int copies = 100;
+	const std::regex table_names(R"(\b(CREATE TABLE|INSERT INTO|REFERENCES)\s+(\w+))", std::regex::icase);
+	for (const std::string file : {"../samples/discography.sql", "../samples/employees.sql", "../samples/journal.sql", "../samples/test_tables.sql"})
+	{
+		std::ifstream input(file);
+		std::stringstream buffer;
+		buffer << input.rdbuf();
+		std::string script;
+		for (int copy = 0; copy < copies; copy++)
+		{
+			std::string schema = "copy_" + std::to_string(copy);
+			script += "CREATE SCHEMA " + schema + ";\n" + std::regex_replace(buffer.str(), table_names, "$1 " + schema + ".$2") + "\n";
+		}
+
+		auto milliseconds = [](const std::function<void()> &load)
+		{
+			auto start = std::chrono::steady_clock::now();
+			load();
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		};
+		ScriptLoader::report report;
+		double executed = milliseconds([&]()
+									   {
+			duckdb::DuckDB db(nullptr);
+			duckdb::Connection con(db);
+			BOOST_REQUIRE(!con.Query(script)->HasError()); });
+		double loaded = milliseconds([&]()
+									 {
+			duckdb::DuckDB db(nullptr);
+			duckdb::Connection con(db);
+			report = ScriptLoader::run(con, script); });
+		std::cout << file << " x" << copies << ": " << report.statements << " statements, " << report.appended << " appended ("
+				  << report.rows << " rows), executed " << executed << " ms, loaded " << loaded << " ms" << std::endl;
+	}
+}
+BOOST_AUTO_TEST_SUITE_END()
+//---------------------------------------------------------------------------
+// Benchmark of the split of the cores between the graders and DuckDB, run with --run_test=duckdb_thread_benchmarks.
+// The queries run on a pool of graders, each query on DuckDB threads, so that the graders times the DuckDB threads
+// are the cores of the machine. The small queries are those of students, the large ones aggregate a large table.
+//---------------------------------------------------------------------------
+BOOST_AUTO_TEST_SUITE(duckdb_thread_benchmarks, *boost::unit_test::disabled())
+BOOST_AUTO_TEST_CASE(test_case_1)
+{
+	const std::size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+	const std::string script = "CREATE TABLE sales AS SELECT i AS id, i % 1000 AS shop, random() AS amount FROM range(5000000) r(i);"
+							   "CREATE TABLE shops AS SELECT DISTINCT shop AS id FROM sales;";
+	const std::vector<std::pair<std::string, std::string>> workloads = {
+		{"small", "SELECT id FROM shops WHERE id % 7 = 0 ORDER BY id;"},
+		{"large", "SELECT shop, AVG(amount), COUNT(*) FROM sales GROUP BY shop ORDER BY shop;"}};
+	const std::size_t queries = 64;
+	for (std::size_t graders = 1; graders <= cores; graders *= 2)
+	{
+		std::size_t duckdb_threads = std::max<std::size_t>(cores / graders, 1);
+		DatabaseCache cache;
+		DatabaseCache::resource_policy resources;
+		resources.threads = duckdb_threads;
+		resources.parallel_threads = duckdb_threads;
+		cache.set_policy(resources);
+		auto database = cache.find_or_load(script);
+		for (const auto &[name, query] : workloads)
+		{
+			ThreadPool pool(graders);
+			auto start = std::chrono::steady_clock::now();
+			for (std::size_t i = 0; i < queries; i++)
+			{
+				pool.enqueue([&database, &query]()
+							 {
+					MyDuckDB engine(database);
+					std::string error;
+					engine.execute_query_select(query, error); });
+			}
+			pool.wait_until_empty();
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			std::cout << graders << " graders x " << duckdb_threads << " DuckDB threads, " << name << " queries: "
+					  << queries / seconds << " queries/s" << std::endl;
+		}
+	}
+}
 BOOST_AUTO_TEST_SUITE_END()
 /*********************************************************************************************************************************************************/ /**
 																																							 * Test suite for generating test table data when given a refernce query
@@ -3895,7 +5520,6 @@ bool operator==(const Goals::Goal &lhs, const Goals::Goal &rhs)
 BOOST_AUTO_TEST_SUITE(feedback)
 BOOST_AUTO_TEST_CASE(test_case_1)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 
@@ -3906,8 +5530,8 @@ BOOST_AUTO_TEST_CASE(test_case_1)
 	model_query_2.create_abstract_syntax_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node1 = model_query.get_parse_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node2 = model_query_2.get_parse_tree();
-	// ast.print_tree(tree_m);
-	// ast.print_tree(tree_m_2);
+	// AbstractSyntaxTree::print_tree(tree_m);
+	// AbstractSyntaxTree::print_tree(tree_m_2);
 	//  Generate goals for both queries
 	// std::vector<Goals::Goal> goals1 = goals.generate_query_goals(root_node1);
 	// std::vector<Goals::Goal> goals2 = goals.generate_query_goals(root_node2);
@@ -3935,7 +5559,6 @@ BOOST_AUTO_TEST_CASE(test_case_1)
 }
 BOOST_AUTO_TEST_CASE(test_case_2)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 	/**
@@ -3949,8 +5572,8 @@ BOOST_AUTO_TEST_CASE(test_case_2)
 	model_query_2.create_abstract_syntax_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node1 = model_query.get_parse_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node2 = model_query_2.get_parse_tree();
-	// ast.print_tree(tree_m);
-	// ast.print_tree(tree_m_2);
+	// AbstractSyntaxTree::print_tree(tree_m);
+	// AbstractSyntaxTree::print_tree(tree_m_2);
 
 	// first process from clause to generate table info
 	std::pair<std::string, From_clause::from_clause_info> from_goal = From_clause::process(root_node1);
@@ -3975,7 +5598,6 @@ BOOST_AUTO_TEST_CASE(test_case_2)
 }
 BOOST_AUTO_TEST_CASE(test_case_3)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 	ModelQuery model_query("1", "SELECT name2 FROM artist;");
@@ -3985,8 +5607,8 @@ BOOST_AUTO_TEST_CASE(test_case_3)
 	model_query_2.create_abstract_syntax_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node1 = model_query.get_parse_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node2 = model_query_2.get_parse_tree();
-	// ast.print_tree(tree_m);
-	// ast.print_tree(tree_m_2);
+	// AbstractSyntaxTree::print_tree(tree_m);
+	// AbstractSyntaxTree::print_tree(tree_m_2);
 
 	// first process from clause to generate table info
 	std::pair<std::string, From_clause::from_clause_info> from_goal = From_clause::process(root_node1);
@@ -4011,7 +5633,6 @@ BOOST_AUTO_TEST_CASE(test_case_3)
 }
 BOOST_AUTO_TEST_CASE(test_case_4)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 	ModelQuery model_query("1", "SELECT name as a FROM artist;");
@@ -4021,8 +5642,8 @@ BOOST_AUTO_TEST_CASE(test_case_4)
 	model_query_2.create_abstract_syntax_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node1 = model_query.get_parse_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node2 = model_query_2.get_parse_tree();
-	// ast.print_tree(root_node1);
-	// ast.print_tree(tree_m_2);
+	// AbstractSyntaxTree::print_tree(root_node1);
+	// AbstractSyntaxTree::print_tree(tree_m_2);
 	//  Generate goals for both queries
 	// std::vector<Goals::Goal> goals1 = goals.generate_query_goals(root_node1);
 	// std::vector<Goals::Goal> goals2 = goals.generate_query_goals(root_node2);
@@ -4049,7 +5670,6 @@ BOOST_AUTO_TEST_CASE(test_case_4)
 }
 BOOST_AUTO_TEST_CASE(test_case_5)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 	ModelQuery model_query("1", "SELECT A.name, COUNT(P.tracks_id) AS least3 FROM Artist A JOIN Performs P ON A.artist_id = P.artist_id");
@@ -4060,8 +5680,8 @@ BOOST_AUTO_TEST_CASE(test_case_5)
 	model_query_2.create_abstract_syntax_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node1 = model_query.get_parse_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node2 = model_query_2.get_parse_tree();
-	// ast.print_tree(root_node1);
-	// ast.print_tree(tree_m_2);
+	// AbstractSyntaxTree::print_tree(root_node1);
+	// AbstractSyntaxTree::print_tree(tree_m_2);
 	//  Generate goals for both queries
 	// std::vector<Goals::Goal> goals1 = goals.generate_query_goals(root_node1);
 	// std::vector<Goals::Goal> goals2 = goals.generate_query_goals(root_node2);
@@ -4088,7 +5708,6 @@ BOOST_AUTO_TEST_CASE(test_case_5)
 }
 BOOST_AUTO_TEST_CASE(test_case_6)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 
@@ -4100,8 +5719,8 @@ BOOST_AUTO_TEST_CASE(test_case_6)
 	model_query_2.create_abstract_syntax_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node1 = model_query.get_parse_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node2 = model_query_2.get_parse_tree();
-	// ast.print_tree(root_node1);
-	// ast.print_tree(tree_m_2);
+	// AbstractSyntaxTree::print_tree(root_node1);
+	// AbstractSyntaxTree::print_tree(tree_m_2);
 	//  Generate goals for both queries
 	// std::vector<Goals::Goal> goals1 = goals.generate_query_goals(root_node1);
 	// std::vector<Goals::Goal> goals2 = goals.generate_query_goals(root_node2);
@@ -4132,7 +5751,6 @@ BOOST_AUTO_TEST_CASE(test_case_6)
  */
 BOOST_AUTO_TEST_CASE(test_case_7)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 	ModelQuery model_query("1", "SELECT COUNT(P.tracks_id) AS least3, A.name FROM Performs P JOIN Artist A ON A.track_id = P.artist_id");
@@ -4168,7 +5786,6 @@ BOOST_AUTO_TEST_CASE(test_case_7)
 }
 BOOST_AUTO_TEST_CASE(test_case_8)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 
@@ -4180,8 +5797,8 @@ BOOST_AUTO_TEST_CASE(test_case_8)
 	model_query_2.create_abstract_syntax_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node1 = model_query.get_parse_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node2 = model_query_2.get_parse_tree();
-	// ast.print_tree(root_node1);
-	// ast.print_tree(tree_m_2);
+	// AbstractSyntaxTree::print_tree(root_node1);
+	// AbstractSyntaxTree::print_tree(tree_m_2);
 	//  Generate goals for both queries
 	// std::vector<Goals::Goal> goals1 = goals.generate_query_goals(root_node1);
 	// std::vector<Goals::Goal> goals2 = goals.generate_query_goals(root_node2);
@@ -4220,7 +5837,6 @@ BOOST_AUTO_TEST_CASE(test_case_8)
 }
 BOOST_AUTO_TEST_CASE(test_case_9)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 
@@ -4261,7 +5877,6 @@ BOOST_AUTO_TEST_CASE(test_case_9)
 }
 BOOST_AUTO_TEST_CASE(test_case_11)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 
@@ -4298,7 +5913,6 @@ BOOST_AUTO_TEST_CASE(test_case_11)
 }
 BOOST_AUTO_TEST_CASE(test_case_12)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 
@@ -4339,7 +5953,6 @@ BOOST_AUTO_TEST_CASE(test_case_12)
 }
 BOOST_AUTO_TEST_CASE(test_case_13)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 
@@ -4380,7 +5993,6 @@ BOOST_AUTO_TEST_CASE(test_case_13)
 }
 BOOST_AUTO_TEST_CASE(test_case_14)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 
@@ -4421,7 +6033,6 @@ BOOST_AUTO_TEST_CASE(test_case_14)
 }
 BOOST_AUTO_TEST_CASE(test_case_15)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 
@@ -4436,7 +6047,7 @@ BOOST_AUTO_TEST_CASE(test_case_15)
 	model_query_2.create_abstract_syntax_tree();
 	auto root_node1 = model_query.get_parse_tree();
 	auto root_node2 = model_query_2.get_parse_tree();
-	// ast.print_tree(root_node1);
+	// AbstractSyntaxTree::print_tree(root_node1);
 
 	// Process FROM clause
 	auto from_goal = From_clause::process(root_node1);
@@ -4462,7 +6073,6 @@ BOOST_AUTO_TEST_CASE(test_case_15)
 }
 BOOST_AUTO_TEST_CASE(test_case_16)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 
@@ -4512,7 +6122,6 @@ BOOST_AUTO_TEST_CASE(test_case_16)
 }
 BOOST_AUTO_TEST_CASE(test_case_17)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 
@@ -4558,7 +6167,6 @@ BOOST_AUTO_TEST_CASE(test_case_17)
 }
 BOOST_AUTO_TEST_CASE(test_case_18)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 
 	// Original Query 1: Simple GROUP BY clause with two columns
@@ -4721,7 +6329,7 @@ BOOST_AUTO_TEST_CASE(test_case_18)
 	auto root_node3 = model_query_3.get_parse_tree();
 	auto root_node3a = model_query_3a.get_parse_tree();
 	auto root_node3b = model_query_3b.get_parse_tree();
-	// ast.print_tree(root_node3);
+	// AbstractSyntaxTree::print_tree(root_node3);
 
 	// Process FROM clauses
 	auto from_goal3 = From_clause::process(root_node3);
@@ -4777,7 +6385,6 @@ BOOST_AUTO_TEST_CASE(test_case_18)
 BOOST_AUTO_TEST_CASE(test_case_19)
 {
 	// Initialize necessary objects
-	AbstractSyntaxTree ast;
 	Goals goals;
 
 	// --- Query Set 1: Basic ORDER BY with columns ---
@@ -5059,7 +6666,6 @@ BOOST_AUTO_TEST_CASE(test_case_19)
 }
 BOOST_AUTO_TEST_CASE(test_case_20)
 {
-	AbstractSyntaxTree ast;
 	Goals goals;
 	std::vector<std::string> next_steps;
 
@@ -5070,8 +6676,8 @@ BOOST_AUTO_TEST_CASE(test_case_20)
 	model_query_2.create_abstract_syntax_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node1 = model_query.get_parse_tree();
 	std::shared_ptr<AbstractSyntaxTree::AbstractSyntaxTree::Node> root_node2 = model_query_2.get_parse_tree();
-	// ast.print_tree(root_node1);
-	// ast.print_tree(root_node2);
+	// AbstractSyntaxTree::print_tree(root_node1);
+	// AbstractSyntaxTree::print_tree(root_node2);
 	//  Generate goals for both queries
 	// std::vector<Goals::Goal> goals1 = goals.generate_query_goals(root_node1);
 	// std::vector<Goals::Goal> goals2 = goals.generate_query_goals(root_node2);
@@ -5097,5 +6703,74 @@ BOOST_AUTO_TEST_CASE(test_case_20)
 	BOOST_CHECK_EQUAL(select_comparison.first, 0);
 	BOOST_CHECK_EQUAL(from_comparison.first, 1);
 }
+/**
+ * We check that comparing precompiled clause profiles gives the same feedback as comparing the parse trees.
+ */
+BOOST_AUTO_TEST_CASE(test_case_21)
+{
+	ModelQuery model_query("1", "SELECT a.name FROM artist a WHERE a.id > 3 ORDER BY a.name;");
+	ModelQuery model_query_2("2", "SELECT artist.name FROM artist WHERE artist.id >= 3;");
+
+	model_query.create_abstract_syntax_tree();
+	model_query_2.create_abstract_syntax_tree();
+	model_query.create_clause_profile();
+	model_query_2.create_clause_profile();
+
+	auto profile1 = model_query.get_clause_profile();
+	auto profile2 = model_query_2.get_clause_profile();
+	BOOST_REQUIRE(profile1);
+	BOOST_REQUIRE(profile2);
+	BOOST_REQUIRE_EQUAL(profile1->statements.size(), 1);
+	BOOST_CHECK(profile1->statements[0].kind == AbstractSyntaxTree::statement_kind::SELECT_STMT);
+	BOOST_CHECK(profile1->statements[0].where_info.condition_root != nullptr);
+	// the stored profile is reused rather than recompiled
+	BOOST_CHECK(model_query.get_clause_profile() == profile1);
+
+	auto from_profiles = Goals::compare_queries(*profile1, *profile2);
+	auto from_trees = Goals::compare_queries(model_query.get_parse_tree(), model_query_2.get_parse_tree());
+
+	BOOST_CHECK_EQUAL(from_profiles.message, from_trees.message);
+	BOOST_CHECK(from_profiles.correct_parts == from_trees.correct_parts);
+	BOOST_CHECK(from_profiles.incorrect_parts == from_trees.incorrect_parts);
+
+	// a profile without goals, as a student query has, shows the same goal when it is the reference
+	auto without_goals = Goals::compile_query_profile(model_query.get_parse_tree(), false);
+	BOOST_REQUIRE(without_goals);
+	BOOST_CHECK(without_goals->statements[0].goal.empty());
+	BOOST_CHECK(!profile1->statements[0].goal.empty());
+	BOOST_CHECK_EQUAL(Goals::compare_queries(*without_goals, *profile2).message, from_profiles.message);
+}
+/**
+ * We check that condition hashes ignore the order of AND/OR children and of commutative operands.
+ */
+BOOST_AUTO_TEST_CASE(test_case_22)
+{
+	using Condition = Where_clause::ConditionNode;
+	auto a_eq_1 = std::make_shared<Condition>("a", "=", "1");
+	auto one_eq_a = std::make_shared<Condition>("1", "=", "a");
+	auto b_lt_2 = std::make_shared<Condition>("b", "<", "2");
+	auto two_gt_b = std::make_shared<Condition>("2", ">", "b");
+	auto b_gt_2 = std::make_shared<Condition>("b", ">", "2");
+
+	BOOST_CHECK_EQUAL(a_eq_1->hash, one_eq_a->hash);
+	BOOST_CHECK_EQUAL(b_lt_2->hash, two_gt_b->hash);
+	BOOST_CHECK_NE(b_lt_2->hash, b_gt_2->hash);
+
+	auto and_1 = std::make_shared<Condition>(Where_clause::ConditionType::AND, std::vector<std::shared_ptr<Condition>>{a_eq_1, b_lt_2});
+	auto and_2 = std::make_shared<Condition>(Where_clause::ConditionType::AND, std::vector<std::shared_ptr<Condition>>{two_gt_b, one_eq_a});
+	auto or_1 = std::make_shared<Condition>(Where_clause::ConditionType::OR, std::vector<std::shared_ptr<Condition>>{a_eq_1, b_lt_2});
+	auto and_3 = std::make_shared<Condition>(Where_clause::ConditionType::AND, std::vector<std::shared_ptr<Condition>>{a_eq_1, a_eq_1});
+	auto and_4 = std::make_shared<Condition>(Where_clause::ConditionType::AND, std::vector<std::shared_ptr<Condition>>{b_lt_2, b_lt_2});
+
+	BOOST_CHECK_EQUAL(and_1->hash, and_2->hash);
+	BOOST_CHECK_NE(and_1->hash, or_1->hash);
+	BOOST_CHECK_NE(and_3->hash, and_4->hash);
+
+	std::string message;
+	BOOST_CHECK(Where_clause::compare_condition_nodes(and_1, and_2, message));
+	BOOST_CHECK(message.empty());
+	BOOST_CHECK(!Where_clause::compare_condition_nodes(and_1, and_3, message));
+	BOOST_CHECK(!message.empty());
+}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,9 @@
 #include <set>
 #include <unordered_set>
 #include <climits>
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
 
 /*
  * Helper function to perform the post - order traversal.
@@ -208,11 +211,10 @@ int TreeEditDistance::zhang_shasha(const std::shared_ptr<AbstractSyntaxTree::Nod
 	std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> postorder1 = post_order_traversal(tree1);
 	std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> postorder2 = post_order_traversal(tree2);
 
-	// find the leftmost descendants of the trees
-	auto leftmost_descendants1 = find_leftmost_leaf_descendants(tree1);
-	auto leftmost_descendants2 = find_leftmost_leaf_descendants(tree2);
+	// find the postorder index of the leftmost leaf descendant of every node
+	auto leftmost1 = leftmost_leaf_indexes(postorder1);
+	auto leftmost2 = leftmost_leaf_indexes(postorder2);
 	// this is a matrix containing all combinations of postorder lists for both trees.
-	// we add two cells for empty nodes
 	std::vector<std::vector<int>> tree_dist(postorder1.size(), std::vector<int>(postorder2.size(), 0));
 	// get the indices of the left most nodes in the postorder traversal list
 	auto lr_keyroots1 = find_lr_keyroots_index(postorder1);
@@ -224,45 +226,31 @@ int TreeEditDistance::zhang_shasha(const std::shared_ptr<AbstractSyntaxTree::Nod
 		{
 			size_t i = lr_keyroots1[i_prime];
 			size_t j = lr_keyroots2[j_prime];
-			compute_forest_distance(postorder1, postorder2, i, j, tree_dist);
+			compute_forest_distance(postorder1, postorder2, leftmost1, leftmost2, i, j, tree_dist);
 		}
 	}
 	return tree_dist[postorder1.size() - 1][postorder2.size() - 1];
 }
-void TreeEditDistance::compute_forest_distance(const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> &postorder1, const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> &postorder2, const size_t i, const size_t j, std::vector<std::vector<int>> &tree_dist)
+std::vector<size_t> TreeEditDistance::leftmost_leaf_indexes(const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> &postorder)
 {
-	// find the index leftmost descendant of the node at i
-	std::shared_ptr<AbstractSyntaxTree::Node> l_i_node = find_single_leftmost_leaf_descendant(postorder1.at(i));
-	size_t l_i_index = -1;
-	for (size_t index = 0; index < postorder1.size(); index++)
+	std::unordered_map<const AbstractSyntaxTree::Node *, size_t> index;
+	for (size_t k = 0; k < postorder.size(); k++)
 	{
-		if (postorder1.at(index) == l_i_node)
-		{
-			l_i_index = index;
-			break;
-		}
-	}
-	if (l_i_index == -1)
-	{
-		std::cerr << "l_i_index not found." << std::endl;
-		exit(1);
-	}
-	// find the index leftmost descendant of the node at j
-	std::shared_ptr<AbstractSyntaxTree::Node> l_j_node = find_single_leftmost_leaf_descendant(postorder2.at(j));
-	size_t l_j_index = -1;
-	for (size_t index = 0; index < postorder2.size(); index++)
-	{
-		if (postorder2.at(index) == l_j_node)
-		{
-			l_j_index = index;
-			break;
-		}
+		index[postorder[k].get()] = k;
 	}
-	if (l_j_index == -1)
+	std::vector<size_t> leftmost(postorder.size());
+	for (size_t k = 0; k < postorder.size(); k++)
 	{
-		std::cerr << "l_j_index not found." << std::endl;
-		exit(1);
+		// a leaf comes before its ancestors in the postorder, so its index is known
+		leftmost[k] = postorder[k]->children.empty() ? k : leftmost[index.at(postorder[k]->children.front().get())];
 	}
+	return leftmost;
+}
+void TreeEditDistance::compute_forest_distance(const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> &postorder1, const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>> &postorder2,
+											   const std::vector<size_t> &leftmost1, const std::vector<size_t> &leftmost2, const size_t i, const size_t j, std::vector<std::vector<int>> &tree_dist)
+{
+	size_t l_i_index = leftmost1[i];
+	size_t l_j_index = leftmost2[j];
 	// lets create a matrix that holds the single tree from l(i) to i and l(j) to j elements including space for empty cells
 	size_t bound_1 = i - l_i_index + 2;
 	size_t bound_2 = j - l_j_index + 2;
@@ -280,26 +268,335 @@ void TreeEditDistance::compute_forest_distance(const std::vector<std::shared_ptr
 	{
 		for (size_t j1 = l_j_index, l = 1; j1 <= j; j1++, l++)
 		{
-			if (find_single_leftmost_leaf_descendant(postorder1.at(i1)) == find_single_leftmost_leaf_descendant(postorder1.at(i)) &&
-				find_single_leftmost_leaf_descendant(postorder2.at(j1)) == find_single_leftmost_leaf_descendant(postorder2.at(j)))
+			int delete_cost = forest_dist[k - 1][l] + edit_weight(postorder1[i1], nullptr);
+			int insert_cost = forest_dist[k][l - 1] + edit_weight(nullptr, postorder2[j1]);
+			if (leftmost1[i1] == l_i_index && leftmost2[j1] == l_j_index)
 			{
-				int delete_cost = forest_dist[k - 1][l] + edit_weight(postorder1[i1], nullptr);
-				int insert_cost = forest_dist[k][l - 1] + edit_weight(nullptr, postorder2[j1]);
+				// both forests are whole trees, the roots are matched with each other
 				int substitute_cost = forest_dist[k - 1][l - 1] + edit_weight(postorder1[i1], postorder2[j1]);
-
 				forest_dist[k][l] = std::min({delete_cost, insert_cost, substitute_cost});
 				tree_dist[i1][j1] = forest_dist[k][l];
 			}
 			else
 			{
-				int delete_cost = forest_dist[k - 1][l] + edit_weight(postorder1[i1], nullptr);
-				int insert_cost = forest_dist[k][l - 1] + edit_weight(nullptr, postorder2[j1]);
-				int substitute_cost = forest_dist[k - 1][l - 1] + edit_weight(postorder1[i1], postorder2[j1]);
+				// the subtrees of i1 and j1 are matched with each other, at their distance computed by an earlier keyroot
+				int subtree_cost = forest_dist[leftmost1[i1] - l_i_index][leftmost2[j1] - l_j_index] + tree_dist[i1][j1];
+				forest_dist[k][l] = std::min({delete_cost, insert_cost, subtree_cost});
+			}
+		}
+	}
+}
+namespace
+{
+	/**
+	 * A postorder of a tree as used by a path decomposition. In the left view the children are visited from left to
+	 * right and every node points to its leftmost leaf descendant, in the right view the children are visited from
+	 * right to left and every node points to its rightmost leaf descendant.
+	 */
+	struct tree_view
+	{
+		std::vector<int> node;	   // the id of the node at each postorder position
+		std::vector<int> position; // the postorder position of each node id
+		std::vector<int> leaf;	   // the position of the outermost leaf descendant of the node at each position
+		std::vector<bool> keyroot; // whether the node at each position is the root or not the first child of its parent
+	};
+	/**
+	 * A tree flattened into arrays, the node ids are the preorder positions.
+	 */
+	struct indexed_tree
+	{
+		std::vector<int> label; // the interned key and value of each node
+		std::vector<int> size;	// the number of nodes in the subtree of each node
+		std::vector<std::vector<int>> children;
+		std::vector<std::uint64_t> left_subforests;	 // the number of subforests of each subtree in the full left decomposition
+		std::vector<std::uint64_t> right_subforests; // the number of subforests of each subtree in the full right decomposition
+		tree_view left;
+		tree_view right;
 
-				forest_dist[k][l] = std::min({delete_cost, insert_cost, substitute_cost});
+		indexed_tree(const std::shared_ptr<AbstractSyntaxTree::Node> &root, std::unordered_map<std::string, int> &labels)
+		{
+			// preorder ids
+			std::vector<std::pair<std::shared_ptr<AbstractSyntaxTree::Node>, int>> stack = {{root, -1}};
+			while (!stack.empty())
+			{
+				auto [node, parent] = stack.back();
+				stack.pop_back();
+				int id = static_cast<int>(label.size());
+				auto inserted = labels.emplace(node->key + '\0' + node->value, static_cast<int>(labels.size()));
+				label.push_back(inserted.first->second);
+				children.emplace_back();
+				if (parent >= 0)
+				{
+					children[parent].push_back(id);
+				}
+				for (auto it = node->children.rbegin(); it != node->children.rend(); ++it)
+				{
+					stack.push_back({*it, id});
+				}
+			}
+			// in preorder the descendants of a node come after it, so sizes are summed from the back
+			size.assign(label.size(), 1);
+			left_subforests.assign(label.size(), 0);
+			right_subforests.assign(label.size(), 0);
+			for (int id = static_cast<int>(label.size()) - 1; id >= 0; id--)
+			{
+				for (int child : children[id])
+				{
+					size[id] += size[child];
+				}
+				// a subtree adds its own subforests and those of the subtrees that are not on its left (right) path
+				left_subforests[id] = size[id];
+				right_subforests[id] = size[id];
+				for (int child : children[id])
+				{
+					left_subforests[id] += left_subforests[child] - (child == children[id].front() ? size[child] : 0);
+					right_subforests[id] += right_subforests[child] - (child == children[id].back() ? size[child] : 0);
+				}
+			}
+			make_view(left, false);
+			make_view(right, true);
+		}
+
+		void make_view(tree_view &view, bool mirrored)
+		{
+			view.position.assign(label.size(), 0);
+			view.leaf.assign(label.size(), 0);
+			view.keyroot.assign(label.size(), false);
+			// iterative postorder, a node is emitted once all its children are
+			std::vector<std::pair<int, std::size_t>> stack = {{0, 0}};
+			while (!stack.empty())
+			{
+				auto &[id, next] = stack.back();
+				if (next < children[id].size())
+				{
+					int child = mirrored ? children[id][children[id].size() - 1 - next] : children[id][next];
+					next++;
+					stack.push_back({child, 0});
+					continue;
+				}
+				int position = static_cast<int>(view.node.size());
+				view.node.push_back(id);
+				view.position[id] = position;
+				if (children[id].empty())
+				{
+					view.leaf[position] = position;
+				}
+				else
+				{
+					int first = mirrored ? children[id].back() : children[id].front();
+					view.leaf[position] = view.leaf[view.position[first]];
+				}
+				stack.pop_back();
+			}
+			view.keyroot[view.position[0]] = true;
+			for (std::size_t id = 0; id < children.size(); id++)
+			{
+				for (std::size_t i = 1; i < children[id].size(); i++)
+				{
+					int child = mirrored ? children[id][children[id].size() - 1 - i] : children[id][i];
+					view.keyroot[view.position[child]] = true;
+				}
+			}
+		}
+	};
+	/**
+	 * The tree edit distance computed with a path strategy. For every pair of subtrees, the strategy decomposes one of the
+	 * two subtrees along its left or its right path, whichever needs the fewest subproblems, see Pawlik & Augsten.
+	 * The subtrees that hang off the path are solved first, then a single path function fills the distances of the
+	 * subtrees on the path against all subtrees of the other tree.
+	 */
+	class path_strategy_distance
+	{
+	public:
+		path_strategy_distance(const indexed_tree &tree1, const indexed_tree &tree2)
+			: f(tree1), g(tree2), columns(tree2.label.size()),
+			  tree_dist(tree1.label.size() * tree2.label.size(), 0), strategy(tree1.label.size() * tree2.label.size(), 0)
+		{
+		}
+
+		int compute()
+		{
+			compute_strategy();
+			solve(0, 0);
+			return tree_dist[0];
+		}
+
+	private:
+		enum path : std::uint8_t
+		{
+			FIRST_LEFT,
+			FIRST_RIGHT,
+			SECOND_LEFT,
+			SECOND_RIGHT
+		};
+		const indexed_tree &f;
+		const indexed_tree &g;
+		std::size_t columns;
+		std::vector<int> tree_dist;		   // the distance between every pair of subtrees, by node ids
+		std::vector<std::uint8_t> strategy; // the path chosen for every pair of subtrees
+		std::vector<int> forest_dist;
+
+		/**
+		 * The cost of a pair of subtrees is the number of subproblems its decomposition solves, including those of the
+		 * subtrees off the path. The pairs are visited children first so the costs they depend on are known.
+		 */
+		void compute_strategy()
+		{
+			std::size_t cells = tree_dist.size();
+			std::vector<std::uint64_t> cost(cells), off_left_1(cells), off_right_1(cells), off_left_2(cells), off_right_2(cells);
+			for (int v = static_cast<int>(f.label.size()) - 1; v >= 0; v--)
+			{
+				for (int w = static_cast<int>(g.label.size()) - 1; w >= 0; w--)
+				{
+					std::size_t cell = v * columns + w;
+					if (!f.children[v].empty())
+					{
+						std::uint64_t all = 0;
+						for (int child : f.children[v])
+						{
+							all += cost[child * columns + w];
+						}
+						int first = f.children[v].front(), last = f.children[v].back();
+						off_left_1[cell] = off_left_1[first * columns + w] + all - cost[first * columns + w];
+						off_right_1[cell] = off_right_1[last * columns + w] + all - cost[last * columns + w];
+					}
+					if (!g.children[w].empty())
+					{
+						std::uint64_t all = 0;
+						for (int child : g.children[w])
+						{
+							all += cost[v * columns + child];
+						}
+						int first = g.children[w].front(), last = g.children[w].back();
+						off_left_2[cell] = off_left_2[v * columns + first] + all - cost[v * columns + first];
+						off_right_2[cell] = off_right_2[v * columns + last] + all - cost[v * columns + last];
+					}
+					std::uint64_t options[] = {
+						f.size[v] * g.left_subforests[w] + off_left_1[cell],
+						f.size[v] * g.right_subforests[w] + off_right_1[cell],
+						g.size[w] * f.left_subforests[v] + off_left_2[cell],
+						g.size[w] * f.right_subforests[v] + off_right_2[cell]};
+					std::uint8_t best = 0;
+					for (std::uint8_t option = 1; option < 4; option++)
+					{
+						if (options[option] < options[best])
+						{
+							best = option;
+						}
+					}
+					cost[cell] = options[best];
+					strategy[cell] = best;
+				}
 			}
 		}
+
+		/**
+		 * This function fills the distances between every subtree of v and every subtree of w.
+		 */
+		void solve(int v, int w)
+		{
+			path chosen = static_cast<path>(strategy[v * columns + w]);
+			bool on_first = chosen == FIRST_LEFT || chosen == FIRST_RIGHT;
+			bool is_left = chosen == FIRST_LEFT || chosen == SECOND_LEFT;
+			const indexed_tree &path_tree = on_first ? f : g;
+			// solve the subtrees that hang off the path
+			for (int node = on_first ? v : w; !path_tree.children[node].empty();)
+			{
+				const std::vector<int> &children = path_tree.children[node];
+				int next = is_left ? children.front() : children.back();
+				for (int child : children)
+				{
+					if (child != next)
+					{
+						on_first ? solve(child, w) : solve(v, child);
+					}
+				}
+				node = next;
+			}
+			// the single path function, the subtree on the path against every keyroot of the other subtree
+			const tree_view &view_1 = is_left ? f.left : f.right;
+			const tree_view &view_2 = is_left ? g.left : g.right;
+			int root_1 = view_1.position[v], root_2 = view_2.position[w];
+			if (on_first)
+			{
+				for (int j = view_2.leaf[root_2]; j <= root_2; j++)
+				{
+					if (view_2.keyroot[j] || j == root_2)
+					{
+						forest_distance(view_1, root_1, view_2, j);
+					}
+				}
+			}
+			else
+			{
+				for (int i = view_1.leaf[root_1]; i <= root_1; i++)
+				{
+					if (view_1.keyroot[i] || i == root_1)
+					{
+						forest_distance(view_1, i, view_2, root_2);
+					}
+				}
+			}
+		}
+
+		/**
+		 * The Zhang-Shasha forest distance of the subtrees at postorder positions i and j of two views of the same side.
+		 * It stores the distances of the subtrees on the outermost paths of both.
+		 */
+		void forest_distance(const tree_view &view_1, int i, const tree_view &view_2, int j)
+		{
+			int l_i = view_1.leaf[i], l_j = view_2.leaf[j];
+			std::size_t rows = i - l_i + 2, cols = j - l_j + 2;
+			forest_dist.assign(rows * cols, 0);
+			for (std::size_t a = 1; a < rows; a++)
+			{
+				forest_dist[a * cols] = static_cast<int>(a);
+			}
+			for (std::size_t b = 1; b < cols; b++)
+			{
+				forest_dist[b] = static_cast<int>(b);
+			}
+			for (int x = l_i, a = 1; x <= i; x++, a++)
+			{
+				int node_1 = view_1.node[x];
+				for (int y = l_j, b = 1; y <= j; y++, b++)
+				{
+					int node_2 = view_2.node[y];
+					int delete_cost = forest_dist[(a - 1) * cols + b] + 1;
+					int insert_cost = forest_dist[a * cols + b - 1] + 1;
+					int &subtree_dist = tree_dist[node_1 * columns + node_2];
+					if (view_1.leaf[x] == l_i && view_2.leaf[y] == l_j)
+					{
+						int substitute_cost = forest_dist[(a - 1) * cols + b - 1] + (f.label[node_1] == g.label[node_2] ? 0 : 1);
+						forest_dist[a * cols + b] = std::min({delete_cost, insert_cost, substitute_cost});
+						subtree_dist = forest_dist[a * cols + b];
+					}
+					else
+					{
+						int substitute_cost = forest_dist[(view_1.leaf[x] - l_i) * cols + (view_2.leaf[y] - l_j)] + subtree_dist;
+						forest_dist[a * cols + b] = std::min({delete_cost, insert_cost, substitute_cost});
+					}
+				}
+			}
+		}
+	};
+}
+int TreeEditDistance::apted(const std::shared_ptr<AbstractSyntaxTree::Node> &tree1, const std::shared_ptr<AbstractSyntaxTree::Node> &tree2)
+{
+	if (!tree1 || !tree2)
+	{
+		return static_cast<int>(post_order_traversal(tree1).size() + post_order_traversal(tree2).size());
 	}
+	// nodes are equal when their keys and values are, as in edit_weight
+	std::unordered_map<std::string, int> labels;
+	indexed_tree indexed1(tree1, labels);
+	indexed_tree indexed2(tree2, labels);
+	path_strategy_distance distance(indexed1, indexed2);
+	return distance.compute();
+}
+int TreeEditDistance::distance(const std::shared_ptr<AbstractSyntaxTree::Node> &tree1, const std::shared_ptr<AbstractSyntaxTree::Node> &tree2, algorithm a)
+{
+	return a == algorithm::APTED ? apted(tree1, tree2) : zhang_shasha(tree1, tree2);
 }
 bool TreeEditDistance::is_irrelevant_key(const std::string &key)
 {
@@ -15,6 +15,15 @@
 class TreeEditDistance
 {
 public:
+    /**
+     * The algorithms that compute the tree edit distance.
+     * ZHANG_SHASHA - the decomposition along left paths only, APTED - the decomposition along the cheapest of the left and right paths of every pair of subtrees.
+    */
+    enum class algorithm
+    {
+        ZHANG_SHASHA,
+        APTED
+    };
     /**
      * This recursive function does the actual post order left to right traversal of a tree.
      * @param node: the current parent node.
@@ -86,15 +95,41 @@ public:
      * @return the edit distance between the two trees.
     */
     int zhang_shasha(const std::shared_ptr<AbstractSyntaxTree::Node> &tree1, const std::shared_ptr<AbstractSyntaxTree::Node> &tree2);
+    /**
+     * This function calculates the edit distance between two trees with a path strategy, based on the paper: Pawlik, Mateusz & Augsten, Nikolaus. (2016). Tree edit distance: Robust and memory-efficient. Information Systems. 56. 157-173.
+     * For every pair of subtrees, the cheapest of the left and right paths of either subtree is chosen, so trees that are deep on their right side, like long select lists and nested expressions, do not cost more than trees that are deep on their left side.
+     * The costs are those of edit_weight: inserting or deleting a node costs 1 and changing a node costs 1 unless the key and the value are equal.
+     * @param tree1: the first tree.
+     * @param tree2: the second tree.
+     * @return the edit distance between the two trees.
+    */
+    int apted(const std::shared_ptr<AbstractSyntaxTree::Node> &tree1, const std::shared_ptr<AbstractSyntaxTree::Node> &tree2);
+    /**
+     * This function calculates the edit distance between two trees with the given algorithm.
+     * @param tree1: the first tree.
+     * @param tree2: the second tree.
+     * @param a: the algorithm to use.
+     * @return the edit distance between the two trees.
+    */
+    int distance(const std::shared_ptr<AbstractSyntaxTree::Node> &tree1, const std::shared_ptr<AbstractSyntaxTree::Node> &tree2, algorithm a);
     /**
      * This function calculates the edit distance between forests.
      * @param postorder1: the post-order left-right traversal of the first tree.
      * @param postorder2: the post-order left-right traversal of the second tree.
+     * @param leftmost1: the index of the leftmost leaf descendant of each node of the first tree, see leftmost_leaf_indexes.
+     * @param leftmost2: the index of the leftmost leaf descendant of each node of the second tree.
      * @param i: the index of the root node of the first tree.
      * @param j: the index of the root node of the second tree.
      * @param tree_dist: a 2D matrix containing the edit distances between the nodes of the two trees.
     */
-    void compute_forest_distance(const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>>& postorder1, const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>>& postorder2, const size_t i, const size_t j, std::vector<std::vector<int>>& tree_dist);
+    void compute_forest_distance(const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>>& postorder1, const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>>& postorder2,
+                                 const std::vector<size_t>& leftmost1, const std::vector<size_t>& leftmost2, const size_t i, const size_t j, std::vector<std::vector<int>>& tree_dist);
+    /**
+     * This function finds the index of the leftmost leaf descendant of every node of a post-order traversal.
+     * @param postorder: the post-order left-right traversal of the tree.
+     * @return the index in the traversal of the leftmost leaf descendant of the node at each index.
+    */
+    static std::vector<size_t> leftmost_leaf_indexes(const std::vector<std::shared_ptr<AbstractSyntaxTree::Node>>& postorder);
 private:
     /**
      * This function returns whether a node should be considered for editing in tree comparisons or not.
@@ -0,0 +1,122 @@
+#include "tree_metric_index.h"
+#include <algorithm>
+#include <climits>
+#include <mutex>
+
+TreeMetricIndex::TreeMetricIndex(TreeEditDistance::algorithm tree_algorithm) : tree_algorithm(tree_algorithm)
+{
+}
+
+void TreeMetricIndex::insert(std::size_t position, const std::shared_ptr<AbstractSyntaxTree::Node> &tree)
+{
+    std::unique_lock lock(mutex);
+    if (nodes.empty())
+    {
+        nodes.push_back({position, tree, {}});
+        return;
+    }
+
+    std::size_t current = 0;
+    while (true)
+    {
+        // equal trees are kept as well, they hang off each other at distance 0
+        int d = distance(tree, nodes[current].tree);
+        const auto &children = nodes[current].children;
+        auto it = std::find_if(children.begin(), children.end(), [d](const std::pair<int, std::size_t> &child)
+                               { return child.first == d; });
+        if (it == children.end())
+        {
+            std::size_t child = nodes.size();
+            nodes.push_back({position, tree, {}});
+            nodes[current].children.emplace_back(d, child);
+            return;
+        }
+        current = it->second;
+    }
+}
+
+std::vector<TreeMetricIndex::match> TreeMetricIndex::within(const std::shared_ptr<AbstractSyntaxTree::Node> &tree, int max_distance) const
+{
+    std::shared_lock lock(mutex);
+    std::vector<match> matches;
+    if (nodes.empty())
+    {
+        return matches;
+    }
+
+    std::vector<std::size_t> pending = {0};
+    while (!pending.empty())
+    {
+        const bk_node &node = nodes[pending.back()];
+        pending.pop_back();
+
+        int d = distance(tree, node.tree);
+        if (d <= max_distance)
+        {
+            matches.push_back({node.position, d});
+        }
+        // by the triangle inequality only children at distance [d - max, d + max] can match
+        for (const auto &[child_distance, child] : node.children)
+        {
+            if (child_distance >= d - max_distance && child_distance <= d + max_distance)
+            {
+                pending.push_back(child);
+            }
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const match &a, const match &b)
+              { return a.position < b.position; });
+    return matches;
+}
+
+bool TreeMetricIndex::nearest(const std::shared_ptr<AbstractSyntaxTree::Node> &tree, match &result) const
+{
+    std::shared_lock lock(mutex);
+    if (nodes.empty())
+    {
+        return false;
+    }
+
+    match best = {0, INT_MAX};
+    std::vector<std::size_t> pending = {0};
+    while (!pending.empty())
+    {
+        const bk_node &node = nodes[pending.back()];
+        pending.pop_back();
+
+        int d = distance(tree, node.tree);
+        if (d < best.distance || (d == best.distance && node.position < best.position))
+        {
+            best = {node.position, d};
+        }
+        // the search radius shrinks with the best distance found so far, ties are still visited
+        for (const auto &[child_distance, child] : node.children)
+        {
+            if (child_distance >= d - best.distance && child_distance <= d + best.distance)
+            {
+                pending.push_back(child);
+            }
+        }
+    }
+    result = best;
+    return true;
+}
+
+std::size_t TreeMetricIndex::size() const
+{
+    std::shared_lock lock(mutex);
+    return nodes.size();
+}
+
+std::size_t TreeMetricIndex::evaluations() const
+{
+    return distance_evaluations.load();
+}
+
+int TreeMetricIndex::distance(const std::shared_ptr<AbstractSyntaxTree::Node> &tree1, const std::shared_ptr<AbstractSyntaxTree::Node> &tree2) const
+{
+    TreeEditDistance ted;
+    distance_evaluations++;
+    return ted.distance(tree1, tree2, tree_algorithm);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file tree_metric_index.h
+ * @brief This file contains the declaration of the TreeMetricIndex class.
+ * The class is a BK-tree over parse trees with the tree edit distance as its metric. Semantics analysis uses it to find
+ * the correct queries that are within the minor error distance of a student query, or the nearest one, without
+ * computing the tree edit distance to every correct query. By the triangle inequality, a subtree whose edge distance
+ * is too far from the distance to its parent cannot hold a match and is skipped. This only holds for the exact tree edit
+ * distance, which both zhang_shasha and apted compute, with the unit costs of TreeEditDistance::edit_weight.
+ *
+ * @author Benard Wanjiru
+ * Contact: benard.wanjiru@ru.nl
+ */
+#ifndef TREE_METRIC_INDEX_H
+#define TREE_METRIC_INDEX_H
+
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+#include "abstract_syntax_tree.h"
+#include "tree_edit_distance.h"
+
+class TreeMetricIndex
+{
+public:
+    /**
+     * A tree of the index that is close to a searched tree.
+     */
+    struct match
+    {
+        std::size_t position; /**< The position the tree was inserted with. */
+        int distance;         /**< The tree edit distance between the tree and the searched tree. */
+    };
+    /**
+     * Constructor.
+     * @param tree_algorithm: the algorithm used to compute the tree edit distances, see Admin::get_tree_edit_distance_algorithm.
+     */
+    explicit TreeMetricIndex(TreeEditDistance::algorithm tree_algorithm = TreeEditDistance::algorithm::ZHANG_SHASHA);
+    /**
+     * This function adds a tree to the index. It can be called while other threads search the index.
+     * @param position: the position of the query in the caller's vector of queries.
+     * @param tree: the root of the parse tree of the query.
+     */
+    void insert(std::size_t position, const std::shared_ptr<AbstractSyntaxTree::Node> &tree);
+    /**
+     * This function finds all the trees within a maximum tree edit distance of a tree.
+     * @param tree: the root of the parse tree to search for.
+     * @param max_distance: the maximum tree edit distance of a match.
+     * @return: the matches in increasing order of position.
+     */
+    std::vector<match> within(const std::shared_ptr<AbstractSyntaxTree::Node> &tree, int max_distance) const;
+    /**
+     * This function finds the tree nearest to a tree. On equal distances the tree with the lowest position is returned.
+     * @param tree: the root of the parse tree to search for.
+     * @param result: the nearest tree, only set if the index is not empty.
+     * @return: true if a tree was found, false if the index is empty.
+     */
+    bool nearest(const std::shared_ptr<AbstractSyntaxTree::Node> &tree, match &result) const;
+    /**
+     * This function returns the number of trees in the index.
+     */
+    std::size_t size() const;
+    /**
+     * This function returns the number of tree edit distances computed by the index so far, including those of inserts.
+     */
+    std::size_t evaluations() const;
+
+private:
+    /**
+     * A node of the BK-tree. Each child is stored with its tree edit distance to this node's tree.
+     */
+    struct bk_node
+    {
+        std::size_t position;
+        std::shared_ptr<AbstractSyntaxTree::Node> tree;
+        std::vector<std::pair<int, std::size_t>> children;
+    };
+    TreeEditDistance::algorithm tree_algorithm;
+    mutable std::shared_mutex mutex;
+    std::vector<bk_node> nodes;
+    mutable std::atomic<std::size_t> distance_evaluations{0};
+    /**
+     * This function computes the tree edit distance between two trees and counts the evaluation.
+     */
+    int distance(const std::shared_ptr<AbstractSyntaxTree::Node> &tree1, const std::shared_ptr<AbstractSyntaxTree::Node> &tree2) const;
+};
+
+#endif // TREE_METRIC_INDEX_H
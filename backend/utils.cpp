@@ -6,12 +6,20 @@
 #include <boost/tokenizer.hpp>
 #include <regex>
 #include "sql_keywords.h"
+#include "keyword_index.h"
+#include "sql_lexer.h"
 #include <pg_query.h>
 #include <boost/algorithm/string.hpp>
 #include <unordered_set>
 #include <regex>
 #include <regex>
 #include <set>
+#include <cstdint>
+#include <unordered_map>
+#include <random>
+#include <iomanip>
+#include <stdexcept>
+#include <openssl/rand.h>
 
 // Function to compare two 2D vectors (SQL query results) and calculate their difference
 Utils::comparison_result Utils::compare_vectors(std::vector<std::vector<std::string>> query_results, std::vector<std::vector<std::string>> correct_results, bool check_order)
@@ -407,69 +415,297 @@ std::pair<int, edit_path> Utils::general_edit_distance_words(const std::vector<s
 	return {dp[m][n], path};
 }
 
-std::string::size_type Utils::general_edit_distance(const std::string &source, const std::string &target, std::string::size_type insert_cost, std::string::size_type delete_cost, std::string::size_type replace_cost)
+std::pair<int, std::vector<Utils::word_edit>> Utils::general_edit_distance_words(const std::vector<SqlLexer::word_id> &source, const std::vector<SqlLexer::word_id> &target,
+																				 int insert_cost, int delete_cost, int replace_cost)
 {
-	if (source.size() > target.size())
-		return general_edit_distance(target, source, insert_cost, delete_cost, replace_cost);
-
-	using t_size_type = std::string::size_type;
-	const t_size_type min_size = source.size(), max_size = target.size();
-	std::vector<t_size_type> lev_dist(min_size + 1);
+	const std::size_t m = source.size();
+	const std::size_t n = target.size();
+	const std::size_t width = n + 1;
 
-	lev_dist[0] = 0;
-	for (t_size_type i = 1; i <= min_size; ++i)
-		lev_dist[i] = lev_dist[i - 1] + delete_cost;
+	// the matrix is kept between calls so that comparing one query against many does not allocate every time
+	thread_local std::vector<int> dp;
+	dp.resize((m + 1) * width);
 
-	for (t_size_type j = 1; j <= max_size; ++j)
+	for (std::size_t j = 0; j <= n; ++j)
+		dp[j] = j * insert_cost;
+	for (std::size_t i = 1; i <= m; ++i)
 	{
-		t_size_type previous_diagonal = lev_dist[0], previous_diagonal_save;
-		lev_dist[0] += insert_cost;
-
-		for (t_size_type i = 1; i <= min_size; ++i)
+		int *row = &dp[i * width];
+		const int *above = row - width;
+		row[0] = i * delete_cost;
+		for (std::size_t j = 1; j <= n; ++j)
 		{
-			previous_diagonal_save = lev_dist[i];
 			if (source[i - 1] == target[j - 1])
-				lev_dist[i] = previous_diagonal;
+				row[j] = above[j - 1];
 			else
-				lev_dist[i] = std::min(std::min(lev_dist[i - 1] + delete_cost, lev_dist[i] + insert_cost), previous_diagonal + replace_cost);
-			previous_diagonal = previous_diagonal_save;
+				row[j] = std::min({above[j] + delete_cost, row[j - 1] + insert_cost, above[j - 1] + replace_cost});
 		}
 	}
-	// t_size_type alpha = alpha_measure(insert_cost, delete_cost);
-	// float normalized_ld = normalized_levenshtein_distance(source, target, alpha, lev_dist[min_size]);
-	return lev_dist[min_size];
+
+	// same backtracking order as the string version so both take the same edits
+	std::vector<word_edit> script;
+	std::size_t i = m, j = n;
+	while (i > 0 || j > 0)
+	{
+		int cell = dp[i * width + j];
+		if (i > 0 && cell == dp[(i - 1) * width + j] + delete_cost)
+		{
+			script.push_back({word_operation::DELETE, static_cast<std::uint32_t>(i - 1), 0});
+			--i;
+		}
+		else if (j > 0 && cell == dp[i * width + j - 1] + insert_cost)
+		{
+			script.push_back({word_operation::INSERT, 0, static_cast<std::uint32_t>(j - 1)});
+			--j;
+		}
+		else
+		{
+			if (source[i - 1] != target[j - 1])
+				script.push_back({word_operation::REPLACE, static_cast<std::uint32_t>(i - 1), static_cast<std::uint32_t>(j - 1)});
+			--i;
+			--j;
+		}
+	}
+	std::reverse(script.begin(), script.end());
+	return {dp[m * width + n], script};
 }
-// a general edit distance function that uses wide multibyte characters
-std::wstring::size_type Utils::general_edit_distance(const std::wstring &source, const std::wstring &target,
-													 std::wstring::size_type insert_cost, std::wstring::size_type delete_cost, std::wstring::size_type replace_cost)
+
+namespace
 {
-	if (source.size() > target.size())
-		return general_edit_distance(target, source, insert_cost, delete_cost, replace_cost);
+	/**
+	 * The match masks of a pattern for the bit-parallel edit distance. Bit r of block b of the mask of a character
+	 * is set when the character is at position 64 * b + r in the pattern.
+	 */
+	template <typename CharT>
+	class pattern_masks
+	{
+	public:
+		pattern_masks(const std::basic_string<CharT> &pattern, std::size_t blocks)
+			: blocks(blocks)
+		{
+			if constexpr (sizeof(CharT) == 1)
+			{
+				table.assign(256 * blocks, 0);
+			}
+			for (std::size_t i = 0; i < pattern.size(); ++i)
+			{
+				mask(pattern[i])[i / 64] |= std::uint64_t{1} << (i % 64);
+			}
+		}
+		/**
+		 * Returns the mask of block b of a character, 0 if the character is not in the pattern.
+		 */
+		std::uint64_t get(CharT c, std::size_t b) const
+		{
+			if constexpr (sizeof(CharT) == 1)
+			{
+				return table[static_cast<unsigned char>(c) * blocks + b];
+			}
+			else
+			{
+				auto it = masks.find(c);
+				return it == masks.end() ? 0 : it->second[b];
+			}
+		}
 
-	using t_size_type = std::wstring::size_type;
-	const t_size_type min_size = source.size(), max_size = target.size();
-	std::vector<t_size_type> lev_dist(min_size + 1);
+	private:
+		std::size_t blocks;
+		std::vector<std::uint64_t> table;
+		std::unordered_map<CharT, std::vector<std::uint64_t>> masks;
 
-	lev_dist[0] = 0;
-	for (t_size_type i = 1; i <= min_size; ++i)
-		lev_dist[i] = lev_dist[i - 1] + delete_cost;
+		std::uint64_t *mask(CharT c)
+		{
+			if constexpr (sizeof(CharT) == 1)
+			{
+				return &table[static_cast<unsigned char>(c) * blocks];
+			}
+			else
+			{
+				auto &m = masks[c];
+				m.resize(blocks, 0);
+				return m.data();
+			}
+		}
+	};
 
-	for (t_size_type j = 1; j <= max_size; ++j)
+	/**
+	 * Levenshtein distance with unit costs using the bit-parallel algorithm of Myers in the blocked form of Hyyrö.
+	 * Each column of the matrix is kept as bit vectors of vertical deltas (+1 and -1), 64 rows per machine word,
+	 * so a column costs O(m / 64) word operations instead of O(m) cell updates.
+	 * @param pattern: the shorter string, it must not be empty.
+	 * @param text: the longer string.
+	 * @return: the edit distance between the two strings.
+	 */
+	template <typename CharT>
+	std::size_t bit_parallel_edit_distance(const std::basic_string<CharT> &pattern, const std::basic_string<CharT> &text)
 	{
-		t_size_type previous_diagonal = lev_dist[0], previous_diagonal_save;
-		lev_dist[0] += insert_cost;
+		const std::size_t m = pattern.size();
+		const std::size_t blocks = (m + 63) / 64;
+		const pattern_masks<CharT> peq(pattern, blocks);
+		// the score is read at the last row of the pattern, which is not the top bit of the last block
+		const std::uint64_t last = std::uint64_t{1} << ((m - 1) % 64);
+		constexpr std::uint64_t high = std::uint64_t{1} << 63;
+
+		std::vector<std::uint64_t> pv(blocks, ~std::uint64_t{0});
+		std::vector<std::uint64_t> mv(blocks, 0);
+		std::size_t score = m;
+		for (CharT c : text)
+		{
+			// the first row increases by one in every column
+			int carry = 1;
+			for (std::size_t b = 0; b < blocks; ++b)
+			{
+				std::uint64_t eq = peq.get(c, b);
+				std::uint64_t xv = eq | mv[b];
+				if (carry < 0)
+					eq |= 1;
+				std::uint64_t xh = (((eq & pv[b]) + pv[b]) ^ pv[b]) | eq;
+				std::uint64_t ph = mv[b] | ~(xh | pv[b]);
+				std::uint64_t mh = pv[b] & xh;
+
+				std::uint64_t out = b + 1 == blocks ? last : high;
+				int next_carry = (ph & out) ? 1 : ((mh & out) ? -1 : 0);
+
+				ph <<= 1;
+				mh <<= 1;
+				if (carry < 0)
+					mh |= 1;
+				else if (carry > 0)
+					ph |= 1;
+				pv[b] = mh | ~(xv | ph);
+				mv[b] = ph & xv;
+				carry = next_carry;
+			}
+			score += carry;
+		}
+		return score;
+	}
 
-		for (t_size_type i = 1; i <= min_size; ++i)
+	/**
+	 * Edit distance with arbitrary costs, filled one anti-diagonal at a time. The cells of an anti-diagonal only
+	 * depend on the two previous anti-diagonals, so the inner loop has no dependency between iterations and the
+	 * compiler can vectorize it. The target is reversed so both strings are read in increasing order.
+	 * Same recurrence as the row by row version: a match takes the diagonal, anything else the cheapest edit.
+	 */
+	template <typename CharT, typename SizeT>
+	SizeT anti_diagonal_edit_distance(const std::basic_string<CharT> &source, const std::basic_string<CharT> &target,
+									  SizeT insert_cost, SizeT delete_cost, SizeT replace_cost)
+	{
+		const std::size_t m = source.size(), n = target.size();
+		const std::basic_string<CharT> reversed(target.rbegin(), target.rend());
+		// the anti-diagonals d - 2, d - 1 and d, indexed by the row i of the cell
+		std::vector<SizeT> before(m + 1), previous(m + 1), current(m + 1);
+		previous[0] = 0;
+		for (std::size_t d = 1; d <= m + n; ++d)
 		{
-			previous_diagonal_save = lev_dist[i];
-			if (source[i - 1] == target[j - 1])
-				lev_dist[i] = previous_diagonal;
-			else
-				lev_dist[i] = std::min(std::min(lev_dist[i - 1] + delete_cost, lev_dist[i] + insert_cost), previous_diagonal + replace_cost);
-			previous_diagonal = previous_diagonal_save;
+			if (d <= n)
+				current[0] = d * insert_cost;
+			if (d <= m)
+				current[d] = d * delete_cost;
+
+			const std::size_t first = d > n ? d - n : 1;
+			const std::size_t last = std::min(m, d - 1);
+			const SizeT *up = previous.data();
+			const SizeT *diagonal = before.data();
+			SizeT *cell = current.data();
+			const CharT *src = source.data();
+			// the target character of cell (i, d - i) is reversed[n - d + i]
+			const CharT *tgt = reversed.data() + (n - std::min(n, d));
+			const std::size_t shift = d > n ? d - n : 0;
+			for (std::size_t i = first; i <= last; ++i)
+			{
+				SizeT edit = std::min(std::min(up[i - 1] + delete_cost, up[i] + insert_cost), diagonal[i - 1] + replace_cost);
+				cell[i] = src[i - 1] == tgt[i - shift] ? diagonal[i - 1] : edit;
+			}
+			std::swap(before, previous);
+			std::swap(previous, current);
 		}
+		return previous[m];
 	}
-	return lev_dist[min_size];
+
+	/**
+	 * Edit distance with unit costs bounded by max_distance (Ukkonen). Only the cells within max_distance of the
+	 * main diagonal can hold a distance of at most max_distance, so only that band is filled, and the computation
+	 * stops as soon as a whole row of the band exceeds max_distance.
+	 * @return: the edit distance if it is at most max_distance, max_distance + 1 otherwise.
+	 */
+	template <typename CharT>
+	std::size_t banded_edit_distance(const std::basic_string<CharT> &source, const std::basic_string<CharT> &target, std::size_t max_distance)
+	{
+		if (source.size() > target.size())
+			return banded_edit_distance(target, source, max_distance);
+
+		const std::size_t m = source.size(), n = target.size(), k = max_distance;
+		const std::size_t outside = k + 1;
+		if (n - m > k)
+			return outside;
+
+		std::vector<std::size_t> row(n + 1, outside);
+		for (std::size_t j = 0; j <= std::min(n, k); ++j)
+			row[j] = j;
+
+		for (std::size_t i = 1; i <= m; ++i)
+		{
+			const std::size_t first = i > k ? i - k : 1;
+			const std::size_t last = std::min(n, i + k);
+			std::size_t diagonal = row[first - 1];
+			// the cell left of the band is either the first column or outside the band
+			std::size_t left = first == 1 && i <= k ? i : outside;
+			row[first - 1] = left;
+			std::size_t row_min = left;
+			for (std::size_t j = first; j <= last; ++j)
+			{
+				std::size_t up = row[j];
+				std::size_t cell = source[i - 1] == target[j - 1] ? diagonal : 1 + std::min({diagonal, up, left});
+				cell = std::min(cell, outside);
+				diagonal = up;
+				row[j] = cell;
+				left = cell;
+				row_min = std::min(row_min, cell);
+			}
+			if (row_min > k)
+				return outside;
+		}
+		return std::min(row[n], outside);
+	}
+
+	template <typename CharT, typename SizeT>
+	SizeT edit_distance(const std::basic_string<CharT> &source, const std::basic_string<CharT> &target,
+						SizeT insert_cost, SizeT delete_cost, SizeT replace_cost)
+	{
+		if (insert_cost == 1 && delete_cost == 1 && replace_cost == 1)
+		{
+			// unit costs are symmetric, so the shorter string is the pattern
+			const auto &pattern = source.size() <= target.size() ? source : target;
+			const auto &text = source.size() <= target.size() ? target : source;
+			if (pattern.empty())
+				return text.size();
+			return bit_parallel_edit_distance(pattern, text);
+		}
+		// the shorter string indexes the anti-diagonals
+		if (source.size() > target.size())
+			return anti_diagonal_edit_distance(target, source, insert_cost, delete_cost, replace_cost);
+		return anti_diagonal_edit_distance(source, target, insert_cost, delete_cost, replace_cost);
+	}
+}
+
+std::string::size_type Utils::general_edit_distance(const std::string &source, const std::string &target, std::string::size_type insert_cost, std::string::size_type delete_cost, std::string::size_type replace_cost)
+{
+	return edit_distance(source, target, insert_cost, delete_cost, replace_cost);
+}
+// a general edit distance function that uses wide multibyte characters
+std::wstring::size_type Utils::general_edit_distance(const std::wstring &source, const std::wstring &target,
+													 std::wstring::size_type insert_cost, std::wstring::size_type delete_cost, std::wstring::size_type replace_cost)
+{
+	return edit_distance(source, target, insert_cost, delete_cost, replace_cost);
+}
+std::string::size_type Utils::bounded_edit_distance(const std::string &source, const std::string &target, std::string::size_type max_distance)
+{
+	return banded_edit_distance(source, target, max_distance);
+}
+std::wstring::size_type Utils::bounded_edit_distance(const std::wstring &source, const std::wstring &target, std::wstring::size_type max_distance)
+{
+	return banded_edit_distance(source, target, max_distance);
 }
 std::string::size_type Utils::alpha_measure(std::string::size_type insert_cost, std::string::size_type delete_cost)
 {
@@ -665,6 +901,23 @@ bool Utils::both_are_spaces(char lhs, char rhs)
 	return (lhs == rhs) && (lhs == ' ');
 }
 
+std::string Utils::random_id()
+{
+	// the id is all that protects the grades of a job and the quiz it names, so it comes from the OpenSSL CSPRNG
+	unsigned char bytes[16];
+	if (RAND_bytes(bytes, sizeof(bytes)) != 1)
+	{
+		throw std::runtime_error("No random id could be generated");
+	}
+	std::ostringstream id;
+	id << std::hex << std::setfill('0');
+	for (unsigned char byte : bytes)
+	{
+		id << std::setw(2) << static_cast<int>(byte);
+	}
+	return id.str();
+}
+
 std::tuple<bool, std::string> Utils::fix_query_syntax_using_keywords(std::string query)
 {
 	std::string query_copy = query;
@@ -675,29 +928,27 @@ std::tuple<bool, std::string> Utils::fix_query_syntax_using_keywords(std::string
 	// the query passed cannot be parsed by pg_query
 	bool changed = false;
 
-	std::vector<std::string> tokens;
-	boost::split(tokens, query, boost::is_any_of(" \t\n;,"), boost::token_compress_on);
-	for (int c = 0; c < tokens.size(); c++)
+	const KeywordIndex &keywords = KeywordIndex::sql_2016();
+	const std::string original = query;
+	for (const auto &token : SqlLexer::tokenize(original))
 	{
-		auto token = tokens.at(c);
-		// transform token to uppercase
-		std::transform(token.begin(), token.end(), token.begin(), [](unsigned char c)
-					   { return std::toupper(c); });
-		if (sql_keywords_2016.find(token) == sql_keywords_2016.end())
+		// keywords, literals, quoted identifiers and punctuation are never misspelled keywords
+		if (token.type != SqlLexer::token_class::IDENTIFIER)
 		{
-			// let us iterate through the valid keywords and find the one that is closest to the token
-			int min_edit_distance = 2;
-			for (const auto &keyword : sql_keywords_2016)
+			continue;
+		}
+		std::string word(SqlLexer::text(original, token));
+		// find the closest keyword to the word among the keywords within the maximum edit distance
+		int min_edit_distance = 2;
+		for (const auto &candidate : keywords.find_within(word, min_edit_distance))
+		{
+			// normalized_levenshtein_distance with unit costs, from the distance we already have
+			float norm_edit_distance = (1.0f * 2 * candidate.distance) / (word.size() + candidate.keyword.size() + candidate.distance);
+			if (norm_edit_distance <= 0.27)
 			{
-				int edit_distance = general_edit_distance(token, keyword);
-				double norm_edit_distance = normalized_levenshtein_distance(token, keyword);
-				if (norm_edit_distance < 0.5)
-					// std::cout << "keyword " << keyword << " token " << token << "dist " << edit_distance << " norm " << norm_edit_distance << std::endl;
-					if (edit_distance <= min_edit_distance && norm_edit_distance <= 0.27)
-					{
-						query = std::regex_replace(query, std::regex(token, std::regex_constants::icase), keyword);
-						changed = true;
-					}
+				query = SqlLexer::replace_word(query, word, candidate.keyword);
+				changed = true;
+				break;
 			}
 		}
 	}
@@ -719,46 +970,32 @@ std::tuple<bool, std::string> Utils::fix_query_syntax_using_keywords(std::string
 
 std::tuple<bool, std::string, int> Utils::fix_query_syntax_using_another_query(const Admin admin, std::string query, std::string query_model, std::string query_untouched)
 {
-	int minimum_words = 20;
-	int minimum_chars = admin.get_syntax_minor_incorrect_ted();
+	// splits the sentences into words, keeping literals and quoted identifiers whole
+	return fix_query_syntax_using_another_query(admin, SqlLexer::intern_words(query), query_model, SqlLexer::intern_words(query_model));
+}
 
-	// splits the sentences into words using boost library
-	std::vector<std::string> sentence1, sentence2;
-	boost::split(sentence1, query, boost::is_any_of(" \t\n;,"));
-	// delete empty words from sentence1
-	sentence1.erase(std::remove_if(sentence1.begin(), sentence1.end(), [](const std::string &s)
-								   { return s.empty(); }),
-					sentence1.end());
-	boost::split(sentence2, query_model, boost::is_any_of(" \t\n;,"));
-	// delete empty words from sentence2
-	sentence2.erase(std::remove_if(sentence2.begin(), sentence2.end(), [](const std::string &s)
-								   { return s.empty(); }),
-					sentence2.end());
+std::tuple<bool, std::string, int> Utils::fix_query_syntax_using_another_query(const Admin &admin, const std::vector<SqlLexer::word_id> &query_words, const std::string &query_model, const std::vector<SqlLexer::word_id> &model_words)
+{
+	int minimum_chars = admin.get_syntax_minor_incorrect_ted();
 
 	// carry out words level edit distance
-	auto [distance, edit_path] = general_edit_distance_words(sentence1, sentence2);
+	auto [distance, edit_script] = general_edit_distance_words(query_words, model_words);
 
-	// copy the sentence1 and sentence2 to a new vector
-	std::string query_copy = query;
 	std::string model_copy = query_model;
 
 	// let's check individual operations to defferentiate betwween syntax and semantic errors
 	int total_char_operations = 0;
-	for (const auto &[operation, src_word, tgt_word] : edit_path)
+	for (const auto &edit : edit_script)
 	{
-		if (operation == "equal")
-		{
-			// do nothing
-		}
-		else if (operation == "delete")
+		if (edit.operation == word_operation::DELETE)
 		{
 			// for now we will assume all delete operations are syntactic.
 			// we just count the number of characters to be deleted.
-			total_char_operations += src_word.length();
-			// delete the characters in src_word from query_copy
+			total_char_operations += SqlLexer::word_text(query_words[edit.source_index]).length();
 		}
-		else if (operation == "insert")
+		else if (edit.operation == word_operation::INSERT)
 		{
+			const std::string &tgt_word = SqlLexer::word_text(model_words[edit.target_index]);
 			// check if the insert word is a keyword
 			if (check_if_word_is_keyword(tgt_word))
 			{
@@ -791,36 +1028,24 @@ std::tuple<bool, std::string, int> Utils::fix_query_syntax_using_another_query(c
 				}
 			}
 		}
-		else if (operation == "replace")
+		else
 		{
+			const std::string &src_word = SqlLexer::word_text(query_words[edit.source_index]);
+			const std::string &tgt_word = SqlLexer::word_text(model_words[edit.target_index]);
 			// check if the tgt_word is a keyword
 			if (check_if_word_is_keyword(tgt_word))
 			{
 				// this is syntax.
 				// check how many char edit operations are required to change the word
-				int edit_distance = general_edit_distance(src_word, tgt_word);
+				// only the characters up to the remaining budget matter, beyond it the query is rejected anyway
+				int budget = std::max(0, minimum_chars - total_char_operations);
+				int edit_distance = bounded_edit_distance(src_word, tgt_word, budget);
 				total_char_operations += edit_distance;
 			}
 			else
 			{
-				// Lambda expression to extract unquoted words into a set
-				auto extract_unquoted_words_set = [](const std::string &str)
-				{
-					std::set<std::string> wordSet;
-					std::regex word_regex(R"(\b(['"`´]?\w+['"`´]?)\b)");
-					auto words_begin = std::sregex_iterator(str.begin(), str.end(), word_regex);
-					auto words_end = std::sregex_iterator();
-
-					for (std::sregex_iterator i = words_begin; i != words_end; ++i)
-					{
-						std::smatch match = *i;
-						wordSet.insert(match.str());
-					}
-
-					return wordSet;
-				};
-				std::set<std::string> src_core = extract_unquoted_words_set(src_word);
-				std::set<std::string> tgt_core = extract_unquoted_words_set(tgt_word);
+				std::set<std::string> src_core = SqlLexer::word_set(src_word);
+				std::set<std::string> tgt_core = SqlLexer::word_set(tgt_word);
 
 				// check if the two words are the same after removing quotes
 				if (src_core == tgt_core)
@@ -841,6 +1066,11 @@ std::tuple<bool, std::string, int> Utils::fix_query_syntax_using_another_query(c
 				}
 			}
 		}
+		if (total_char_operations > minimum_chars)
+		{
+			// the query can no longer be fixed with this model, the rest of the script does not matter
+			break;
+		}
 	}
 
 	if (total_char_operations > minimum_chars)
@@ -858,17 +1088,5 @@ std::tuple<bool, std::string, int> Utils::fix_query_syntax_using_another_query(c
 }
 bool Utils::check_if_word_is_keyword(std::string word)
 {
-	// transform word to uppercase
-	std::transform(word.begin(), word.end(), word.begin(), ::toupper);
-
-	// let us iterate through the valid keywords and find the one that matches it completely
-	int min_edit_distance = 2;
-	for (const auto &keyword : sql_keywords_2016)
-	{
-		int edit_distance = general_edit_distance(word, keyword);
-		double norm_edit_distance = normalized_levenshtein_distance(word, keyword);
-		if (edit_distance == 0 && norm_edit_distance == 0)
-			return true;
-	}
-	return false;
+	return KeywordIndex::sql_2016().contains(word);
 }
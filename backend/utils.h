@@ -15,6 +15,8 @@
 #include <algorithm>
 #include <tuple>
 #include "admin.h"
+#include "sql_lexer.h"
+#include <cstdint>
 
 class Utils
 {
@@ -41,6 +43,25 @@ public:
          */
         int difference; /**< the number of differences between the two vectors */
     };
+    /**
+     * The operation of a word level edit.
+     */
+    enum class word_operation : std::uint8_t
+    {
+        DELETE,
+        INSERT,
+        REPLACE
+    };
+    /**
+     * An edit of a word level edit script. The indexes point into the source and target word sequences,
+     * source_index is unused for an insert and target_index for a delete.
+     */
+    struct word_edit
+    {
+        word_operation operation;
+        std::uint32_t source_index;
+        std::uint32_t target_index;
+    };
     /**
      * Overloaded operator function to compare two comparison_result objects
      * @param a: the first comparison_result object
@@ -115,8 +136,21 @@ public:
      */
     int get_number_of_vector_elements_differences(const std::vector<std::vector<std::string>> &vec_1, const std::vector<std::vector<std::string>> &vec_2);
     std::pair<int, std::vector<std::tuple<std::string, std::string, std::string>>> general_edit_distance_words(const std::vector<std::string> &source, const std::vector<std::string> &target, int insert_cost = 1, int delete_cost = 1, int replace_cost = 1);
+    /**
+     * This function gets the word level edit distance between two sequences of interned words.
+     * The words are compared as integers and the matrix is reused by later calls on the same thread.
+     * It takes the same edits as the string version.
+     * @param source: the words of the first query.
+     * @param target: the words of the second query.
+     * @param insert_cost: the cost of inserting a word.
+     * @param delete_cost: the cost of deleting a word.
+     * @param replace_cost: the cost of replacing a word.
+     * @return the edit distance and the edit script in word order. Equal words are left out of the script.
+     */
+    std::pair<int, std::vector<word_edit>> general_edit_distance_words(const std::vector<SqlLexer::word_id> &source, const std::vector<SqlLexer::word_id> &target, int insert_cost = 1, int delete_cost = 1, int replace_cost = 1);
     /**
      * This function gets the general edit distance between two strings.
+     * With unit costs it uses the bit-parallel algorithm of Myers and Hyyrö, with other costs an anti-diagonal dynamic program.
      * @param source: the first string.
      * @param target: the second string.
      * @param insert_cost: the cost of inserting a character.
@@ -129,6 +163,20 @@ public:
      * Multibyte version of the general edit distance function.
      */
     std::wstring::size_type general_edit_distance(const std::wstring &source, const std::wstring &target, std::wstring::size_type insert_cost = 1, std::wstring::size_type delete_cost = 1, std::wstring::size_type replace_cost = 1);
+    /**
+     * This function gets the edit distance between two strings with unit costs, up to a maximum.
+     * It only fills the band of the matrix within max_distance of the diagonal and stops as soon as a row exceeds max_distance.
+     * Use it when only distances up to a threshold matter, e.g. admin.get_syntax_minor_incorrect_ted().
+     * @param source: the first string.
+     * @param target: the second string.
+     * @param max_distance: the largest distance of interest.
+     * @return the edit distance if it is at most max_distance, max_distance + 1 otherwise.
+     */
+    std::string::size_type bounded_edit_distance(const std::string &source, const std::string &target, std::string::size_type max_distance);
+    /**
+     * Multibyte version of the bounded edit distance function.
+     */
+    std::wstring::size_type bounded_edit_distance(const std::wstring &source, const std::wstring &target, std::wstring::size_type max_distance);
     /**
      * THis is a helper function for normalized_levenshtein_distance.
      * @param insert_cost: the cost of inserting a character.
@@ -184,6 +232,13 @@ public:
      * @return true if the two characters are spaces, false otherwise.
      */
     static bool both_are_spaces(char lhs, char rhs);
+    /**
+     * This function returns a random id of 32 hexadecimal digits for the objects the server keeps, like jobs and quizzes.
+     * The ids are 128 random bits from a CSPRNG and cannot be guessed, so only whoever was given an id can look up its object.
+     * @return: the id.
+     * @throws std::runtime_error if the CSPRNG fails.
+     */
+    static std::string random_id();
     /**
      * This function is used to fix a query using SQL keywords.
      * @param query: the query to be fixed.
@@ -198,6 +253,15 @@ public:
      * The boolean is true if the query was fixed, false otherwise.
      */
     std::tuple<bool, std::string, int> fix_query_syntax_using_another_query(const Admin admin, std::string query, std::string query_model, std::string query_untouched);
+    /**
+     * This function is used to fix a query using another query whose words are already interned.
+     * @param admin: the grading parameters, the number of character edits allowed is admin.get_syntax_minor_incorrect_ted().
+     * @param query_words: the interned words of the query to be fixed, see ModelQuery::get_words.
+     * @param query_model: the preprocessed text of the other query.
+     * @param model_words: the interned words of the other query.
+     * @return a tuple of whether the query was fixed, the fixed query and the word edit distance between the queries.
+     */
+    std::tuple<bool, std::string, int> fix_query_syntax_using_another_query(const Admin &admin, const std::vector<SqlLexer::word_id> &query_words, const std::string &query_model, const std::vector<SqlLexer::word_id> &model_words);
 
     bool check_if_word_is_keyword(std::string word);
 };